@@ -7,11 +7,19 @@ endif()
 # Complete list of source (.c) files inside the Anybus CompactCom API.
 set(abcc_api_SRCS
    ${ABCC_API_DIR}/src/abcc_api_select_firmware.c
+   ${ABCC_API_DIR}/src/abcc_api_firmware_update.c
    ${ABCC_API_DIR}/src/abcc_api_handler.c
    ${ABCC_API_DIR}/src/abcc_api_command_handler.c
+   ${ABCC_API_DIR}/src/abcc_api_msg_scheduler.c
+   ${ABCC_API_DIR}/src/abcc_api_network_config.c
+   ${ABCC_API_DIR}/src/abcc_api_diag_history.c
+   ${ABCC_API_DIR}/src/abcc_api_posix_rt.c
+   ${ABCC_API_DIR}/src/abcc_api_sync_pipeline.c
    ${ABCC_API_DIR}/src/host_objects/application_data_object.c
    ${ABCC_API_DIR}/src/anybus_objects/anybus_file_system_interface_object.c
+   ${ABCC_API_DIR}/src/anybus_objects/anybus_file_system_interface_checksum.c
    ${ABCC_API_DIR}/src/anybus_objects/diagnostic_object.c
+   ${ABCC_API_DIR}/src/anybus_objects/diagnostic_event_manager.c
 )
 
 # Complete list of header (.h) files inside the Anybus CompactCom API. This is
@@ -20,11 +28,19 @@ set(abcc_api_INCS
    ${ABCC_API_DIR}/inc/abcc_api.h
    ${ABCC_API_DIR}/inc/abcc_api_network_settings.h
    ${ABCC_API_DIR}/inc/abcc_api_select_firmware.h
+   ${ABCC_API_DIR}/inc/abcc_api_firmware_update.h
+   ${ABCC_API_DIR}/inc/abcc_api_diag_history.h
+   ${ABCC_API_DIR}/inc/abcc_api_posix_rt.h
+   ${ABCC_API_DIR}/inc/abcc_api_sync_pipeline.h
    ${ABCC_API_DIR}/inc/host_objects/abcc_api_command_handler_lookup.h
    ${ABCC_API_DIR}/inc/anybus_objects/anybus_file_system_interface_object.h
+   ${ABCC_API_DIR}/inc/anybus_objects/anybus_file_system_interface_checksum.h
    ${ABCC_API_DIR}/inc/anybus_objects/diagnostic_object.h
+   ${ABCC_API_DIR}/inc/anybus_objects/diagnostic_event_manager.h
    ${ABCC_API_DIR}/src/abcc_api_config.h
    ${ABCC_API_DIR}/src/abcc_api_command_handler.h
+   ${ABCC_API_DIR}/src/abcc_api_msg_scheduler.h
+   ${ABCC_API_DIR}/src/abcc_api_network_config.h
    ${ABCC_API_DIR}/src/host_objects/application_data_object.h
 )
 
@@ -73,4 +89,41 @@ set(ABCC_API_INCLUDE_DIRS
 target_include_directories(abcc_api PRIVATE ${ABCC_API_INCLUDE_DIRS})
 
 # Link the Anybus CompactCom Driver library to the Anybus CompactCom API library.
-target_link_libraries(abcc_api PRIVATE abcc_driver)
\ No newline at end of file
+target_link_libraries(abcc_api PRIVATE abcc_driver)
+
+# Optional command handler lookup table generated from an object description,
+# see tools/abcc_api_command_table.py. ABCC_API_COMMAND_TABLE_DESC can be set in
+# a higher level CMake file to the path of the description file. The table is
+# generated again when the description or the lookup header changes.
+if(DEFINED ABCC_API_COMMAND_TABLE_DESC)
+   find_package(Python3 REQUIRED COMPONENTS Interpreter)
+
+   set(ABCC_API_GENERATED_DIR ${CMAKE_CURRENT_BINARY_DIR}/abcc_api_generated)
+   set(ABCC_API_COMMAND_TABLE ${ABCC_API_GENERATED_DIR}/abcc_api_command_table.h)
+
+   # The generator resolves the object, instance, command and attribute
+   # numbers from the same include directories as the compiler.
+   set(ABCC_API_COMMAND_TABLE_INCLUDE_ARGS)
+   foreach(ABCC_API_INCLUDE_DIR ${ABCC_API_INCLUDE_DIRS})
+      list(APPEND ABCC_API_COMMAND_TABLE_INCLUDE_ARGS --include-dir ${ABCC_API_INCLUDE_DIR})
+   endforeach()
+
+   add_custom_command(
+      OUTPUT ${ABCC_API_COMMAND_TABLE}
+      COMMAND ${Python3_EXECUTABLE} ${ABCC_API_DIR}/tools/abcc_api_command_table.py
+         ${ABCC_API_COMMAND_TABLE_DESC}
+         --lookup ${ABCC_API_DIR}/inc/host_objects/abcc_api_command_handler_lookup.h
+         ${ABCC_API_COMMAND_TABLE_INCLUDE_ARGS}
+         --output ${ABCC_API_COMMAND_TABLE}
+      DEPENDS
+         ${ABCC_API_COMMAND_TABLE_DESC}
+         ${ABCC_API_DIR}/tools/abcc_api_command_table.py
+         ${ABCC_API_DIR}/inc/host_objects/abcc_api_command_handler_lookup.h
+      COMMENT "Generating the ABCC API command handler lookup table"
+      VERBATIM
+   )
+
+   target_sources(abcc_api PRIVATE ${ABCC_API_COMMAND_TABLE})
+   target_include_directories(abcc_api PRIVATE ${ABCC_API_GENERATED_DIR})
+   target_compile_definitions(abcc_api PRIVATE ABCC_API_COMMAND_TABLE_GENERATED=1)
+endif()
\ No newline at end of file
@@ -8,6 +8,8 @@
 #  - Create INCLUDES, add your include paths to it
 #    (optional), and append the content as compiler flags
 #    when compiling.
+#  - Pass CFLAGS to the compiler as well, the defines
+#    needed by the Driver API are added to it.
 
 # store the path to the Anybus CompactCom Driver directory
 ABCC_DRIVER_DIR := $(ABCC_API_DIR)/abcc-driver
@@ -17,13 +19,39 @@ include $(ABCC_DRIVER_DIR)/abcc-driver.mk
 
 # add the Anybus CompactCom Driver API source files
 SRCS += $(ABCC_API_DIR)/src/abcc_api_select_firmware.c
+SRCS += $(ABCC_API_DIR)/src/abcc_api_firmware_update.c
 SRCS += $(ABCC_API_DIR)/src/abcc_api_handler.c
 SRCS += $(ABCC_API_DIR)/src/abcc_api_command_handler.c
+SRCS += $(ABCC_API_DIR)/src/abcc_api_msg_scheduler.c
+SRCS += $(ABCC_API_DIR)/src/abcc_api_network_config.c
+SRCS += $(ABCC_API_DIR)/src/abcc_api_diag_history.c
+SRCS += $(ABCC_API_DIR)/src/abcc_api_posix_rt.c
+SRCS += $(ABCC_API_DIR)/src/abcc_api_sync_pipeline.c
 SRCS += $(ABCC_API_DIR)/src/host_objects/application_data_object.c
 SRCS += $(ABCC_API_DIR)/src/anybus_objects/anybus_file_system_interface_object.c
+SRCS += $(ABCC_API_DIR)/src/anybus_objects/anybus_file_system_interface_checksum.c
 SRCS += $(ABCC_API_DIR)/src/anybus_objects/diagnostic_object.c
+SRCS += $(ABCC_API_DIR)/src/anybus_objects/diagnostic_event_manager.c
 
 # add the Anybus CompactCom Driver API include directories
 INCLUDES += -I$(ABCC_API_DIR)/inc
 INCLUDES += -I$(ABCC_API_DIR)/inc/host_objects
-INCLUDES += -I$(ABCC_API_DIR)/inc/anybus_objects
\ No newline at end of file
+INCLUDES += -I$(ABCC_API_DIR)/inc/anybus_objects
+
+# generate the command handler lookup table from an object description if
+# ABCC_API_COMMAND_TABLE_DESC contains the path to the description file, see
+# tools/abcc_api_command_table.py. The header is only rewritten when it
+# changes.
+ifdef ABCC_API_COMMAND_TABLE_DESC
+ABCC_API_GENERATED_DIR ?= ./abcc_api_generated
+ABCC_API_COMMAND_TABLE_RESULT := $(shell python3 $(ABCC_API_DIR)/tools/abcc_api_command_table.py \
+   $(ABCC_API_COMMAND_TABLE_DESC) \
+   --lookup $(ABCC_API_DIR)/inc/host_objects/abcc_api_command_handler_lookup.h \
+   $(patsubst -I%,--include-dir %,$(filter -I%,$(INCLUDES))) \
+   --output $(ABCC_API_GENERATED_DIR)/abcc_api_command_table.h 2>&1 || echo failed)
+ifneq ($(ABCC_API_COMMAND_TABLE_RESULT),)
+$(error $(ABCC_API_COMMAND_TABLE_RESULT))
+endif
+INCLUDES += -I$(ABCC_API_GENERATED_DIR)
+CFLAGS += -DABCC_API_COMMAND_TABLE_GENERATED=1
+endif
\ No newline at end of file
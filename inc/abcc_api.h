@@ -38,6 +38,71 @@ typedef UINT16 ABCC_API_NetworkType;
 */
 typedef ABCC_FwVersionType ABCC_API_FwVersionType;
 
+#if ABCC_CFG_INT_ENABLED
+/*------------------------------------------------------------------------------
+** Event counters for one ABCC event.
+**
+** lSignalled - Number of times the event was reported by ABCC_CbfEvent().
+** lHandled   - Number of times ABCC_API_Run() handled the event.
+**
+** The difference is the number of events that were coalesced, i.e. reported
+** again before the previous one had been handled.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   UINT32 lSignalled;
+   UINT32 lHandled;
+}
+ABCC_API_EventCounterType;
+
+/*------------------------------------------------------------------------------
+** Event counters, see ABCC_API_GetEventStats().
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   ABCC_API_EventCounterType sRdPd;
+   ABCC_API_EventCounterType sRdMsg;
+   ABCC_API_EventCounterType sWrMsg;
+   ABCC_API_EventCounterType sStatus;
+}
+ABCC_API_EventStatsType;
+#endif
+
+#ifdef ABCC_API_CONFIG_GET_TIME_US
+/*------------------------------------------------------------------------------
+** Cycle statistics, see ABCC_API_GetCycleStats().
+**
+** lCycles        - Number of ABCC_API_RunCycle() calls in the RUN state.
+** lOverruns      - Number of cycles that took longer than the cycle period.
+** lDeferred      - Number of cycles in which message work was deferred to
+**                  the next cycle because the budget was used up.
+** lLastElapsedUs - Duration of the last cycle.
+** lMaxElapsedUs  - Duration of the longest cycle.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   UINT32 lCycles;
+   UINT32 lOverruns;
+   UINT32 lDeferred;
+   UINT32 lLastElapsedUs;
+   UINT32 lMaxElapsedUs;
+}
+ABCC_API_CycleStatsType;
+#endif
+
+#if ABCC_API_DEFERRED_RESP_MAX
+/*------------------------------------------------------------------------------
+** Handle of a command with a deferred response, see ABCC_API_DeferResponse().
+**------------------------------------------------------------------------------
+*/
+typedef UINT16 ABCC_API_DeferredRespHandleType;
+
+#define ABCC_API_DEFERRED_RESP_INVALID ( (ABCC_API_DeferredRespHandleType)0xFFFF )
+#endif
+
 /*******************************************************************************
 ** Anybus CompactCom Driver API functions
 ********************************************************************************
@@ -71,6 +136,141 @@ EXTFUNC ABCC_ErrorCodeType ABCC_API_Init( void );
 */
 EXTFUNC ABCC_ErrorCodeType ABCC_API_Run( void );
 
+/*------------------------------------------------------------------------------
+** ABCC_API_RunMessaging() and ABCC_API_RunProcessData() together do the same
+** work as ABCC_API_Run(), split so that the process data exchange can run in
+** its own high priority thread with its own period. Use
+** either ABCC_API_Run(), or both of these, never a mix.
+**
+** ABCC_API_RunMessaging() runs the start up state machine, the driver, message
+** handling, command sequences, the diagnostic event manager and queued FSI
+** commands. All message callbacks, e.g. explicit ADI reads and writes, are
+** called from here.
+**
+** ABCC_API_RunProcessData() reads the process data if the ABCC has signalled
+** new read process data, calls ABCC_API_CbfCyclicalProcessing() and triggers
+** the write process data update. It does nothing until ABCC_API_RunMessaging()
+** has brought the ABCC to the RUN state. All process data callbacks are called
+** from here.
+**
+** The two functions must not run at the same time: ABCC_API_RunMessaging()
+** runs the driver and may restart the ABCC while ABCC_API_RunProcessData()
+** reads and writes the process data. Call them from one thread, or serialise
+** them with a lock as abcc_api_posix_rt.c does. The process data thread may
+** then be delayed by one call to ABCC_API_RunMessaging(), but is otherwise
+** scheduled on its own. On a multi-core host ABCC_PORT_EnterCritical() must
+** also lock across CPUs, since the ABCC interrupt may run on another CPU than
+** the threads. The read process data event must be enabled in
+** ABCC_CFG_INT_ENABLE_MASK and not handled in the ISR, otherwise the read
+** process data is updated from wherever the driver detects it. ADIs that are both mapped as process data and accessed with explicit
+** messages are accessed from both threads, protecting them is up to the
+** application.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+**
+** Returns:
+**    ABCC_API_RunMessaging(): ABCC driver error code, as ABCC_API_Run()
+**------------------------------------------------------------------------------
+*/
+EXTFUNC ABCC_ErrorCodeType ABCC_API_RunMessaging( void );
+EXTFUNC void ABCC_API_RunProcessData( void );
+
+#ifdef ABCC_API_CONFIG_GET_TIME_US
+/*------------------------------------------------------------------------------
+** Run one control cycle. Use instead of ABCC_API_Run(), called once per cycle
+** period, e.g. from a periodic task.
+**
+** The process data is exchanged first (see ABCC_API_RunProcessData()). The
+** rest of the cycle period, minus ABCC_API_CYCLE_MARGIN_US, is the budget for
+** message work. Once the budget is used up, received messages (when
+** ABCC_CFG_INT_ENABLED is set), pending command sequences, diagnostic events
+** and queued FSI commands are left for the next cycle. Status updates and
+** ABCC_RunDriver() are never deferred. A cycle that takes longer than the
+** period is counted as an overrun and reported to
+** ABCC_API_CONFIG_CYCLE_OVERRUN_NOTIFY(), if defined.
+**
+** Before the ABCC has reached the RUN state this is the same as
+** ABCC_API_Run().
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+**
+** Returns:
+**    ABCC driver error code
+**------------------------------------------------------------------------------
+*/
+EXTFUNC ABCC_ErrorCodeType ABCC_API_RunCycle( void );
+
+/*------------------------------------------------------------------------------
+** Set the cycle period used by ABCC_API_RunCycle().
+**------------------------------------------------------------------------------
+** Arguments:
+**    lPeriodUs - Cycle period in microseconds. 0 (the default) uses the cycle
+**                time of the SYNC object if SYNC_OBJ_ENABLE is set, and no
+**                budget at all otherwise.
+**
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_SetCyclePeriod( UINT32 lPeriodUs );
+
+/*------------------------------------------------------------------------------
+** Get the statistics of ABCC_API_RunCycle().
+**------------------------------------------------------------------------------
+** Arguments:
+**    psStats - Destination of the statistics.
+**    fReset  - TRUE to restart the statistics from zero.
+**
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_GetCycleStats( ABCC_API_CycleStatsType* psStats, BOOL fReset );
+#endif
+
+/*------------------------------------------------------------------------------
+** Same as ABCC_API_Run(), but first sleeps until the ABCC signals an event,
+** ABCC_API_SignalEvent() is called, or lTimeoutMs has passed. Intended for a
+** main loop that should not use any CPU time while the ABCC is idle.
+**
+** Waiting requires ABCC_CFG_INT_ENABLED and ABCC_API_CONFIG_EVENT_WAIT() /
+** ABCC_API_CONFIG_EVENT_SIGNAL() in abcc_driver_config.h, otherwise this
+** function does not wait at all. It also does not wait during startup, where
+** the ABCC handler has to poll the module.
+**
+** The wait is skipped, or shortened, when work queued inside the API is due,
+** e.g. network settings set with ABCC_API_SetAddress(), command sequences and
+** FSI commands that can be sent, diagnostic events whose hold-off time or
+** rate limit ends, and deferred responses. Other work that is not triggered
+** by an ABCC event, e.g. updating the write process data, is done at the
+** latest after lTimeoutMs. Choose the timeout accordingly, or call
+** ABCC_API_SignalEvent() when such work is added.
+**------------------------------------------------------------------------------
+** Arguments:
+**    lTimeoutMs - Max. time to wait for an event.
+**
+** Returns:
+**    ABCC driver error code
+**------------------------------------------------------------------------------
+*/
+EXTFUNC ABCC_ErrorCodeType ABCC_API_RunUntilEvent( UINT32 lTimeoutMs );
+
+/*------------------------------------------------------------------------------
+** Wake up a pending ABCC_API_RunUntilEvent(), e.g. after new write process
+** data or a diagnostic event has been provided from another thread. Does
+** nothing unless ABCC_API_CONFIG_EVENT_SIGNAL() is defined.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+**
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_SignalEvent( void );
+
 /*------------------------------------------------------------------------------
 ** This function is responsible for handling all timers for the ABCC driver. It
 ** is recommended to call this function on a regular basis from a timer
@@ -112,6 +312,57 @@ EXTFUNC void ABCC_API_Shutdown( void );
 */
 EXTFUNC void ABCC_API_Restart( void );
 
+/*------------------------------------------------------------------------------
+** Same as ABCC_API_Restart() but skips init work whose result is still valid,
+** to get the ABCC back to PROCESS_ACTIVE faster, e.g. after a watchdog
+** timeout:
+** - The ADI maps are kept, unless the number of ADIs has changed or the
+**   process data has been remapped.
+** - IP address, netmask, gateway, DHCP and Comm settings are not set again if
+**   the ABCC has already accepted the same value. The ABCC keeps these in
+**   non-volatile memory. Node address and baud rate are always set.
+**
+** The ABCC is still reset and the driver restarted. Use ABCC_API_Restart() if
+** the network configuration may have been changed by other means, e.g. from
+** the network, or if the ABCC may have been replaced.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+**
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_WarmRestart( void );
+
+/*------------------------------------------------------------------------------
+** Get the time the ABCC needed from the driver start to reach PROCESS_ACTIVE
+** the last time, as counted by ABCC_API_RunTimerSystem().
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+**
+** Returns:
+**    Startup time in ms, 0 if PROCESS_ACTIVE has not been reached yet.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC UINT32 ABCC_API_GetLastStartupTimeMs( void );
+
+/*------------------------------------------------------------------------------
+** Same as ABCC_API_Restart() but the handler expects the ABCC to install a new
+** firmware during startup, and waits up to ABCC_API_FW_UPGRADE_STARTUP_TIME_MS
+** for it to become ready. Use this after a firmware candidate has been put in
+** place, e.g. with ABCC_API_SelectFirmware().
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+**
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_RestartForFirmwareUpdate( void );
+
 #if ABCC_CFG_SPI_DYNAMIC_MSG_FRAG_LEN
 /*------------------------------------------------------------------------------
 ** This function is used for SPI mode, only. It sets the new message fragment
@@ -229,6 +480,76 @@ EXTFUNC void ABCC_API_SetAppStatus( ABP_AppStatusType eAppStatus );
 **------------------------------------------------------------------------------
 */
 #define ABCC_API_ISR ABCC_ISR
+
+/*------------------------------------------------------------------------------
+** Get the event counters, e.g. to see how many interrupts are coalesced into
+** one handling pass when tuning ABCC_CFG_INT_ENABLE_MASK.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psStats - Destination of the counters.
+**    fReset  - TRUE to restart counting from zero.
+**
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_GetEventStats( ABCC_API_EventStatsType* psStats, BOOL fReset );
+#endif
+
+#if ABCC_API_DEFERRED_RESP_MAX
+/*------------------------------------------------------------------------------
+** Defers the response to the command being handled. May only be called from a
+** callback of the command handler lookup table. The command keeps its message
+** buffer and is answered once ABCC_API_DeferredRespReady() or
+** ABCC_API_DeferredRespError() has been called, or with ABP_ERR_GENERAL_ERROR
+** after ABCC_API_DEFERRED_RESP_TIMEOUT_MS.
+**
+** The return value of the callback is ignored when the response is deferred.
+** When the command is ready the callback is called again with the same
+** arguments and is then expected to complete, although it may defer the
+** response again within the same timeout.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+**
+** Returns:
+**    Handle of the command, ABCC_API_DEFERRED_RESP_INVALID if the response
+**    cannot be deferred (not called from a callback, or
+**    ABCC_API_DEFERRED_RESP_MAX commands are already deferred). The callback
+**    must then complete right away.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC ABCC_API_DeferredRespHandleType ABCC_API_DeferResponse( void );
+
+/*------------------------------------------------------------------------------
+** The data of a deferred command is available. The callback is called again
+** and the response is sent from ABCC_API_Run().
+**------------------------------------------------------------------------------
+** Arguments:
+**    hResp - Handle from ABCC_API_DeferResponse().
+**
+** Returns:
+**    FALSE if the handle is no longer valid, e.g. since the command timed out
+**    or has already been completed.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL ABCC_API_DeferredRespReady( ABCC_API_DeferredRespHandleType hResp );
+
+/*------------------------------------------------------------------------------
+** A deferred command failed. It is answered with an error response from
+** ABCC_API_Run(), without calling the callback again.
+**------------------------------------------------------------------------------
+** Arguments:
+**    hResp      - Handle from ABCC_API_DeferResponse().
+**    eErrorCode - Error code of the response.
+**
+** Returns:
+**    FALSE if the handle is no longer valid, e.g. since the command timed out
+**    or has already been completed.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL ABCC_API_DeferredRespError( ABCC_API_DeferredRespHandleType hResp,
+                                         ABP_MsgErrorCodeType eErrorCode );
 #endif
 
 /*******************************************************************************
@@ -311,6 +632,10 @@ EXTFUNC UINT16 ABCC_API_CbfGetNumAdi( void );
 ** The function is executed in interrupt context. If the separate sync pin in
 ** the ABCC interface is used this function shall be called from the interrupt
 ** handler. If the ABCC interrupt is used the driver will call this function.
+**
+** With ABCC_API_SYNC_PIPELINE_ENABLE the outputs are already sent when this
+** function is called, see abcc_api_sync_pipeline.h. It must then not call
+** ABCC_TriggerWrPdUpdate().
 **------------------------------------------------------------------------------
 ** Arguments:
 **    None
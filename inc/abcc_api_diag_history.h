@@ -0,0 +1,214 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** History of diagnostic events and CompactCom exceptions, kept on the host for
+** post-mortem analysis.
+**
+** The ABCC handler records:
+** - Every Diagnostic object instance created or deleted by the diagnostic
+**   event manager (see diagnostic_event_manager.h).
+** - The exception code and exception info read when the CompactCom enters the
+**   EXCEPTION state.
+** - Every (re)initialisation of the CompactCom.
+**
+** The entries are kept in a ring of ABCC_API_DIAG_HISTORY_SIZE entries, the
+** oldest entry is overwritten when the ring is full. Entries are only written
+** from the context that runs ABCC_API_Run() and never need a lock. The history
+** can be read from another context with ABCC_API_DiagHistoryExport(), entries
+** overwritten while being copied are left out of the result.
+**
+** The history is not cleared when the CompactCom is restarted, only by
+** ABCC_API_DiagHistoryClear().
+**
+** Export format, all multi-octet values little endian:
+**
+**    Header, ABCC_API_DIAG_HISTORY_HEADER_SIZE octets:
+**       UINT8[2]  'D', 'H'
+**       UINT8     Format version, ABCC_API_DIAG_HISTORY_FORMAT_VERSION
+**       UINT8     Entry size, ABCC_API_DIAG_HISTORY_ENTRY_SIZE
+**       UINT16    Number of entries following the header
+**       UINT32    Sequence number of the first entry. Entries are numbered
+**                 from 0 since the last clear, a gap to the previous export
+**                 tells how many entries were lost.
+**
+**    Entries, oldest first, ABCC_API_DIAG_HISTORY_ENTRY_SIZE octets each:
+**       UINT32    Timestamp in ms
+**       UINT8     Entry type, ABCC_API_DiagHistoryEntryType
+**       UINT8     Value 1, see ABCC_API_DiagHistoryEntryType
+**       UINT8     Value 2, see ABCC_API_DiagHistoryEntryType
+**       UINT8     Reserved, 0
+**       UINT16    Diagnostic object instance, 0 if not applicable
+********************************************************************************
+*/
+
+#ifndef ABCC_API_DIAG_HISTORY_H
+#define ABCC_API_DIAG_HISTORY_H
+
+#include "../src/abcc_api_config.h"
+#include "abcc_types.h"
+#include "abcc_error_codes.h"
+
+#if ABCC_API_DIAG_HISTORY_ENABLE
+
+/*******************************************************************************
+** Public defines
+********************************************************************************
+*/
+
+#define ABCC_API_DIAG_HISTORY_FORMAT_VERSION     ( 1 )
+#define ABCC_API_DIAG_HISTORY_HEADER_SIZE        ( 10 )
+#define ABCC_API_DIAG_HISTORY_ENTRY_SIZE         ( 10 )
+
+/*------------------------------------------------------------------------------
+** Size of an export holding the complete history.
+**------------------------------------------------------------------------------
+*/
+#define ABCC_API_DIAG_HISTORY_EXPORT_MAX_SIZE                                   \
+   ( ABCC_API_DIAG_HISTORY_HEADER_SIZE +                                       \
+     ( ABCC_API_DIAG_HISTORY_SIZE * ABCC_API_DIAG_HISTORY_ENTRY_SIZE ) )
+
+/*******************************************************************************
+** Public typedefs
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Entry types and the meaning of their values.
+**
+** ABCC_API_DIAG_HIST_MODULE_INIT    - The CompactCom was (re)initialised.
+** ABCC_API_DIAG_HIST_DI_CREATED     - Value 1 is the severity, value 2 the
+**                                     event code, plus the instance number.
+** ABCC_API_DIAG_HIST_DI_DELETED     - As ABCC_API_DIAG_HIST_DI_CREATED.
+** ABCC_API_DIAG_HIST_EXCEPTION      - Value 1 is the exception code (Anybus
+**                                     object attribute 7).
+** ABCC_API_DIAG_HIST_EXCEPTION_INFO - Value 1 is the exception info (Network
+**                                     object attribute 7).
+**------------------------------------------------------------------------------
+*/
+typedef enum ABCC_API_DiagHistoryEntryType
+{
+   ABCC_API_DIAG_HIST_MODULE_INIT = 1,
+   ABCC_API_DIAG_HIST_DI_CREATED = 2,
+   ABCC_API_DIAG_HIST_DI_DELETED = 3,
+   ABCC_API_DIAG_HIST_EXCEPTION = 4,
+   ABCC_API_DIAG_HIST_EXCEPTION_INFO = 5
+}
+ABCC_API_DiagHistoryEntryType;
+
+#if ANB_FSI_OBJ_ENABLE
+/*------------------------------------------------------------------------------
+** Function pointer definition which is used to report the result of
+** ABCC_API_DiagHistorySave().
+**------------------------------------------------------------------------------
+** Arguments:
+**    eResult - ABCC error code indicating success or failure.
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+typedef void (*ABCC_API_pnDiagHistorySaveCallback)( ABCC_ErrorCodeType eResult );
+#endif
+
+/*******************************************************************************
+** Public services
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Add an entry to the history. Called by the ABCC handler and the diagnostic
+** event manager, but may also be used by the application from the context
+** that runs ABCC_API_Run().
+**------------------------------------------------------------------------------
+** Arguments:
+**    eType     - Entry type.
+**    bValue1   - Type specific value.
+**    bValue2   - Type specific value.
+**    iInstance - Diagnostic object instance, 0 if not applicable.
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_DiagHistoryRecord( ABCC_API_DiagHistoryEntryType eType,
+                                         UINT8 bValue1,
+                                         UINT8 bValue2,
+                                         UINT16 iInstance );
+
+/*------------------------------------------------------------------------------
+** Copy the history to a buffer in the export format described above. If the
+** buffer can not hold all entries the newest ones that fit are exported.
+**------------------------------------------------------------------------------
+** Arguments:
+**    pbDest   - Destination buffer.
+**    iMaxSize - Size of pbDest in octets. Use
+**               ABCC_API_DIAG_HISTORY_EXPORT_MAX_SIZE to always get all
+**               entries.
+** Returns:
+**    Number of octets written, 0 if pbDest can not even hold the header.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC UINT16 ABCC_API_DiagHistoryExport( UINT8* pbDest, UINT16 iMaxSize );
+
+/*------------------------------------------------------------------------------
+** Remove all entries and restart the sequence numbering.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_DiagHistoryClear( void );
+
+#if ANB_FSI_OBJ_ENABLE
+/*------------------------------------------------------------------------------
+** Write an export of the history to a file in the CompactCom file system. The
+** history is copied when the function is called and the file is written in
+** the background from ABCC_API_Run(). An existing file is overwritten.
+**------------------------------------------------------------------------------
+** Arguments:
+**    pacFileName      - Path of the file, e.g. "diag_history.bin". Copied
+**                       internally.
+**    pnResultCallback - Callback function to be called with the result of the
+**                       operation, may be NULL.
+** Returns:
+**    ABCC_EC_NO_ERROR if the save was started.
+**    ABCC_EC_PARAMETER_NOT_VALID for invalid arguments.
+**    ABCC_EC_INCORRECT_STATE if a save is already in progress.
+**    Any error from ANB_FSI_Create().
+**------------------------------------------------------------------------------
+*/
+EXTFUNC ABCC_ErrorCodeType ABCC_API_DiagHistorySave( const char* pacFileName,
+                                                     ABCC_API_pnDiagHistorySaveCallback pnResultCallback );
+#endif
+
+/*------------------------------------------------------------------------------
+** Called by the ABCC API handler when the CompactCom is (re)initialised.
+** Records an ABCC_API_DIAG_HIST_MODULE_INIT entry and fails an ongoing save,
+** since the FSI instance is gone.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_DiagHistoryModuleReset( void );
+
+/*------------------------------------------------------------------------------
+** Advance the history timestamp. Called by the ABCC API handler from
+** ABCC_API_RunTimerSystem(). Not used if ABCC_API_DIAG_HISTORY_TIMESTAMP() is
+** defined.
+**------------------------------------------------------------------------------
+** Arguments:
+**    iDeltaTimeMs - Milliseconds since the last call.
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_DiagHistoryRunTimer( const INT16 iDeltaTimeMs );
+
+#endif /* ABCC_API_DIAG_HISTORY_ENABLE */
+
+#endif /* inclusion lock */
@@ -0,0 +1,173 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Interface for transferring a firmware image (.hiff) from the host to the
+** firmware candidate area of the CompactCom using the File System Interface
+** object. The CompactCom installs the image after the next reset.
+**
+** The image is written with several FileWrite commands in flight at a time
+** (see ABCC_API_FW_UPDATE_PIPELINE_DEPTH). When the transfer is done the file
+** is verified before it is left in the candidate area: its size is compared
+** and, if ANB_FSI_CHECKSUM_ENABLE is set, the file is read back and compared
+** to a CRC32C calculated while writing. A file that fails to transfer or
+** verify is deleted so that a corrupt image is never installed.
+********************************************************************************
+*/
+
+#ifndef ABCC_API_FW_UPDATE_H
+#define ABCC_API_FW_UPDATE_H
+
+#include "../src/abcc_api_config.h"
+#include "abcc_error_codes.h"
+
+#if ANB_FSI_OBJ_ENABLE
+
+/*******************************************************************************
+** Public defines
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Enable/disable debugging of the firmware update feature.
+**------------------------------------------------------------------------------
+*/
+#ifndef ABCC_API_FW_UPDATE_DEBUG_ENABLED
+#define ABCC_API_FW_UPDATE_DEBUG_ENABLED 0
+#endif
+
+/*******************************************************************************
+** Public typedefs
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Function pointer definition used to fetch image data from the host, e.g.
+** from a file on the host file system.
+**------------------------------------------------------------------------------
+** Arguments:
+**    lOffset  - Offset in the image of the requested data.
+**    pbDest   - Destination buffer.
+**    iMaxSize - Number of octets requested. The last request may ask for
+**               fewer octets than the buffer can hold.
+** Returns:
+**    Number of octets stored in pbDest. Anything less than iMaxSize aborts
+**    the transfer.
+**------------------------------------------------------------------------------
+*/
+typedef UINT16 (*ABCC_API_pnFwUpdateReadCallback)( UINT32 lOffset, UINT8* pbDest, UINT16 iMaxSize );
+
+/*------------------------------------------------------------------------------
+** Function pointer definition which is used to report the result of a
+** firmware transfer.
+**------------------------------------------------------------------------------
+** Arguments:
+**    eResult - ABCC error code indicating success or failure.
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+typedef void (*ABCC_API_pnFwUpdateResultCallback)( ABCC_ErrorCodeType eResult );
+
+/*******************************************************************************
+** Public services
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Transfer a firmware image located in host memory to the firmware candidate
+** area of the CompactCom.
+**------------------------------------------------------------------------------
+** Arguments:
+**    pacFileName      - Name of the image file without path, e.g.
+**                       "ABCC_40_PIR_1_23_01.hiff". Copied internally.
+**    pbImage          - Image data. Must stay valid until the result
+**                       callback has been invoked.
+**    lSize            - Size of the image in octets.
+**    fRestart         - TRUE to restart the CompactCom via
+**                       ABCC_API_RestartForFirmwareUpdate() when the image has
+**                       been transferred and verified.
+**    pnResultCallback - Callback function to be called with the result of the
+**                       operation.
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_FirmwareUpdateFromBuffer(
+   const char* pacFileName,
+   const UINT8* pbImage,
+   UINT32 lSize,
+   BOOL fRestart,
+   ABCC_API_pnFwUpdateResultCallback pnResultCallback );
+
+/*------------------------------------------------------------------------------
+** Transfer a firmware image provided chunk by chunk by the host to the
+** firmware candidate area of the CompactCom.
+**------------------------------------------------------------------------------
+** Arguments:
+**    pacFileName      - Name of the image file without path. Copied
+**                       internally.
+**    lSize            - Size of the image in octets.
+**    pnReadCallback   - Callback function used to fetch image data. Offsets
+**                       never decrease, but a chunk that could not be
+**                       queued is requested again with the same offset.
+**    fRestart         - TRUE to restart the CompactCom via
+**                       ABCC_API_RestartForFirmwareUpdate() when the image has
+**                       been transferred and verified.
+**    pnResultCallback - Callback function to be called with the result of the
+**                       operation.
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_FirmwareUpdateFromCallback(
+   const char* pacFileName,
+   UINT32 lSize,
+   ABCC_API_pnFwUpdateReadCallback pnReadCallback,
+   BOOL fRestart,
+   ABCC_API_pnFwUpdateResultCallback pnResultCallback );
+
+/*------------------------------------------------------------------------------
+** Number of image octets confirmed as written by the CompactCom in the
+** ongoing transfer. Can be used for progress indication.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    Octets written, 0 if no transfer is active.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC UINT32 ABCC_API_FirmwareUpdateProgress( void );
+
+/*------------------------------------------------------------------------------
+** Called by the ABCC API handler when the CompactCom is (re)initialised. The
+** FSI instance and all outstanding commands are lost, so an ongoing transfer
+** fails and no restart is done. If the file may have been written, it is
+** deleted by ABCC_API_FirmwareUpdateResume() before the failure is reported
+** through the result callback. No new transfer can be started until then.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_FirmwareUpdateModuleReset( void );
+
+/*------------------------------------------------------------------------------
+** Called by the ABCC API handler when user initialisation has completed.
+** Deletes the file of a transfer that was interrupted by a reset of the
+** CompactCom, then reports the transfer as failed.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_FirmwareUpdateResume( void );
+
+#endif
+
+#endif /* inclusion lock */
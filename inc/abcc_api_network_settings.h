@@ -39,6 +39,51 @@ typedef enum ABCC_API_CommSetting
 }
 ABCC_API_CommSettingType;
 
+/*------------------------------------------------------------------------------
+** IPv4 settings, see ABCC_API_SetIpSettings(). Addresses are in network byte
+** order, e.g. { 192, 168, 0, 10 }.
+**
+** abAddress  - IP address.
+** abNetmask  - Subnet mask.
+** abGateway  - Default gateway.
+** fDhcp      - TRUE to get the settings from a DHCP server instead.
+** fSetDns    - TRUE to set abDns1 and abDns2, FALSE to leave them unchanged.
+** abDns1     - Primary DNS server.
+** abDns2     - Secondary DNS server.
+** pcHostName - Host name, NUL terminated. NULL to leave it unchanged.
+**------------------------------------------------------------------------------
+*/
+typedef struct ABCC_API_IpSettings
+{
+   UINT8       abAddress[ 4 ];
+   UINT8       abNetmask[ 4 ];
+   UINT8       abGateway[ 4 ];
+   BOOL        fDhcp;
+   BOOL        fSetDns;
+   UINT8       abDns1[ 4 ];
+   UINT8       abDns2[ 4 ];
+   const char* pcHostName;
+}
+ABCC_API_IpSettingsType;
+
+/*------------------------------------------------------------------------------
+** Status of the IPv4 settings, see ABCC_API_GetIpSettingsStatus().
+**
+** ABCC_API_IP_SETTINGS_PENDING  - Not all settings have been written and read
+**                                 back yet.
+** ABCC_API_IP_SETTINGS_VERIFIED - The CompactCom holds all settings.
+** ABCC_API_IP_SETTINGS_FAILED   - The CompactCom refused a setting, or read
+**                                 back another value than the one written.
+**------------------------------------------------------------------------------
+*/
+typedef enum ABCC_API_IpSettingsStatus
+{
+   ABCC_API_IP_SETTINGS_PENDING,
+   ABCC_API_IP_SETTINGS_VERIFIED,
+   ABCC_API_IP_SETTINGS_FAILED
+}
+ABCC_API_IpSettingsStatusType;
+
 /*------------------------------------------------------------------------------
 ** Set HW switch 1 value to the application. The value is used to generate the
 ** the node address or the IP address (192.168.0.X) depending on network.
@@ -47,13 +92,18 @@ ABCC_API_CommSettingType;
 **
 ** NOTE: For networks that uses an IP address and if this function is called
 **       with address 0 no address will be set to the ABCC.
+**
+** The value is written to the ABCC from the next ABCC_API_Run(), or when an
+** update in progress is done. If the function is called again before that
+** only the last value is written, so it can be called for every change of a
+** rotary switch.
 **------------------------------------------------------------------------------
 ** Arguments:
 **    iSwitchValue - Switch 1 value
 **
 ** Returns:
-**    True:  bSwitchValue will be the new address
-**    False: Update of address already in progress
+**    True:  bSwitchValue will be the new address. False is not returned, it is
+**           kept for compatibility.
 **------------------------------------------------------------------------------
 */
 EXTFUNC BOOL ABCC_API_SetAddress( UINT16 iSwitchValue );
@@ -61,20 +111,21 @@ EXTFUNC BOOL ABCC_API_SetAddress( UINT16 iSwitchValue );
 /*------------------------------------------------------------------------------
 ** Set HW switch 2 value to the application. The value is used to generate the
 ** baud rate for networks that implements network configuration object instance
-** 2.
+** 2. Written the same way as the address, see ABCC_API_SetAddress().
 **------------------------------------------------------------------------------
 ** Arguments:
 **    bSwitchValue - Switch 2 value
 **
 ** Returns:
-**    True:  bSwitchValue will be the new baudrate
-**    False: Update of baudrate already in progress
+**    True:  bSwitchValue will be the new baudrate. False is not returned, it
+**           is kept for compatibility.
 **------------------------------------------------------------------------------
 */
 EXTFUNC BOOL ABCC_API_SetBaudrate( UINT8 bSwitchValue );
 
 /*------------------------------------------------------------------------------
-** Set Comm settings (speed/duplex) for ports.
+** Set Comm settings (speed/duplex) for ports. Written the same way as the
+** address, see ABCC_API_SetAddress().
 **------------------------------------------------------------------------------
 ** Arguments:
 **
@@ -88,4 +139,40 @@ EXTFUNC BOOL ABCC_API_SetBaudrate( UINT8 bSwitchValue );
 EXTFUNC void ABCC_API_SetCommSettings( ABCC_API_CommSettingType eCommSettings1,
                                        ABCC_API_CommSettingType eCommSettings2 );
 
+/*------------------------------------------------------------------------------
+** Set the complete IPv4 configuration, in place of the 192.168.0.X address
+** derived from the switch value. May be called at any time, during the setup
+** of the CompactCom as well as while it is running. All changed settings are
+** written together by the next update, settings the CompactCom already holds
+** are not written again, see ABCC_API_SetAddress().
+**
+** NOTE: A later call to ABCC_API_SetAddress() replaces the last octet of the
+**       IP address.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psSettings - IPv4 settings, copied by the function.
+**
+** Returns:
+**    True:  The settings will be written.
+**    False: psSettings is NULL or the host name is longer than
+**           ABCC_API_NC_HOST_NAME_MAX_LEN, nothing is written.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL ABCC_API_SetIpSettings( const ABCC_API_IpSettingsType* psSettings );
+
+/*------------------------------------------------------------------------------
+** Get the status of the IPv4 settings given by ABCC_API_SetIpSettings().
+** Settings the network does not support are not taken into account.
+** Written settings are only read back when ABCC_API_NC_READ_BACK_ENABLE is
+** set, otherwise a setting is verified when the CompactCom accepts it.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+**
+** Returns:
+**    See ABCC_API_IpSettingsStatusType.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC ABCC_API_IpSettingsStatusType ABCC_API_GetIpSettingsStatus( void );
+
 #endif  /* inclusion lock */
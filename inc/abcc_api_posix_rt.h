@@ -0,0 +1,108 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Optional threading mode for POSIX hosts, e.g. Linux with PREEMPT_RT.
+**
+** Two threads are started:
+**
+**    Process data thread - Calls ABCC_API_RunProcessData() with a fixed
+**                          period. Runs with SCHED_FIFO and can be pinned to
+**                          a CPU.
+**    Messaging thread    - Calls ABCC_API_RunMessaging() and
+**                          ABCC_API_RunTimerSystem() with a fixed period.
+**                          Runs with a lower priority, or SCHED_OTHER.
+**
+** See ABCC_API_RunMessaging() in abcc_api.h for which work and callbacks end
+** up in which thread. The application must not call ABCC_API_Run() while the
+** threads are running.
+**
+** The two threads never run the driver at the same time: a mutex with
+** priority inheritance is held around ABCC_API_RunProcessData() and around
+** ABCC_API_RunMessaging() and the timer system. A messaging round therefore
+** delays the process data thread by at most its own duration, so message
+** callbacks should be kept short. The ABCC interrupt may still run on any
+** CPU, so with the threads pinned to different CPUs ABCC_PORT_EnterCritical()
+** must be a lock that works across CPUs, e.g. a spinlock, and not only mask
+** interrupts on the calling CPU.
+**
+** Requires ABCC_API_POSIX_RT_ENABLE, a POSIX threads implementation with the
+** GNU affinity extensions, and linking with the threads library.
+********************************************************************************
+*/
+
+#ifndef ABCC_API_POSIX_RT_H
+#define ABCC_API_POSIX_RT_H
+
+#include "../src/abcc_api_config.h"
+#include "abcc_types.h"
+#include "abcc_error_codes.h"
+
+#if ABCC_API_POSIX_RT_ENABLE
+
+/*******************************************************************************
+** Public typedefs
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Thread configuration.
+**
+** lPdPeriodUs   - Period of the process data thread in microseconds.
+** iPdPriority   - SCHED_FIFO priority of the process data thread.
+** iPdCpu        - CPU to pin the process data thread to, -1 for no pinning.
+** lMsgPeriodUs  - Period of the messaging thread in microseconds.
+** iMsgPriority  - SCHED_FIFO priority of the messaging thread, must be lower
+**                 than iPdPriority. 0 to use SCHED_OTHER.
+** iMsgCpu       - CPU to pin the messaging thread to, -1 for no pinning.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   UINT32   lPdPeriodUs;
+   INT16    iPdPriority;
+   INT16    iPdCpu;
+   UINT32   lMsgPeriodUs;
+   INT16    iMsgPriority;
+   INT16    iMsgCpu;
+}
+ABCC_API_PosixRtConfigType;
+
+/*******************************************************************************
+** Public services
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Start the process data and messaging threads. ABCC_API_Init() must have
+** been called before.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psConfig - Thread configuration. Copied internally.
+** Returns:
+**    ABCC_EC_NO_ERROR if both threads were started.
+**    ABCC_EC_PARAMETER_NOT_VALID for invalid arguments.
+**    ABCC_EC_INCORRECT_STATE if the threads are already running.
+**    ABCC_EC_NO_RESOURCES if a thread could not be created, e.g. because the
+**    process is not allowed to use SCHED_FIFO.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC ABCC_ErrorCodeType ABCC_API_PosixRtStart( const ABCC_API_PosixRtConfigType* psConfig );
+
+/*------------------------------------------------------------------------------
+** Stop the threads and wait for them to exit.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    ABCC_EC_INTERNAL_ERROR if the threads stopped on their own since a
+**    period sleep failed, otherwise the last error code returned by
+**    ABCC_API_RunMessaging().
+**------------------------------------------------------------------------------
+*/
+EXTFUNC ABCC_ErrorCodeType ABCC_API_PosixRtStop( void );
+
+#endif /* ABCC_API_POSIX_RT_ENABLE */
+
+#endif /* inclusion lock */
@@ -6,6 +6,11 @@
 ** Interface for selecting a firmware from the internal file system of the
 ** CompactCom B40 Mini (Loaded) and copying it to the firware candidate area in
 ** preparation for installation after next reset of the CompactCom B40 Mini.
+**
+** The content of the firmware repository is cached after the first directory
+** scan, so subsequent selections only need to copy the file. A selection that
+** is interrupted by a reset of the CompactCom is resumed automatically once
+** communication has been re-established.
 ********************************************************************************
 */
 
@@ -61,6 +66,41 @@ ABCC_API_CommonEtnFirmwareType;
 */
 typedef void (*ABCC_API_pnSelectFwResultCallback)( ABCC_ErrorCodeType eResult );
 
+/*------------------------------------------------------------------------------
+** Phases of a firmware selection, reported via the progress callback.
+**
+** ABCC_API_SELECT_FW_PHASE_SCANNING    - Reading the firmware repository.
+**                                        Skipped if the listing is cached.
+** ABCC_API_SELECT_FW_PHASE_COPYING     - Copying the firmware file to the
+**                                        candidate area.
+** ABCC_API_SELECT_FW_PHASE_CLEANING_UP - Copy done, releasing FSI resources.
+** ABCC_API_SELECT_FW_PHASE_RESUMING    - Restarting a selection that was
+**                                        interrupted by a module reset.
+**------------------------------------------------------------------------------
+*/
+typedef enum ABCC_API_SelectFwPhase
+{
+    ABCC_API_SELECT_FW_PHASE_SCANNING = 0,
+    ABCC_API_SELECT_FW_PHASE_COPYING,
+    ABCC_API_SELECT_FW_PHASE_CLEANING_UP,
+    ABCC_API_SELECT_FW_PHASE_RESUMING
+}
+ABCC_API_SelectFwPhaseType;
+
+/*------------------------------------------------------------------------------
+** Function pointer definition which is used to report the progress of the
+** select firmware function.
+**------------------------------------------------------------------------------
+** Arguments:
+**    eFirmware - Firmware being selected.
+**    ePhase    - Phase that has just been entered.
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+typedef void (*ABCC_API_pnSelectFwProgressCallback)( ABCC_API_CommonEtnFirmwareType eFirmware,
+                                                     ABCC_API_SelectFwPhaseType ePhase );
+
 /*******************************************************************************
 ** Public globals
 ********************************************************************************
@@ -95,6 +135,57 @@ EXTFUNC void ABCC_API_SelectFirmware(
    ABCC_API_CommonEtnFirmwareType eFirmware,
    ABCC_API_pnSelectFwResultCallback pnResultCallback );
 
+/*------------------------------------------------------------------------------
+** Register a callback that is invoked each time a firmware selection enters a
+** new phase. Can be used to give feedback while switching firmware.
+**------------------------------------------------------------------------------
+** Arguments:
+**    pnProgressCallback - Progress callback, NULL to disable.
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_SelectFirmwareSetProgressCallback(
+   ABCC_API_pnSelectFwProgressCallback pnProgressCallback );
+
+/*------------------------------------------------------------------------------
+** Discard the cached listing of the firmware repository. The next selection
+** will scan the "/Network FW/" folder again. Call this if the content of the
+** folder has been changed by other means than this API.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_SelectFirmwareInvalidateCache( void );
+
+/*------------------------------------------------------------------------------
+** Called by the ABCC API handler when the CompactCom is (re)initialised. An
+** ongoing selection is marked for resumption, or reported as completed if the
+** copy had already been confirmed.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_SelectFirmwareModuleReset( void );
+
+/*------------------------------------------------------------------------------
+** Called by the ABCC API handler when user initialisation has completed.
+** Restarts a selection that was interrupted by a reset of the CompactCom.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_SelectFirmwareResume( void );
+
 #endif
 
 #endif /* inclusion lock */
@@ -0,0 +1,173 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Process data pipeline for isochronous operation with the SYNC object.
+**
+** When the SYNC object is in a synchronous mode (sync mode != 0) the ABCC
+** handler no longer sends the write process data from ABCC_API_Run(). With
+** the pipeline enabled the work is instead split like this:
+**
+**    Application cycle - Deserialises the inputs captured at the last sync
+**                        event, calls ABCC_API_CbfCyclicalProcessing() and
+**                        serialises the outputs into a staging image.
+**    Sync ISR          - Sends the newest complete staging image and captures
+**                        the newest complete read process data as the inputs
+**                        of the next application cycle.
+**
+** The sync ISR never walks the ADI map, it only switches buffers and copies
+** the already serialised image to the driver, so the time from the sync event
+** to the outputs being sent is short and constant. Inputs that arrive after
+** the sync event are held back until the next one, so the application always
+** works on inputs sampled at the same point of the network cycle.
+**
+** Each direction uses three images of ABCC_CFG_MAX_PROCESS_DATA_SIZE octets,
+** so the producer and the consumer never wait for each other. If no new
+** outputs were staged since the last sync event the previous ones are sent
+** again and counted as stale.
+**
+** The pipeline is driven by the ABCC handler, the application does not call
+** any of the functions below except ABCC_API_SyncPipelineGetStats(). The
+** application's ABCC_API_CbfSyncIsr() is still called, after the pipeline
+** work, but must not call ABCC_TriggerWrPdUpdate().
+**
+** Requires ABCC_API_SYNC_PIPELINE_ENABLE and SYNC_OBJ_ENABLE. The
+** sync-to-output latency is only measured if ABCC_API_CONFIG_GET_TIME_US() is
+** defined.
+********************************************************************************
+*/
+
+#ifndef ABCC_API_SYNC_PIPELINE_H
+#define ABCC_API_SYNC_PIPELINE_H
+
+#include "../src/abcc_api_config.h"
+#include "abcc_types.h"
+#include "abcc_error_codes.h"
+
+#if ABCC_API_SYNC_PIPELINE_ENABLE
+
+/*******************************************************************************
+** Public typedefs
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Pipeline statistics, see ABCC_API_SyncPipelineGetStats().
+**
+** lSyncEvents          - Sync events handled by the pipeline.
+** lStaleOutputs        - Sync events where no new outputs had been staged, the
+**                        previous outputs were sent again.
+** lMissedInputs        - Sync events where no new complete read process data
+**                        had arrived since the previous one.
+** lLastOutputLatencyUs - Time from the sync event to the outputs being handed
+**                        to the driver, for the last sync event.
+** lMaxOutputLatencyUs  - The longest such time.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   UINT32 lSyncEvents;
+   UINT32 lStaleOutputs;
+   UINT32 lMissedInputs;
+   UINT32 lLastOutputLatencyUs;
+   UINT32 lMaxOutputLatencyUs;
+}
+ABCC_API_SyncPipelineStatsType;
+
+/*******************************************************************************
+** Public services
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Get the pipeline statistics.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psStats - Destination of the statistics.
+**    fReset  - TRUE to restart the statistics from zero.
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_SyncPipelineGetStats( ABCC_API_SyncPipelineStatsType* psStats, BOOL fReset );
+
+/*------------------------------------------------------------------------------
+** Drop all staged and captured images. Called by the ABCC API handler when
+** the CompactCom is (re)initialised and when the process data is remapped.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_SyncPipelineReset( void );
+
+/*------------------------------------------------------------------------------
+** Serialise the ADI values into the next output staging image. Called by the
+** ABCC API handler in place of ABCC_TriggerWrPdUpdate() in sync mode.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_SyncPipelineStageOutputs( void );
+
+/*------------------------------------------------------------------------------
+** Deserialise the inputs captured at the last sync event, if they have not
+** been already. Called by the ABCC API handler before
+** ABCC_API_CbfCyclicalProcessing().
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_SyncPipelineTakeInputs( void );
+
+/*------------------------------------------------------------------------------
+** Store new read process data until the next sync event. Called by the ABCC
+** API handler from ABCC_CbfNewReadPd().
+**------------------------------------------------------------------------------
+** Arguments:
+**    pxReadPd - Read process data from the driver.
+** Returns:
+**    TRUE if the data was stored, FALSE if not in sync mode and the data
+**    shall be deserialised right away.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL ABCC_API_SyncPipelineStoreInputs( const void* pxReadPd );
+
+/*------------------------------------------------------------------------------
+** Copy the staged outputs to the driver. Called by the ABCC API handler from
+** ABCC_CbfUpdateWriteProcessData().
+**------------------------------------------------------------------------------
+** Arguments:
+**    pxWritePd - Write process data buffer of the driver.
+** Returns:
+**    TRUE if the staged outputs were copied, FALSE if the update was not
+**    triggered by the pipeline and the ADI values shall be serialised as
+**    usual.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL ABCC_API_SyncPipelineCopyOutputs( void* pxWritePd );
+
+/*------------------------------------------------------------------------------
+** Send the staged outputs and capture the inputs. Called by the ABCC API
+** handler from ABCC_CbfSyncIsr(), in interrupt context.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ABCC_API_SyncPipelineSyncEvent( void );
+
+#endif /* ABCC_API_SYNC_PIPELINE_ENABLE */
+
+#endif /* inclusion lock */
@@ -0,0 +1,209 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Incremental checksums for data transferred through the Anybus File System
+** Interface object.
+**
+** A checksum context can be attached to an FSI instance with
+** ANB_FSI_AttachChecksum(). While attached, every successful FileRead or
+** FileWrite on that instance feeds the transferred octets (the *actual* size
+** reported by the CompactCom) into the context. This gives a digest of a file
+** while it is being streamed, without a second pass over the data.
+**
+** ANB_FSI_FileVerify() can then be used to read a file back from the
+** CompactCom and compare its digest against an expected value, e.g. before a
+** freshly uploaded firmware file is activated.
+**
+** Supported algorithms:
+**    CRC32C  - Castagnoli CRC. Uses the SSE4.2 or ARMv8 CRC32 instructions if
+**              the compiler advertises them, otherwise a 1 kB lookup table.
+**    SHA-256 - Portable implementation.
+********************************************************************************
+*/
+
+#ifndef ANB_FSI_CHECKSUM_H
+#define ANB_FSI_CHECKSUM_H
+
+#include "../../src/abcc_api_config.h"
+
+#if ANB_FSI_OBJ_ENABLE && ANB_FSI_CHECKSUM_ENABLE
+
+#include "abcc.h"
+
+/*******************************************************************************
+** Public constants
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Digest sizes in octets.
+**------------------------------------------------------------------------------
+*/
+#define ANB_FSI_CRC32C_DIGEST_SIZE              ( 4 )
+#define ANB_FSI_SHA256_DIGEST_SIZE              ( 32 )
+#define ANB_FSI_CHECKSUM_MAX_DIGEST_SIZE        ANB_FSI_SHA256_DIGEST_SIZE
+
+/*******************************************************************************
+** Public typedefs
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Checksum algorithms.
+**------------------------------------------------------------------------------
+*/
+typedef enum
+{
+   ANB_FSI_CHECKSUM_CRC32C,
+   ANB_FSI_CHECKSUM_SHA256
+}
+ANB_FSI_ChecksumAlgType;
+
+/*------------------------------------------------------------------------------
+** Running checksum context. Treat as opaque, use the ANB_FSI_Checksum*()
+** functions to operate on it.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   ANB_FSI_ChecksumAlgType eAlg;
+
+   union
+   {
+      UINT32   lCrc32c;
+
+      struct
+      {
+         UINT32   alState[ 8 ];
+         UINT32   lLengthLow;    /* Total length in octets, low 32 bits. */
+         UINT32   lLengthHigh;   /* Total length in octets, high 32 bits. */
+         UINT8    abBlock[ 64 ];
+         UINT8    bBlockLen;
+      }
+      sSha256;
+   }
+   uState;
+}
+ANB_FSI_ChecksumType;
+
+/*------------------------------------------------------------------------------
+** Completion callback for ANB_FSI_FileVerify().
+**------------------------------------------------------------------------------
+** Arguments:
+**    eMsgResult - Result of the last FSI command issued by the verification.
+**    bFsiError  - Object-specific error code (ABP_FSI_ERR_...) if 'eMsgResult'
+**                 was ABP_ERR_OBJ_SPECIFIC.
+**    fMatch     - TRUE if the file was read back completely and the digest
+**                 matched the expected digest.
+** Returns:
+**    -
+**------------------------------------------------------------------------------
+*/
+typedef void (*ANB_FSI_VerifyCbfType)( ABP_MsgErrorCodeType eMsgResult, UINT8 bFsiError, BOOL fMatch );
+
+/*******************************************************************************
+** Public services
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Start a new checksum calculation.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psChecksum - Checksum context to initialise.
+**    eAlg       - Algorithm to use.
+** Returns:
+**    -
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ANB_FSI_ChecksumInit( ANB_FSI_ChecksumType* psChecksum, ANB_FSI_ChecksumAlgType eAlg );
+
+/*------------------------------------------------------------------------------
+** Feed data into a running checksum.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psChecksum - Checksum context.
+**    pbData     - Data to add.
+**    lSize      - Size of data in octets.
+** Returns:
+**    -
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ANB_FSI_ChecksumUpdate( ANB_FSI_ChecksumType* psChecksum, const UINT8* pbData, UINT32 lSize );
+
+/*------------------------------------------------------------------------------
+** Finish a checksum calculation. The context has to be initialised again
+** before it can be reused.
+**
+** The CRC32C digest is stored as a little endian UINT32, the SHA-256 digest
+** in its normal big endian octet order.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psChecksum - Checksum context.
+**    pbDigest   - Destination, at least ANB_FSI_CHECKSUM_MAX_DIGEST_SIZE
+**                 octets.
+** Returns:
+**    Size of the digest in octets.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC UINT8 ANB_FSI_ChecksumFinal( ANB_FSI_ChecksumType* psChecksum, UINT8* pbDigest );
+
+/*------------------------------------------------------------------------------
+** Attach a checksum context to an FSI instance. Data from all subsequent
+** successful ANB_FSI_FileRead()/ANB_FSI_FileWrite() calls on the instance is
+** fed into the context, in the order the responses arrive.
+**
+** The context must stay valid until ANB_FSI_DetachChecksum() is called.
+**------------------------------------------------------------------------------
+** Arguments:
+**    iInstance  - FSI instance number.
+**    psChecksum - Initialised checksum context.
+** Returns:
+**    ABCC_EC_NO_ERROR on success.
+**    ABCC_EC_PARAMETER_NOT_VALID or ABCC_EC_NO_RESOURCES on failure.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC ABCC_ErrorCodeType ANB_FSI_AttachChecksum( UINT16 iInstance, ANB_FSI_ChecksumType* psChecksum );
+
+/*------------------------------------------------------------------------------
+** Detach the checksum context from an FSI instance.
+**------------------------------------------------------------------------------
+** Arguments:
+**    iInstance  - FSI instance number.
+** Returns:
+**    -
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ANB_FSI_DetachChecksum( UINT16 iInstance );
+
+/*------------------------------------------------------------------------------
+** Read a file back from the CompactCom and compare its digest to an expected
+** value (verify-after-write). The file is opened, read to EOF and closed
+** on the given FSI instance, which must not have any other file open.
+**
+** Only one verification can be active at a time.
+**------------------------------------------------------------------------------
+** Arguments:
+**    iInstance        - FSI instance number to use.
+**    pacName          - Path + name of the file, relative to the current path.
+**                       Must stay valid until the callback is invoked.
+**    eAlg             - Algorithm used to produce 'pbExpectedDigest'.
+**    pbExpectedDigest - Expected digest, see ANB_FSI_ChecksumFinal().
+**    pnCallback       - Completion callback.
+** Returns:
+**    ABCC_EC_NO_ERROR on success.
+**    ABCC_EC_PARAMETER_NOT_VALID, ABCC_EC_NO_RESOURCES or
+**    ABCC_EC_OUT_OF_MSG_BUFFERS on failure.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC ABCC_ErrorCodeType ANB_FSI_FileVerify( UINT16 iInstance,
+                                               char* pacName,
+                                               ANB_FSI_ChecksumAlgType eAlg,
+                                               const UINT8* pbExpectedDigest,
+                                               ANB_FSI_VerifyCbfType pnCallback );
+
+#endif /* ANB_FSI_OBJ_ENABLE && ANB_FSI_CHECKSUM_ENABLE */
+
+#endif  /* inclusion lock */
@@ -14,6 +14,11 @@
 ** concurrent operations (outstanding commands waiting for a response). The
 ** internal resources tied to an operation can be re-used once the completion
 ** callback is invoked.
+**
+** Commands that cannot be sent right away, because all operations are in use
+** or the driver is out of message buffers, are put in a queue of
+** ANB_FSI_CMD_QUEUE_SIZE entries and sent in order from ANB_FSI_Run(). A call
+** only fails because of resource shortage when that queue is full.
 ********************************************************************************
 */
 
@@ -84,6 +89,31 @@ typedef void (*ANB_FSI_CompletionCbfType)( UINT16 iInstance, ABP_MsgErrorCodeTyp
 */
 EXTFUNC void ANB_FSI_Init( void );
 
+/*------------------------------------------------------------------------------
+** Send queued FSI commands as transactions and message buffers become
+** available. Called from ABCC_API_Run() while the CompactCom is running.
+**------------------------------------------------------------------------------
+** Arguments:
+**    -
+** Returns:
+**    -
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void ANB_FSI_Run( void );
+
+/*------------------------------------------------------------------------------
+** Tell if ANB_FSI_Run() could send a queued command right now. Queued commands
+** that wait for a response from the CompactCom, or for held back bulk traffic
+** to be let through, do not count.
+**------------------------------------------------------------------------------
+** Arguments:
+**    -
+** Returns:
+**    TRUE if there is a command ANB_FSI_Run() could send.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL ANB_FSI_IsRunPending( void );
+
 /*------------------------------------------------------------------------------
 ** Create an FSI instance. Must be performed before any other file/directory
 ** operations are possible. The instance returned in the callback is used in
@@ -224,7 +254,8 @@ EXTFUNC ABCC_ErrorCodeType ANB_FSI_FileRead( UINT16 iInstance, UINT8* pbDest, UI
 **------------------------------------------------------------------------------
 ** Arguments:
 **    iInstance  - FSI instance number to use.
-**    pbSrc      - Pointer to local source buffer.
+**    pbSrc      - Pointer to local source buffer. The data is copied during
+**                 the call.
 **    iReqSize   - Requested size to write.
 **    piActSize  - Pointer to UINT16, actual size written will be stored here on
 **                 completion.
@@ -232,7 +263,8 @@ EXTFUNC ABCC_ErrorCodeType ANB_FSI_FileRead( UINT16 iInstance, UINT8* pbDest, UI
 ** Returns:
 **    ABCC_EC_NO_ERROR on success.
 **    ABCC_EC_PARAMETER_NOT_VALID, ABCC_EC_NO_RESOURCES or
-**    ABCC_EC_OUT_OF_MSG_BUFFERS on failure.
+**    ABCC_EC_OUT_OF_MSG_BUFFERS on failure. ABCC_EC_NO_RESOURCES is also
+**    returned while ANB_FSI_WRITE_BUFFERS writes are waiting for a response.
 **------------------------------------------------------------------------------
 */
 EXTFUNC ABCC_ErrorCodeType ANB_FSI_FileWrite( UINT16 iInstance, UINT8* pbSrc, UINT16 iReqSize, UINT16* piActSize, ANB_FSI_CompletionCbfType pnCallback );
@@ -0,0 +1,160 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Diagnostic event manager on top of the Diagnostic object message builders.
+**
+** The application raises and clears diagnostic events, the manager takes care
+** of sending the 'create' and 'delete' commands to the Diagnostic object and
+** of remembering the instance numbers the CompactCom assigned.
+**
+** DI_MgrRaise() and DI_MgrClear() only record the requested state. Commands
+** are sent from DI_MgrRun(), at most DI_MGR_MAX_CMDS_PER_RUN per call and
+** never more than there are free message buffers for. Only the latest state
+** of an event is sent, so an event that is raised and cleared before it was
+** flushed does not cause any traffic at all.
+**
+** - An event is identified by its severity, event code, slot, ADI, element and
+**   bit. Raising an event that is already raised does nothing.
+** - A cleared event is only deleted when it has stayed cleared for
+**   DI_MGR_HOLD_OFF_MS. An event that is raised again within that time keeps
+**   its instance, so a flapping condition does not cause any traffic.
+** - Create and delete commands are rate limited by a token bucket holding up
+**   to DI_MGR_RATE_BURST commands, refilled with one command every
+**   DI_MGR_RATE_REFILL_MS.
+** - All events are forgotten when the CompactCom is restarted, since the
+**   Diagnostic object instances do not survive a reset.
+**
+** DI_MgrInit(), DI_MgrRun() and DI_MgrRunTimer() are called by the ABCC
+** handler, the application only uses DI_MgrRaise() and DI_MgrClear().
+********************************************************************************
+*/
+
+#ifndef DI_MGR_H
+#define DI_MGR_H
+
+#include "../../src/abcc_api_config.h"
+#include "abcc.h"
+
+#if DI_OBJ_ENABLE
+
+/*******************************************************************************
+** Public constants
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Values for the slot, ADI, element and bit fields of DI_MgrEventType when
+** they are unknown or unsupported. An event where all four are unknown is
+** created without extended diagnostic data.
+**------------------------------------------------------------------------------
+*/
+#define DI_MGR_SLOT_UNKNOWN                           ( 0 )
+#define DI_MGR_ADI_UNKNOWN                            ( 0 )
+#define DI_MGR_ELEMENT_UNKNOWN                        ( 255 )
+#define DI_MGR_BIT_UNKNOWN                            ( 255 )
+
+/*******************************************************************************
+** Public typedefs
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Identification of a diagnostic event. See DI_BuildCmdCreateDiag() and
+** DI_BuildCmdAddExtDiag() for the meaning of the fields.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   ABP_DiEventSeverityType eSeverity;
+   ABP_DiEventCodeType     eEvent;
+   UINT16                  iSlot;
+   UINT16                  iAdi;
+   UINT8                   bElement;
+   UINT8                   bBit;
+}
+DI_MgrEventType;
+
+/*******************************************************************************
+** Public services
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Forget all events. Called by the ABCC handler when the CompactCom is
+** (re)started.
+**------------------------------------------------------------------------------
+** Arguments:
+**    -
+** Returns:
+**    -
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void DI_MgrInit( void );
+
+/*------------------------------------------------------------------------------
+** Raise a diagnostic event.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psEvent - Event to raise. Copied internally.
+** Returns:
+**    ABCC_EC_NO_ERROR if the event is raised, or already was.
+**    ABCC_EC_PARAMETER_NOT_VALID for invalid arguments.
+**    ABCC_EC_NO_RESOURCES if DI_MGR_MAX_EVENTS events are already tracked.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC ABCC_ErrorCodeType DI_MgrRaise( const DI_MgrEventType* psEvent );
+
+/*------------------------------------------------------------------------------
+** Clear a diagnostic event. Clearing an event that is not raised does nothing.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psEvent - Event to clear.
+** Returns:
+**    -
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void DI_MgrClear( const DI_MgrEventType* psEvent );
+
+/*------------------------------------------------------------------------------
+** Send a batch of pending create and delete commands. Called by the ABCC
+** handler from ABCC_API_Run().
+**------------------------------------------------------------------------------
+** Arguments:
+**    -
+** Returns:
+**    -
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void DI_MgrRun( void );
+
+/*------------------------------------------------------------------------------
+** Advance the hold-off timers and refill the rate limiter. Called by the ABCC
+** handler from ABCC_API_RunTimerSystem().
+**------------------------------------------------------------------------------
+** Arguments:
+**    iDeltaTimeMs - Milliseconds since the last call.
+** Returns:
+**    -
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void DI_MgrRunTimer( const INT16 iDeltaTimeMs );
+
+/*------------------------------------------------------------------------------
+** Time until DI_MgrRun() has a command to send, taking the hold-off timers and
+** the rate limiter into account. Used by ABCC_API_RunUntilEvent() to limit its
+** wait.
+**------------------------------------------------------------------------------
+** Arguments:
+**    -
+** Returns:
+**    0 if a command can be sent now, otherwise the milliseconds until one can,
+**    0xFFFFFFFF if no event needs a command.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC UINT32 DI_MgrNextRunMs( void );
+
+#endif /* DI_OBJ_ENABLE */
+
+#endif  /* inclusion lock */
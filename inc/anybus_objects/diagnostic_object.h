@@ -179,6 +179,58 @@ enum
 #define DI_PRT_NW_SPEC_ERR_CHAN_ERRTYPE_OUT_OF_RANGE        ( 0x11U )
 #define DI_PRT_NW_SPEC_ERR_UNKNOWN_ERROR                    ( 0xFFU )
 
+/*------------------------------------------------------------------------------
+** Compile-time version of the checks DI_PRT_BuildCmdAddChannelDiag() makes on
+** its arguments. Evaluates to non-zero if the combination is valid. All
+** arguments must be constant expressions.
+**
+** The ChannelProperties.Specifier bits (0x1800) must be cleared, and both
+** maintenance bits set means 'qualified', which can not be selected here.
+**------------------------------------------------------------------------------
+*/
+#define DI_PRT_CHANNEL_DESC_IS_VALID( iChannelNumber, iChannelProperties, iChannelErrorType )                      \
+   ( ( (iChannelNumber) <= DI_PRT_CHAN_NUM_ENTIRE_SUBMODULE ) &&                                                 \
+     !( ( (iChannelNumber) == DI_PRT_CHAN_NUM_ENTIRE_SUBMODULE ) &&                                              \
+        ( ( (iChannelProperties) & DI_PRT_CHAN_PROP_ACC_MASK ) == DI_PRT_CHAN_PROP_ACC_MULTI ) ) &&             \
+     ( ( (iChannelProperties) & DI_PRT_CHAN_PROP_TYPE_MASK ) <= DI_PRT_CHAN_PROP_TYPE_64BIT ) &&                 \
+     !( ( ( (iChannelProperties) & DI_PRT_CHAN_PROP_TYPE_MASK ) != DI_PRT_CHAN_PROP_TYPE_UNDEF ) &&              \
+        ( (iChannelNumber) == DI_PRT_CHAN_NUM_ENTIRE_SUBMODULE ) ) &&                                            \
+     ( ( (iChannelProperties) & DI_PRT_CHAN_PROP_MAINT_MASK ) != DI_PRT_CHAN_PROP_MAINT_MASK ) &&                \
+     ( ( (iChannelProperties) & 0x1800U ) == 0 ) &&                                                             \
+     ( ( (iChannelProperties) & DI_PRT_CHAN_PROP_DIR_MASK ) <= DI_PRT_CHAN_PROP_DIR_INOUT ) &&                   \
+     !( ( (iChannelErrorType) == 0x0000U ) ||                                                                   \
+        ( ( (iChannelErrorType) >= 0x0040U ) && ( (iChannelErrorType) <= 0x005FU ) ) ||                         \
+        ( (iChannelErrorType) == 0x7000U ) ||                                                                   \
+        ( ( (iChannelErrorType) >= 0x8000U ) && ( (iChannelErrorType) <= 0x8FFFU ) ) ||                         \
+        ( (iChannelErrorType) >= 0xA000U ) ) )
+
+/*------------------------------------------------------------------------------
+** Initializer for one DI_PRT_ChannelDescType entry. An invalid combination of
+** values is a compile error (negative array size), so a table built with this
+** macro never needs to be checked at runtime.
+**
+** Example, one entry per channel and error type:
+**
+**    static const DI_PRT_ChannelDescType asChannelDesc[] =
+**    {
+**       DI_PRT_CHANNEL_DESC( 0, DI_PRT_CHAN_PROP_TYPE_1BIT | DI_PRT_CHAN_PROP_DIR_OUT,
+**                            DI_PRT_CHAN_ERR_TYPE_SHORT_CIRCUIT ),
+**       DI_PRT_CHANNEL_DESC( 0, DI_PRT_CHAN_PROP_TYPE_1BIT | DI_PRT_CHAN_PROP_DIR_OUT,
+**                            DI_PRT_CHAN_ERR_TYPE_WIRE_BREAK ),
+**       ...
+**    };
+**------------------------------------------------------------------------------
+*/
+#define DI_PRT_CHANNEL_DESC( iChannelNumber, iChannelProperties, iChannelErrorType )                              \
+   {                                                                                                            \
+      (UINT16)( (iChannelNumber) +                                                                              \
+                0 * sizeof( char[ DI_PRT_CHANNEL_DESC_IS_VALID( iChannelNumber,                                 \
+                                                                iChannelProperties,                             \
+                                                                iChannelErrorType ) ? 1 : -1 ] ) ),             \
+      (UINT16)(iChannelProperties),                                                                             \
+      (UINT16)(iChannelErrorType)                                                                               \
+   }
+
 #endif /* PRT_OBJ_ENABLE */
 
 /*******************************************************************************
@@ -186,6 +238,37 @@ enum
 ********************************************************************************
 */
 
+#if PRT_OBJ_ENABLE
+
+/*------------------------------------------------------------------------------
+** Descriptor of one PROFINET channel diagnosis: the channel, its properties
+** (DI_PRT_CHAN_PROP_xxx type, direction, accumulative and maintenance bits)
+** and the error type. Use DI_PRT_CHANNEL_DESC() to build entries.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   UINT16   iChannelNumber;
+   UINT16   iChannelProperties;
+   UINT16   iChannelErrorType;
+}
+DI_PRT_ChannelDescType;
+
+/*------------------------------------------------------------------------------
+** Precomputed ChannelDiagnosis fields, in the byte order they are sent in.
+** Produced by DI_PRT_EncodeChannelTable(), treat as opaque.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   UINT16   iChannelNumberBe;
+   UINT16   iChannelPropertiesBe;
+   UINT16   iChannelErrorTypeBe;
+}
+DI_PRT_ChannelEncType;
+
+#endif /* PRT_OBJ_ENABLE */
+
 /*******************************************************************************
 ** Public globals
 ********************************************************************************
@@ -298,6 +381,41 @@ EXTFUNC ABCC_ErrorCodeType DI_PRT_BuildCmdAddChannelDiag( ABP_MsgType* psMsg, UI
 EXTFUNC ABCC_ErrorCodeType DI_PRT_BuildCmdAddExtChannelDiag( ABP_MsgType* psMsg, UINT16 iExtChannelErrorType, UINT32 lExtChannelAddValue );
 EXTFUNC ABCC_ErrorCodeType DI_PRT_BuildCmdAddQualChannelDiag( ABP_MsgType* psMsg, UINT8 bChannelQualifier );
 
+/*------------------------------------------------------------------------------
+** Validate a table of channel descriptors and precompute the encoding of each
+** entry. Intended to be called once at startup, e.g. from
+** ABCC_API_CbfUserInit(). Tables built with DI_PRT_CHANNEL_DESC() are already
+** known to be valid, the check matters for tables built at runtime.
+**------------------------------------------------------------------------------
+** Arguments:
+**    pasDesc - Channel descriptor table.
+**    pasEnc  - Destination table, same number of entries as pasDesc.
+**    iNumDesc - Number of entries.
+** Returns:
+**    ABCC_EC_NO_ERROR on success.
+**    ABCC_EC_PARAMETER_NOT_VALID if any entry is invalid, pasEnc is then
+**    left unchanged.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC ABCC_ErrorCodeType DI_PRT_EncodeChannelTable( const DI_PRT_ChannelDescType* pasDesc, DI_PRT_ChannelEncType* pasEnc, UINT16 iNumDesc );
+
+/*------------------------------------------------------------------------------
+** Same as DI_PRT_BuildCmdAddChannelDiag(), but takes an entry precomputed by
+** DI_PRT_EncodeChannelTable() and does not check the channel values again.
+** Raising a fault on a channel is then a table lookup and three writes.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psMsg - Pointer to the message buffer to write to.
+**    psEnc - Precomputed channel diagnosis.
+** Returns:
+**    ABCC_EC_NO_ERROR on success.
+**    ABCC_EC_PARAMETER_NOT_VALID for invalid arguments.
+**    ABCC_EC_INCORRECT_STATE if the message buffer does not contain a valid
+**    'Create' command for the DI object.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC ABCC_ErrorCodeType DI_PRT_BuildCmdAddChannelDiagEnc( ABP_MsgType* psMsg, const DI_PRT_ChannelEncType* psEnc );
+
 #endif /* PRT_OBJ_ENABLE */
 
 #endif /* DI_OBJ_ENABLE */
@@ -16,18 +16,291 @@
 #define ABCC_MATH_MIN( nX, nY )   ( ( (nX) < (nY) ) ? (nX) : (nY) )
 #define ABCC_OBJ_SPECIFIC_COMMAND( X ) ( ( X >= 0x10 && X <= 0x30 ) || X == 0x3F )
 
-#ifdef ABCC_API_COMMAND_RESPONSE_LIST
+#if ABCC_API_COMMAND_TABLE_GENERATED
+/*
+** Table sorted by object, instance, command and attribute, generated from the
+** object description by tools/abcc_api_command_table.py, the keys of its
+** entries and the range of each object in it.
+*/
+#include "abcc_api_command_table.h"
+#elif defined( ABCC_API_COMMAND_RESPONSE_LIST )
 static const Command_Handler_Lookup_Type command_handler_lookup_table[] = { ABCC_API_OBJ_ATTRIBUTE_RESPONSE_LIST ABCC_API_COMMAND_RESPONSE_LIST };
 #else
 static const Command_Handler_Lookup_Type command_handler_lookup_table[] = { ABCC_API_OBJ_ATTRIBUTE_RESPONSE_LIST };
 #endif
 
+#define APPL_LOOKUP_TABLE_LENGTH ( sizeof( command_handler_lookup_table ) / sizeof( Command_Handler_Lookup_Type ) )
+
+#if ABCC_API_COMMAND_RESPONSE_CACHE_SIZE
+/*
+** Encoded Get_Attribute responses of the constant entries. The response of
+** entry i is found from appl_aiRespCacheEnd[ i - 1 ] (0 for the first entry)
+** up to appl_aiRespCacheEnd[ i ]. The range is empty for entries without a
+** cached response.
+*/
+static UINT8  appl_abRespCache[ ABCC_API_COMMAND_RESPONSE_CACHE_SIZE ];
+static UINT16 appl_aiRespCacheEnd[ APPL_LOOKUP_TABLE_LENGTH ];
+#endif
+
+#if ABCC_API_DEFERRED_RESP_MAX
+/*
+** Command with a deferred response, psMsg is NULL for a free entry. The
+** sequence number in the handle tells a stale handle from the one of a later
+** command using the same entry.
+*/
+typedef struct
+{
+   ABP_MsgType*         psMsg;
+   UINT32               lTimeLeftMs;
+   ABP_MsgErrorCodeType eErrorCode;
+   UINT8                bSeq;
+   BOOL                 fReady;
+}
+appl_DeferredRespType;
+
+static appl_DeferredRespType appl_asDeferredResp[ ABCC_API_DEFERRED_RESP_MAX ];
+static UINT8 appl_bDeferredRespSeq = 0;
+
+/*
+** Command being handled, its deferred response entry when it is called again,
+** and if the callback deferred the response.
+*/
+static ABP_MsgType* appl_psHandledMsg = NULL;
+static appl_DeferredRespType* appl_psHandledResp = NULL;
+static BOOL appl_fRespDeferred = FALSE;
+#endif
+
+static void HandleCommand( ABP_MsgType* psReceivedCommandMsg );
+#if ABCC_API_DEFERRED_RESP_MAX
+static BOOL HandleDeferrableCommand( ABP_MsgType* psReceivedCommandMsg, appl_DeferredRespType* psResp );
+#endif
 static void SetResponseMessage( ABP_MsgType* psReceivedCommandMsg );
 static BOOL FindCommandHandler( ABP_MsgType* psReceivedCommandMsg, const Command_Handler_Lookup_Type* psEntry );
+static ABP_MsgErrorCodeType GetAttributeData( ABP_MsgType* psReceivedCommandMsg, const Command_Handler_Lookup_Type* psEntry, UINT16 iOffset, UINT16* piSize );
 static void GetAttributeHandler( ABP_MsgType* psReceivedCommandMsg, const Command_Handler_Lookup_Type* psEntry );
+#if ABCC_API_GET_ALL_ATTR_CMD
+static BOOL GetAllAttributesHandler( ABP_MsgType* psReceivedCommandMsg );
+#endif
 static void SetAttributeHandler( ABP_MsgType* psReceivedCommandMsg, const Command_Handler_Lookup_Type* psEntry );
 static BOOL ObjectSpecificHandler( ABP_MsgType* psReceivedCommandMsg, const Command_Handler_Lookup_Type* psEntry );
 
+/*------------------------------------------------------------------------------
+** Size of the elements of a typed array service.
+**------------------------------------------------------------------------------
+** Arguments:
+**    eServiceTag - Service tag, enum ABCC_ATTR_SERVICE_TAG.
+**
+** Returns:
+**    Size of an element in octets, 0 if the service is not a typed array.
+**------------------------------------------------------------------------------
+*/
+static UINT8 ArrayElementSize( UINT8 eServiceTag )
+{
+   switch( eServiceTag )
+   {
+   case SERVICE_UINT16_ARRAY:
+   case SERVICE_INT16_ARRAY:
+      return( ABP_UINT16_SIZEOF );
+   case SERVICE_UINT32_ARRAY:
+   case SERVICE_INT32_ARRAY:
+   case SERVICE_FLOAT_ARRAY:
+      return( ABP_UINT32_SIZEOF );
+#if( ABCC_CFG_64BIT_ADI_SUPPORT_ENABLED )
+   case SERVICE_UINT64_ARRAY:
+   case SERVICE_INT64_ARRAY:
+      return( ABP_UINT64_SIZEOF );
+#endif
+#if( ABCC_CFG_DOUBLE_ADI_SUPPORT_ENABLED )
+   case SERVICE_DOUBLE_ARRAY:
+      return( ABP_DOUBLE_SIZEOF );
+#endif
+   default:
+      return( 0 );
+   }
+}
+
+/*------------------------------------------------------------------------------
+** Converts the elements of a typed array between host and network (little
+** endian) byte order, in place. Nothing to do on little endian hosts.
+**------------------------------------------------------------------------------
+** Arguments:
+**    pxData       - Base pointer to the array.
+**    iOctetOffset - Octet offset to the first element.
+**    iSize        - Size of the array in octets. Octets after the last whole
+**                   element are left as they are.
+**    bElemSize    - Size of an element in octets, see ArrayElementSize().
+**
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+static void SwapElements( void* pxData, UINT16 iOctetOffset, UINT16 iSize, UINT8 bElemSize )
+{
+#ifdef ABCC_SYS_BIG_ENDIAN
+   UINT16 iEnd;
+   UINT16 iConv;
+   UINT32 lConv;
+#if( ABCC_CFG_64BIT_ADI_SUPPORT_ENABLED || ABCC_CFG_DOUBLE_ADI_SUPPORT_ENABLED )
+   UINT64 l64Conv;
+#endif
+
+   if( bElemSize == 0 )
+   {
+      return;
+   }
+
+   iEnd = (UINT16)( iOctetOffset + iSize - ( iSize % bElemSize ) );
+   for( ; iOctetOffset < iEnd; iOctetOffset = (UINT16)( iOctetOffset + bElemSize ) )
+   {
+      switch( bElemSize )
+      {
+      case ABP_UINT16_SIZEOF:
+         ABCC_PORT_Copy16( &iConv, 0, pxData, iOctetOffset );
+         iConv = ABCC_iEndianSwap( iConv );
+         ABCC_PORT_Copy16( pxData, iOctetOffset, &iConv, 0 );
+         break;
+      case ABP_UINT32_SIZEOF:
+         ABCC_PORT_Copy32( &lConv, 0, pxData, iOctetOffset );
+         lConv = ABCC_lEndianSwap( lConv );
+         ABCC_PORT_Copy32( pxData, iOctetOffset, &lConv, 0 );
+         break;
+#if( ABCC_CFG_64BIT_ADI_SUPPORT_ENABLED || ABCC_CFG_DOUBLE_ADI_SUPPORT_ENABLED )
+      case ABP_UINT64_SIZEOF:
+         ABCC_PORT_Copy64( &l64Conv, 0, pxData, iOctetOffset );
+         l64Conv = ABCC_l64EndianSwap( l64Conv );
+         ABCC_PORT_Copy64( pxData, iOctetOffset, &l64Conv, 0 );
+         break;
+#endif
+      default:
+         return;
+      }
+   }
+#else
+   (void)pxData;
+   (void)iOctetOffset;
+   (void)iSize;
+   (void)bElemSize;
+#endif
+}
+
+#if ABCC_API_COMMAND_RESPONSE_CACHE_SIZE
+/*------------------------------------------------------------------------------
+** Encodes the Get_Attribute response of a constant entry into the response
+** cache.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psEntry - Constant Get_Attribute entry.
+**    iOffset - Octet offset in the cache to encode the response at.
+**    piSize  - Set to the size of the response in octets.
+**
+** Returns:
+**    TRUE if the response was encoded, FALSE if it does not fit in the cache.
+**------------------------------------------------------------------------------
+*/
+static BOOL EncodeConstantResponse( const Command_Handler_Lookup_Type* psEntry, UINT16 iOffset, UINT16* piSize )
+{
+   UINT16 iValue;
+   UINT32 lValue;
+
+   switch( psEntry->eServiceTag )
+   {
+   case SERVICE_BOOL8:
+   case SERVICE_INT8:
+   case SERVICE_UINT8:
+      *piSize = ABP_UINT8_SIZEOF;
+      break;
+   case SERVICE_INT16:
+   case SERVICE_UINT16:
+      *piSize = ABP_UINT16_SIZEOF;
+      break;
+   case SERVICE_INT32:
+   case SERVICE_UINT32:
+   case SERVICE_FLOAT:
+      *piSize = ABP_UINT32_SIZEOF;
+      break;
+   case SERVICE_STR:
+      *piSize = (UINT16)strlen( psEntry->uData.pacString );
+      break;
+   case SERVICE_BUFFER:
+      *piSize = psEntry->uAttrLength.iDataSize;
+      break;
+   default:
+      if( ArrayElementSize( psEntry->eServiceTag ) > 0 )
+      {
+         *piSize = psEntry->uAttrLength.iDataSize;
+         break;
+      }
+      /*
+      ** Left to GetAttributeData() to reject.
+      */
+      *piSize = 0;
+      return( TRUE );
+   }
+
+   if( *piSize > ABCC_API_COMMAND_RESPONSE_CACHE_SIZE - iOffset )
+   {
+      *piSize = 0;
+      return( FALSE );
+   }
+
+   switch( psEntry->eServiceTag )
+   {
+   case SERVICE_BOOL8:
+   case SERVICE_INT8:
+   case SERVICE_UINT8:
+      ABCC_PORT_Copy8( appl_abRespCache, iOffset, &psEntry->uData.bUnsigned8, 0 );
+      break;
+   case SERVICE_INT16:
+   case SERVICE_UINT16:
+      iValue = iTOiLe( psEntry->uData.iUnsigned16 );
+      ABCC_PORT_Copy16( appl_abRespCache, iOffset, &iValue, 0 );
+      break;
+   case SERVICE_INT32:
+   case SERVICE_UINT32:
+   case SERVICE_FLOAT:
+      lValue = lTOlLe( psEntry->uData.lUnsigned32 );
+      ABCC_PORT_Copy32( appl_abRespCache, iOffset, &lValue, 0 );
+      break;
+   default:
+      ABCC_PORT_CopyOctets( appl_abRespCache, iOffset, psEntry->uData.pacString, 0, *piSize );
+      SwapElements( appl_abRespCache, iOffset, *piSize, ArrayElementSize( psEntry->eServiceTag ) );
+      break;
+   }
+
+   return( TRUE );
+}
+
+void ABCC_API_CommandResponseCacheBuild( void )
+{
+   const Command_Handler_Lookup_Type* psEntry;
+   UINT16 iEnd = 0;
+   UINT16 iNotCached = 0;
+   UINT16 iSize;
+   UINT16 i;
+
+   for( i = 0; i < APPL_LOOKUP_TABLE_LENGTH; i++ )
+   {
+      psEntry = &command_handler_lookup_table[ i ];
+      if( ( psEntry->bCommand == ABP_CMD_GET_ATTR ) &&
+          ( psEntry->uCbx.pxUnknownFuncPtr == NULL ) )
+      {
+         if( !EncodeConstantResponse( psEntry, iEnd, &iSize ) )
+         {
+            iNotCached++;
+         }
+         iEnd = (UINT16)( iEnd + iSize );
+      }
+      appl_aiRespCacheEnd[ i ] = iEnd;
+   }
+
+   if( iNotCached > 0 )
+   {
+      ABCC_LOG_INFO( "%u constant Get_Attribute responses did not fit in the response cache.\n",
+                     (unsigned int)iNotCached );
+   }
+}
+#endif
+
 void ABCC_CbfHandleCommandMessage( ABP_MsgType* psReceivedCommandMsg )
 {
 #if ABCC_API_COMMAND_MESSAGE_HOOK_ENABLED
@@ -44,13 +317,439 @@ void ABCC_CbfHandleCommandMessage( ABP_MsgType* psReceivedCommandMsg )
       return;
    default:
    {
-      SetResponseMessage( psReceivedCommandMsg );
+#if ABCC_API_DEFERRED_RESP_MAX
+      if( !HandleDeferrableCommand( psReceivedCommandMsg, NULL ) )
+      {
+         /*
+         ** Answered later by ABCC_API_DeferredRespRun().
+         */
+         return;
+      }
+#else
+      HandleCommand( psReceivedCommandMsg );
+#endif
       ABCC_SendRespMsg( psReceivedCommandMsg );
       return;
    }
    }
 }
 
+static void HandleCommand( ABP_MsgType* psReceivedCommandMsg )
+{
+#if ABCC_API_GET_ALL_ATTR_CMD
+   if( !GetAllAttributesHandler( psReceivedCommandMsg ) )
+#endif
+   {
+      SetResponseMessage( psReceivedCommandMsg );
+   }
+}
+
+#if ABCC_API_DEFERRED_RESP_MAX
+/*------------------------------------------------------------------------------
+** Handles a command whose response a callback may defer.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psReceivedCommandMsg - Command message.
+**    psResp               - Deferred response entry of the command, NULL the
+**                           first time the command is handled.
+**
+** Returns:
+**    TRUE if the response is ready to be sent, FALSE if it was deferred.
+**------------------------------------------------------------------------------
+*/
+static BOOL HandleDeferrableCommand( ABP_MsgType* psReceivedCommandMsg, appl_DeferredRespType* psResp )
+{
+   const UINT16 iDataSize = ABCC_GetMsgDataSize( psReceivedCommandMsg );
+   const UINT8 bCmdField  = ABCC_GetMsgCmdField( psReceivedCommandMsg );
+
+   appl_psHandledMsg  = psReceivedCommandMsg;
+   appl_psHandledResp = psResp;
+   appl_fRespDeferred = FALSE;
+
+   HandleCommand( psReceivedCommandMsg );
+
+   psResp = appl_psHandledResp;
+   appl_psHandledMsg  = NULL;
+   appl_psHandledResp = NULL;
+
+   if( appl_fRespDeferred )
+   {
+      /*
+      ** The handlers have turned the command into a response regardless, put
+      ** back the request for the next call of the callback. Only the header
+      ** needs it, Get requests carry no data and SetAttributeHandler() leaves
+      ** the data of a deferred Set request as it was.
+      */
+      ABCC_SetMsgDataSize( psReceivedCommandMsg, iDataSize );
+      ABCC_SetMsgCmdField( psReceivedCommandMsg, bCmdField );
+      return( FALSE );
+   }
+
+   if( psResp != NULL )
+   {
+      psResp->psMsg = NULL;
+   }
+   return( TRUE );
+}
+
+/*------------------------------------------------------------------------------
+** Finds the entry of a deferred response handle that is still waiting for the
+** application.
+**------------------------------------------------------------------------------
+** Arguments:
+**    hResp - Handle from ABCC_API_DeferResponse().
+**
+** Returns:
+**    The entry, NULL if the handle is not valid or the entry is already ready,
+**    e.g. since it timed out.
+**------------------------------------------------------------------------------
+*/
+static appl_DeferredRespType* FindDeferredResp( ABCC_API_DeferredRespHandleType hResp )
+{
+   const UINT8 bIndex = (UINT8)( hResp & 0xFF );
+
+   if( ( bIndex >= ABCC_API_DEFERRED_RESP_MAX ) ||
+       ( appl_asDeferredResp[ bIndex ].psMsg == NULL ) ||
+       ( appl_asDeferredResp[ bIndex ].bSeq != (UINT8)( hResp >> 8 ) ) ||
+       appl_asDeferredResp[ bIndex ].fReady )
+   {
+      return( NULL );
+   }
+
+   return( &appl_asDeferredResp[ bIndex ] );
+}
+
+void ABCC_API_DeferredRespInit( void )
+{
+   UINT8 bIndex;
+
+   for( bIndex = 0; bIndex < ABCC_API_DEFERRED_RESP_MAX; bIndex++ )
+   {
+      appl_asDeferredResp[ bIndex ].psMsg = NULL;
+   }
+   appl_psHandledMsg  = NULL;
+   appl_psHandledResp = NULL;
+   appl_fRespDeferred = FALSE;
+}
+
+ABCC_API_DeferredRespHandleType ABCC_API_DeferResponse( void )
+{
+   UINT8 bIndex;
+
+   if( appl_psHandledMsg == NULL )
+   {
+      return( ABCC_API_DEFERRED_RESP_INVALID );
+   }
+
+   if( appl_psHandledResp == NULL )
+   {
+      for( bIndex = 0; bIndex < ABCC_API_DEFERRED_RESP_MAX; bIndex++ )
+      {
+         if( appl_asDeferredResp[ bIndex ].psMsg == NULL )
+         {
+            break;
+         }
+      }
+
+      if( bIndex == ABCC_API_DEFERRED_RESP_MAX )
+      {
+         ABCC_LOG_WARNING( ABCC_EC_NO_RESOURCES,
+                           (UINT32)ABCC_API_DEFERRED_RESP_MAX,
+                           "No free entry for a deferred response.\n" );
+         return( ABCC_API_DEFERRED_RESP_INVALID );
+      }
+
+      appl_psHandledResp = &appl_asDeferredResp[ bIndex ];
+      appl_psHandledResp->psMsg       = appl_psHandledMsg;
+      appl_psHandledResp->lTimeLeftMs = ABCC_API_DEFERRED_RESP_TIMEOUT_MS;
+      appl_psHandledResp->bSeq        = appl_bDeferredRespSeq++;
+   }
+
+   appl_psHandledResp->eErrorCode = ABP_ERR_NO_ERROR;
+   appl_psHandledResp->fReady     = FALSE;
+   appl_fRespDeferred = TRUE;
+
+   return( (ABCC_API_DeferredRespHandleType)( ( (UINT16)appl_psHandledResp->bSeq << 8 ) |
+                                              (UINT16)( appl_psHandledResp - appl_asDeferredResp ) ) );
+}
+
+BOOL ABCC_API_DeferredRespReady( ABCC_API_DeferredRespHandleType hResp )
+{
+   appl_DeferredRespType* psResp = FindDeferredResp( hResp );
+
+   if( psResp == NULL )
+   {
+      return( FALSE );
+   }
+
+   psResp->fReady = TRUE;
+   return( TRUE );
+}
+
+BOOL ABCC_API_DeferredRespError( ABCC_API_DeferredRespHandleType hResp,
+                                 ABP_MsgErrorCodeType eErrorCode )
+{
+   appl_DeferredRespType* psResp = FindDeferredResp( hResp );
+
+   if( psResp == NULL )
+   {
+      return( FALSE );
+   }
+
+   psResp->eErrorCode = eErrorCode;
+   psResp->fReady     = TRUE;
+   return( TRUE );
+}
+
+void ABCC_API_DeferredRespRun( void )
+{
+   appl_DeferredRespType* psResp;
+   ABP_MsgType* psMsg;
+   UINT8 bIndex;
+
+   for( bIndex = 0; bIndex < ABCC_API_DEFERRED_RESP_MAX; bIndex++ )
+   {
+      psResp = &appl_asDeferredResp[ bIndex ];
+      psMsg  = psResp->psMsg;
+      if( ( psMsg == NULL ) || !psResp->fReady )
+      {
+         continue;
+      }
+
+      if( psResp->eErrorCode != ABP_ERR_NO_ERROR )
+      {
+         ABP_SetMsgErrorResponse( psMsg, 1, psResp->eErrorCode );
+         psResp->psMsg = NULL;
+      }
+      else if( !HandleDeferrableCommand( psMsg, psResp ) )
+      {
+         continue;
+      }
+
+      ABCC_SendRespMsg( psMsg );
+   }
+}
+
+UINT32 ABCC_API_DeferredRespNextRunMs( void )
+{
+   const appl_DeferredRespType* psResp;
+   UINT32 lNextMs = 0xFFFFFFFF;
+   UINT8 bIndex;
+
+   for( bIndex = 0; bIndex < ABCC_API_DEFERRED_RESP_MAX; bIndex++ )
+   {
+      psResp = &appl_asDeferredResp[ bIndex ];
+      if( psResp->psMsg == NULL )
+      {
+         continue;
+      }
+
+      if( psResp->fReady )
+      {
+         return( 0 );
+      }
+
+      if( psResp->lTimeLeftMs < lNextMs )
+      {
+         lNextMs = psResp->lTimeLeftMs;
+      }
+   }
+
+   return( lNextMs );
+}
+
+void ABCC_API_DeferredRespRunTimer( INT16 iDeltaTimeMs )
+{
+   appl_DeferredRespType* psResp;
+   UINT8 bIndex;
+
+   if( iDeltaTimeMs <= 0 )
+   {
+      return;
+   }
+
+   for( bIndex = 0; bIndex < ABCC_API_DEFERRED_RESP_MAX; bIndex++ )
+   {
+      psResp = &appl_asDeferredResp[ bIndex ];
+      if( ( psResp->psMsg == NULL ) || psResp->fReady )
+      {
+         continue;
+      }
+
+      if( psResp->lTimeLeftMs > (UINT32)iDeltaTimeMs )
+      {
+         psResp->lTimeLeftMs -= (UINT32)iDeltaTimeMs;
+      }
+      else
+      {
+         ABCC_LOG_WARNING( ABCC_EC_INTERNAL_ERROR,
+                           (UINT32)ABCC_GetMsgDestObj( psResp->psMsg ),
+                           "Deferred response to object 0x%02X timed out.\n",
+                           (unsigned int)ABCC_GetMsgDestObj( psResp->psMsg ) );
+         psResp->eErrorCode = ABP_ERR_GENERAL_ERROR;
+         psResp->fReady     = TRUE;
+      }
+   }
+}
+#endif
+
+#if ABCC_API_COMMAND_TABLE_GENERATED
+/*------------------------------------------------------------------------------
+** Find the range of an object in the generated table.
+**------------------------------------------------------------------------------
+** Arguments:
+**    bObject - Object number.
+**
+** Returns:
+**    The range of the object, NULL if the object has no entries.
+**------------------------------------------------------------------------------
+*/
+static const Command_Handler_Object_Type* FindObject( UINT8 bObject )
+{
+   UINT16 iLow  = 0;
+   UINT16 iHigh = (UINT16)( sizeof( command_handler_object_table ) / sizeof( Command_Handler_Object_Type ) );
+   UINT16 iMid;
+
+   while( iLow < iHigh )
+   {
+      iMid = (UINT16)( ( iLow + iHigh ) / 2 );
+      if( command_handler_object_table[ iMid ].bObject < bObject )
+      {
+         iLow = (UINT16)( iMid + 1 );
+      }
+      else
+      {
+         iHigh = iMid;
+      }
+   }
+
+   if( ( iLow < sizeof( command_handler_object_table ) / sizeof( Command_Handler_Object_Type ) ) &&
+       ( command_handler_object_table[ iLow ].bObject == bObject ) )
+   {
+      return( &command_handler_object_table[ iLow ] );
+   }
+
+   return( NULL );
+}
+
+/*------------------------------------------------------------------------------
+** Find the first entry of an object range with a key equal to or above the
+** given instance, command and attribute.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psObject  - Object range.
+**    iInstance - Instance.
+**    iCommand  - Command.
+**    bAttr     - Attribute, 0 for commands not addressing an attribute.
+**
+** Returns:
+**    Index of the entry, psObject->iEnd if there is none.
+**------------------------------------------------------------------------------
+*/
+static UINT16 FindFirstEntry( const Command_Handler_Object_Type* psObject, UINT16 iInstance, UINT16 iCommand, UINT8 bAttr )
+{
+   const Command_Handler_Key_Type* psKey;
+   UINT16 iLow  = psObject->iFirst;
+   UINT16 iHigh = psObject->iEnd;
+   UINT16 iMid;
+
+   while( iLow < iHigh )
+   {
+      iMid = (UINT16)( ( iLow + iHigh ) / 2 );
+      psKey = &command_handler_key_table[ iMid ];
+      if( ( psKey->bInstance < iInstance ) ||
+          ( ( psKey->bInstance == iInstance ) &&
+            ( ( psKey->bCommand < iCommand ) ||
+              ( ( psKey->bCommand == iCommand ) && ( psKey->bAttr < bAttr ) ) ) ) )
+      {
+         iLow = (UINT16)( iMid + 1 );
+      }
+      else
+      {
+         iHigh = iMid;
+      }
+   }
+
+   return( iLow );
+}
+
+static void SetResponseMessage( ABP_MsgType* psReceivedCommandMsg )
+{
+   const Command_Handler_Object_Type* psObject;
+   const Command_Handler_Key_Type* psKey;
+   UINT16 iIndex;
+   UINT8 bAttr;
+   BOOL fAttrCommand;
+   BOOL fInstanceFound;
+   UINT8 bDestObj      = ABCC_GetMsgDestObj( psReceivedCommandMsg );
+   UINT16 bInst        = ABCC_GetMsgInstance( psReceivedCommandMsg );
+   ABP_MsgCmdType bCmd = ABCC_GetMsgCmdBits( psReceivedCommandMsg );
+
+   psObject = FindObject( bDestObj );
+   if( psObject == NULL )
+   {
+      /*
+      ** No command handler entry was found due to unsupported object.
+      */
+      ABP_SetMsgErrorResponse( psReceivedCommandMsg, 1, ABP_ERR_UNSUP_OBJ );
+      return;
+   }
+
+   /*
+   ** The entries of the commands addressing an attribute are found directly,
+   ** the others are tried in turn by FindCommandHandler().
+   */
+   fAttrCommand = ( bCmd == ABP_CMD_GET_ATTR ) ||
+                  ( bCmd == ABP_CMD_SET_ATTR ) ||
+                  ( bCmd == ABP_CMD_GET_ENUM_STR );
+   bAttr = fAttrCommand ? ABCC_GetMsgCmdExt0( psReceivedCommandMsg ) : 0;
+
+   iIndex = FindFirstEntry( psObject, bInst, (UINT16)bCmd, bAttr );
+
+   /*
+   ** The instance is supported if it has an entry at or just before the
+   ** position of the key.
+   */
+   fInstanceFound = ( ( iIndex < psObject->iEnd ) &&
+                      ( command_handler_key_table[ iIndex ].bInstance == bInst ) ) ||
+                    ( ( iIndex > psObject->iFirst ) &&
+                      ( command_handler_key_table[ iIndex - 1 ].bInstance == bInst ) );
+
+   for( ; iIndex < psObject->iEnd; iIndex++ )
+   {
+      psKey = &command_handler_key_table[ iIndex ];
+      if( ( psKey->bInstance != bInst ) ||
+          ( psKey->bCommand  != (UINT16)bCmd ) ||
+          ( fAttrCommand && ( psKey->bAttr != bAttr ) ) )
+      {
+         break;
+      }
+
+      if( FindCommandHandler( psReceivedCommandMsg, &command_handler_lookup_table[ iIndex ] ) )
+      {
+         /*
+         ** Command handler found.
+         */
+         return;
+      }
+   }
+
+   if( fInstanceFound )
+   {
+      /*
+      ** No command handler entry was found due to unsupported command.
+      */
+      ABP_SetMsgErrorResponse( psReceivedCommandMsg, 1, ABP_ERR_UNSUP_CMD );
+   }
+   else
+   {
+      /*
+      ** No command handler entry was found due to unsupported instance.
+      */
+      ABP_SetMsgErrorResponse( psReceivedCommandMsg, 1, ABP_ERR_UNSUP_INST );
+   }
+}
+#else
 static void SetResponseMessage( ABP_MsgType* psReceivedCommandMsg )
 {
    const Command_Handler_Lookup_Type* psEntry;
@@ -110,6 +809,7 @@ static void SetResponseMessage( ABP_MsgType* psReceivedCommandMsg )
       ABP_SetMsgErrorResponse( psReceivedCommandMsg, 1, ABP_ERR_UNSUP_OBJ );
       return;
 }
+#endif
 
 static BOOL FindCommandHandler( ABP_MsgType* psReceivedCommandMsg, const Command_Handler_Lookup_Type* psEntry )
 {
@@ -168,82 +868,364 @@ static BOOL FindCommandHandler( ABP_MsgType* psReceivedCommandMsg, const Command
    return( FALSE );
 }
 
-static void GetAttributeHandler( ABP_MsgType* psReceivedCommandMsg, const Command_Handler_Lookup_Type* psEntry )
+/*------------------------------------------------------------------------------
+** Writes the value of an attribute to a command message.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psReceivedCommandMsg - Command message to write the value to.
+**    psEntry              - Get_Attribute entry of the attribute.
+**    iOffset              - Octet offset in the message data of the value.
+**    piSize               - Set to the size of the value in octets.
+**
+** Returns:
+**    ABP_ERR_NO_ERROR, ABP_ERR_NO_RESOURCES if the value does not fit in the
+**    message, or ABP_ERR_GENERAL_ERROR if the data type is not supported.
+**------------------------------------------------------------------------------
+*/
+static ABP_MsgErrorCodeType GetAttributeData( ABP_MsgType* psReceivedCommandMsg, const Command_Handler_Lookup_Type* psEntry, UINT16 iOffset, UINT16* piSize )
 {
+   const UINT16 iSpace = (UINT16)( ABCC_GetMaxMessageSize() - iOffset );
+
+#if ABCC_API_COMMAND_RESPONSE_CACHE_SIZE
+   UINT16 iIndex = (UINT16)( psEntry - command_handler_lookup_table );
+   UINT16 iStart = ( iIndex == 0 ) ? 0 : appl_aiRespCacheEnd[ iIndex - 1 ];
+
+   *piSize = (UINT16)( appl_aiRespCacheEnd[ iIndex ] - iStart );
+   if( *piSize > 0 )
+   {
+      if( *piSize > iSpace )
+      {
+         return( ABP_ERR_NO_RESOURCES );
+      }
+      ABCC_PORT_CopyOctets( ABCC_GetMsgDataPtr( psReceivedCommandMsg ), iOffset,
+                            appl_abRespCache, iStart, *piSize );
+      return( ABP_ERR_NO_ERROR );
+   }
+#endif
+
    switch( psEntry->eServiceTag )
    {
       case SERVICE_BOOL8:
       case SERVICE_INT8:
       case SERVICE_UINT8:
-         ABCC_SetMsgData8( psReceivedCommandMsg,
-                           psEntry->uCbx.pnGetUint8Attr ?
-                           psEntry->uCbx.pnGetUint8Attr() :
-                           psEntry->uData.bUnsigned8,
-                           0 );
-         ABP_SetMsgResponse( psReceivedCommandMsg, ABP_UINT8_SIZEOF );
-         return;
+      {
+         UINT8 bValue = psEntry->uData.bUnsigned8;
+
+         *piSize = ABP_UINT8_SIZEOF;
+         if( iSpace < *piSize )
+         {
+            return( ABP_ERR_NO_RESOURCES );
+         }
+         if( psEntry->uCbx.pnGetUint8Attr )
+         {
+            bValue = ( psEntry->eServiceTag == SERVICE_BOOL8 ) ? (UINT8)psEntry->uCbx.pnGetBool8Attr() :
+                     ( psEntry->eServiceTag == SERVICE_INT8 )  ? (UINT8)psEntry->uCbx.pnGetInt8Attr() :
+                                                                 psEntry->uCbx.pnGetUint8Attr();
+         }
+         ABCC_SetMsgData8( psReceivedCommandMsg, bValue, iOffset );
+         return( ABP_ERR_NO_ERROR );
+      }
       case SERVICE_INT16:
       case SERVICE_UINT16:
-         ABCC_SetMsgData16( psReceivedCommandMsg,
-                            psEntry->uCbx.pnGetUint16Attr ?
-                            psEntry->uCbx.pnGetUint16Attr() :
-                            psEntry->uData.iUnsigned16,
-                            0 );
-         ABP_SetMsgResponse( psReceivedCommandMsg, ABP_UINT16_SIZEOF );
-         return;
+      {
+         UINT16 iValue = psEntry->uData.iUnsigned16;
+
+         *piSize = ABP_UINT16_SIZEOF;
+         if( iSpace < *piSize )
+         {
+            return( ABP_ERR_NO_RESOURCES );
+         }
+         if( psEntry->uCbx.pnGetUint16Attr )
+         {
+            iValue = ( psEntry->eServiceTag == SERVICE_INT16 ) ? (UINT16)psEntry->uCbx.pnGetInt16Attr() :
+                                                                 psEntry->uCbx.pnGetUint16Attr();
+         }
+         ABCC_SetMsgData16( psReceivedCommandMsg, iValue, iOffset );
+         return( ABP_ERR_NO_ERROR );
+      }
       case SERVICE_INT32:
       case SERVICE_UINT32:
-         ABCC_SetMsgData32( psReceivedCommandMsg,
-                            psEntry->uCbx.pnGetUint32Attr ?
-                            psEntry->uCbx.pnGetUint32Attr() :
-                            psEntry->uData.lUnsigned32,
-                            0 );
-         ABP_SetMsgResponse( psReceivedCommandMsg, ABP_UINT32_SIZEOF );
-         return;
-      case SERVICE_STR:
+      case SERVICE_FLOAT:
       {
-         UINT16 iStrLength;
+         /*
+         ** Holds the bit pattern of uData.rFloat for a FLOAT.
+         */
+         UINT32 lValue = psEntry->uData.lUnsigned32;
+
+         *piSize = ABP_UINT32_SIZEOF;
+         if( iSpace < *piSize )
+         {
+            return( ABP_ERR_NO_RESOURCES );
+         }
+         if( psEntry->uCbx.pnGetUint32Attr )
+         {
+            if( psEntry->eServiceTag == SERVICE_FLOAT )
+            {
+               FLOAT32 rValue = psEntry->uCbx.pnGetFloatAttr();
+               ABCC_PORT_Copy32( &lValue, 0, &rValue, 0 );
+            }
+            else
+            {
+               lValue = ( psEntry->eServiceTag == SERVICE_INT32 ) ? (UINT32)psEntry->uCbx.pnGetInt32Attr() :
+                                                                    psEntry->uCbx.pnGetUint32Attr();
+            }
+         }
+         ABCC_SetMsgData32( psReceivedCommandMsg, lValue, iOffset );
+         return( ABP_ERR_NO_ERROR );
+      }
+#if( ABCC_CFG_64BIT_ADI_SUPPORT_ENABLED )
+      case SERVICE_UINT64:
+      case SERVICE_INT64:
+      {
+         UINT64 l64Value;
+
+         if( psEntry->uCbx.pnGetUint64Attr == NULL )
+         {
+            break;
+         }
+         *piSize = ABP_UINT64_SIZEOF;
+         if( iSpace < *piSize )
+         {
+            return( ABP_ERR_NO_RESOURCES );
+         }
+         l64Value = ( psEntry->eServiceTag == SERVICE_INT64 ) ? (UINT64)psEntry->uCbx.pnGetInt64Attr() :
+                                                                psEntry->uCbx.pnGetUint64Attr();
+         ABCC_PORT_Copy64( ABCC_GetMsgDataPtr( psReceivedCommandMsg ), iOffset, &l64Value, 0 );
+         SwapElements( ABCC_GetMsgDataPtr( psReceivedCommandMsg ), iOffset, *piSize, ABP_UINT64_SIZEOF );
+         return( ABP_ERR_NO_ERROR );
+      }
+#endif
+#if( ABCC_CFG_DOUBLE_ADI_SUPPORT_ENABLED )
+      case SERVICE_DOUBLE:
+      {
+         FLOAT64 dValue;
+
+         if( psEntry->uCbx.pnGetDoubleAttr == NULL )
+         {
+            break;
+         }
+         *piSize = ABP_DOUBLE_SIZEOF;
+         if( iSpace < *piSize )
+         {
+            return( ABP_ERR_NO_RESOURCES );
+         }
+         dValue = psEntry->uCbx.pnGetDoubleAttr();
+         ABCC_PORT_Copy64( ABCC_GetMsgDataPtr( psReceivedCommandMsg ), iOffset, &dValue, 0 );
+         SwapElements( ABCC_GetMsgDataPtr( psReceivedCommandMsg ), iOffset, *piSize, ABP_DOUBLE_SIZEOF );
+         return( ABP_ERR_NO_ERROR );
+      }
+#endif
+      case SERVICE_STR:
          if( psEntry->uCbx.pnGetStrAttr )
          {
-            iStrLength = psEntry->uCbx.pnGetStrAttr( (char*)ABCC_GetMsgDataPtr( psReceivedCommandMsg ),
-                                                     ABCC_MATH_MIN( ABCC_GetMaxMessageSize(),
-                                                     psEntry->uAttrLength.iMaxDataSize ) );
+            *piSize = psEntry->uCbx.pnGetStrAttr( (char*)ABCC_GetMsgDataPtr( psReceivedCommandMsg ) + iOffset,
+                                                  ABCC_MATH_MIN( iSpace,
+                                                  psEntry->uAttrLength.iMaxDataSize ) );
          }
          else
          {
-            const char* pStr = psEntry->uData.pacString;
-            iStrLength = ( UINT16 )strlen( pStr );
+            *piSize = (UINT16)strlen( psEntry->uData.pacString );
+            if( iSpace < *piSize )
+            {
+               return( ABP_ERR_NO_RESOURCES );
+            }
             ABCC_SetMsgString( psReceivedCommandMsg,
-                               pStr,
-                               iStrLength,
-                               0 );
+                               psEntry->uData.pacString,
+                               *piSize,
+                               iOffset );
          }
-         ABP_SetMsgResponse( psReceivedCommandMsg, iStrLength );
-         return;
-      }
+         return( ABP_ERR_NO_ERROR );
       case SERVICE_BUFFER:
+      case SERVICE_UINT16_ARRAY:
+      case SERVICE_INT16_ARRAY:
+      case SERVICE_UINT32_ARRAY:
+      case SERVICE_INT32_ARRAY:
+      case SERVICE_FLOAT_ARRAY:
+      case SERVICE_UINT64_ARRAY:
+      case SERVICE_INT64_ARRAY:
+      case SERVICE_DOUBLE_ARRAY:
+         if( ( psEntry->eServiceTag != SERVICE_BUFFER ) &&
+             ( ArrayElementSize( psEntry->eServiceTag ) == 0 ) )
+         {
+            /*
+            ** 64-bit or DOUBLE array without the support enabled.
+            */
+            break;
+         }
          if( psEntry->uCbx.pnGetArrAttr )
          {
-            UINT16 iSizeBytes = psEntry->uCbx.pnGetArrAttr( ABCC_GetMsgDataPtr( psReceivedCommandMsg ),
-                                                            psEntry->uAttrLength.iMaxDataSize ?
-                                                            psEntry->uAttrLength.iMaxDataSize :
-                                                            ABCC_GetMaxMessageSize() );
-            ABP_SetMsgResponse( psReceivedCommandMsg, iSizeBytes );
+            *piSize = psEntry->uCbx.pnGetArrAttr( (UINT8*)ABCC_GetMsgDataPtr( psReceivedCommandMsg ) + iOffset,
+                                                  psEntry->uAttrLength.iMaxDataSize ?
+                                                  ABCC_MATH_MIN( iSpace, psEntry->uAttrLength.iMaxDataSize ) :
+                                                  iSpace );
          }
          else
          {
+            *piSize = psEntry->uAttrLength.iDataSize;
+            if( iSpace < *piSize )
+            {
+               return( ABP_ERR_NO_RESOURCES );
+            }
             ABCC_SetMsgString( psReceivedCommandMsg,
                                psEntry->uData.pacStringBuffer,
-                               psEntry->uAttrLength.iDataSize,
-                               0 );
-            ABP_SetMsgResponse( psReceivedCommandMsg, psEntry->uAttrLength.iDataSize );
+                               *piSize,
+                               iOffset );
          }
-         return;
+         SwapElements( ABCC_GetMsgDataPtr( psReceivedCommandMsg ), iOffset, *piSize,
+                       ArrayElementSize( psEntry->eServiceTag ) );
+         return( ABP_ERR_NO_ERROR );
       default:
-         ABP_SetMsgErrorResponse( psReceivedCommandMsg, 1, ABP_ERR_GENERAL_ERROR );
-         ABCC_LOG_ERROR( ABCC_EC_UNSUPPORTED_DATA_TYPE, (UINT32)psEntry->eServiceTag, "Response to Get_Attribute command not possible (unsupported datatype).\n" );
          break;
    }
+
+   *piSize = 0;
+   ABCC_LOG_ERROR( ABCC_EC_UNSUPPORTED_DATA_TYPE, (UINT32)psEntry->eServiceTag, "Response to Get_Attribute command not possible (unsupported datatype).\n" );
+   return( ABP_ERR_GENERAL_ERROR );
+}
+
+static void GetAttributeHandler( ABP_MsgType* psReceivedCommandMsg, const Command_Handler_Lookup_Type* psEntry )
+{
+   UINT16 iSize;
+   ABP_MsgErrorCodeType eErrorCode;
+
+   eErrorCode = GetAttributeData( psReceivedCommandMsg, psEntry, 0, &iSize );
+   if( eErrorCode == ABP_ERR_NO_ERROR )
+   {
+      ABP_SetMsgResponse( psReceivedCommandMsg, iSize );
+   }
+   else
+   {
+      ABP_SetMsgErrorResponse( psReceivedCommandMsg, 1, eErrorCode );
+   }
+}
+
+#if ABCC_API_GET_ALL_ATTR_CMD
+/*------------------------------------------------------------------------------
+** Answers a ABCC_API_GET_ALL_ATTR_CMD command with all gettable attributes of
+** the addressed instance.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psReceivedCommandMsg - Command message.
+**
+** Returns:
+**    TRUE if the command was answered, FALSE if it is another command or the
+**    instance has no gettable attributes in the lookup table.
+**------------------------------------------------------------------------------
+*/
+static BOOL GetAllAttributesHandler( ABP_MsgType* psReceivedCommandMsg )
+{
+   const Command_Handler_Lookup_Type* psEntry;
+#if ABCC_API_COMMAND_TABLE_GENERATED
+   const Command_Handler_Object_Type* psObject;
+#endif
+   UINT16 iIndex;
+   UINT16 iEnd;
+   UINT16 iSize;
+   UINT16 iOffset = 0;
+   BOOL fFound = FALSE;
+   ABP_MsgErrorCodeType eErrorCode = ABP_ERR_NO_ERROR;
+   UINT8 bDestObj = ABCC_GetMsgDestObj( psReceivedCommandMsg );
+   UINT16 bInst   = ABCC_GetMsgInstance( psReceivedCommandMsg );
+
+   if( ABCC_GetMsgCmdBits( psReceivedCommandMsg ) != ABCC_API_GET_ALL_ATTR_CMD )
+   {
+      return( FALSE );
+   }
+
+#if ABCC_API_COMMAND_TABLE_GENERATED
+   psObject = FindObject( bDestObj );
+   if( psObject == NULL )
+   {
+      return( FALSE );
+   }
+   iIndex = FindFirstEntry( psObject, bInst, ABP_CMD_GET_ATTR, 0 );
+   iEnd   = psObject->iEnd;
+#else
+   iIndex = 0;
+   iEnd   = (UINT16)APPL_LOOKUP_TABLE_LENGTH;
+#endif
+
+   for( ; iIndex < iEnd; iIndex++ )
+   {
+      psEntry = &command_handler_lookup_table[ iIndex ];
+      if( ( psEntry->bObject   != bDestObj ) ||
+          ( psEntry->bInstance != bInst ) ||
+          ( psEntry->bCommand  != ABP_CMD_GET_ATTR ) )
+      {
+#if ABCC_API_COMMAND_TABLE_GENERATED
+         /*
+         ** The Get_Attribute entries of the instance are adjacent.
+         */
+         break;
+#else
+         continue;
+#endif
+      }
+
+      fFound = TRUE;
+
+      /*
+      ** Attribute number and size, followed by the data.
+      */
+      if( ABCC_GetMaxMessageSize() - iOffset < ABP_UINT8_SIZEOF + ABP_UINT16_SIZEOF )
+      {
+         eErrorCode = ABP_ERR_NO_RESOURCES;
+         break;
+      }
+      eErrorCode = GetAttributeData( psReceivedCommandMsg, psEntry,
+                                     (UINT16)( iOffset + ABP_UINT8_SIZEOF + ABP_UINT16_SIZEOF ),
+                                     &iSize );
+      if( eErrorCode != ABP_ERR_NO_ERROR )
+      {
+         break;
+      }
+      ABCC_SetMsgData8( psReceivedCommandMsg, psEntry->uCmdExt.bAttr, iOffset );
+      ABCC_SetMsgData16( psReceivedCommandMsg, iSize, (UINT16)( iOffset + ABP_UINT8_SIZEOF ) );
+      iOffset = (UINT16)( iOffset + ABP_UINT8_SIZEOF + ABP_UINT16_SIZEOF + iSize );
+   }
+
+   if( !fFound )
+   {
+      return( FALSE );
+   }
+
+   if( eErrorCode == ABP_ERR_NO_ERROR )
+   {
+      ABP_SetMsgResponse( psReceivedCommandMsg, iOffset );
+   }
+   else
+   {
+      ABP_SetMsgErrorResponse( psReceivedCommandMsg, 1, eErrorCode );
+   }
+   return( TRUE );
+}
+#endif
+
+/*------------------------------------------------------------------------------
+** Checks the data size of a Set_Attribute command for a scalar attribute and
+** sets up an error response if it does not match.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psReceivedCommandMsg - Set_Attribute command.
+**    iSize                - Size of the attribute in octets.
+**
+** Returns:
+**    TRUE if the data size matches the attribute.
+**------------------------------------------------------------------------------
+*/
+static BOOL SetDataSizeValid( ABP_MsgType* psReceivedCommandMsg, UINT16 iSize )
+{
+   if( ABCC_GetMsgDataSize( psReceivedCommandMsg ) > iSize )
+   {
+      ABP_SetMsgErrorResponse( psReceivedCommandMsg, 1, ABP_ERR_TOO_MUCH_DATA );
+      return( FALSE );
+   }
+   if( ABCC_GetMsgDataSize( psReceivedCommandMsg ) < iSize )
+   {
+      ABP_SetMsgErrorResponse( psReceivedCommandMsg, 1, ABP_ERR_NOT_ENOUGH_DATA );
+      return( FALSE );
+   }
+   return( TRUE );
 }
 
 static void SetAttributeHandler( ABP_MsgType* psReceivedCommandMsg, const Command_Handler_Lookup_Type* psEntry )
@@ -255,8 +1237,23 @@ static void SetAttributeHandler( ABP_MsgType* psReceivedCommandMsg, const Comman
    case SERVICE_UINT8:
    {
       UINT8 bValue = 0;
+      if( !SetDataSizeValid( psReceivedCommandMsg, ABP_UINT8_SIZEOF ) )
+      {
+         return;
+      }
       ABCC_GetMsgData8( psReceivedCommandMsg, &bValue, 0 );
-      psEntry->uCbx.pnSetUint8Attr( bValue );
+      if( psEntry->eServiceTag == SERVICE_BOOL8 )
+      {
+         psEntry->uCbx.pnSetBool8Attr( (BOOL8)bValue );
+      }
+      else if( psEntry->eServiceTag == SERVICE_INT8 )
+      {
+         psEntry->uCbx.pnSetInt8Attr( (INT8)bValue );
+      }
+      else
+      {
+         psEntry->uCbx.pnSetUint8Attr( bValue );
+      }
       ABP_SetMsgResponse( psReceivedCommandMsg, 0 );
       return;
    }
@@ -264,20 +1261,87 @@ static void SetAttributeHandler( ABP_MsgType* psReceivedCommandMsg, const Comman
    case SERVICE_UINT16:
    {
       UINT16 iValue = 0;
+      if( !SetDataSizeValid( psReceivedCommandMsg, ABP_UINT16_SIZEOF ) )
+      {
+         return;
+      }
       ABCC_GetMsgData16( psReceivedCommandMsg, &iValue, 0 );
-      psEntry->uCbx.pnSetUint16Attr( iValue );
+      if( psEntry->eServiceTag == SERVICE_INT16 )
+      {
+         psEntry->uCbx.pnSetInt16Attr( (INT16)iValue );
+      }
+      else
+      {
+         psEntry->uCbx.pnSetUint16Attr( iValue );
+      }
       ABP_SetMsgResponse( psReceivedCommandMsg, 0 );
       return;
    }
    case SERVICE_INT32:
    case SERVICE_UINT32:
+   case SERVICE_FLOAT:
    {
       UINT32 lValue = 0;
+      if( !SetDataSizeValid( psReceivedCommandMsg, ABP_UINT32_SIZEOF ) )
+      {
+         return;
+      }
       ABCC_GetMsgData32( psReceivedCommandMsg, &lValue, 0 );
-      psEntry->uCbx.pnSetUint32Attr( lValue );
+      if( psEntry->eServiceTag == SERVICE_FLOAT )
+      {
+         FLOAT32 rValue;
+         ABCC_PORT_Copy32( &rValue, 0, &lValue, 0 );
+         psEntry->uCbx.pnSetFloatAttr( rValue );
+      }
+      else if( psEntry->eServiceTag == SERVICE_INT32 )
+      {
+         psEntry->uCbx.pnSetInt32Attr( (INT32)lValue );
+      }
+      else
+      {
+         psEntry->uCbx.pnSetUint32Attr( lValue );
+      }
+      ABP_SetMsgResponse( psReceivedCommandMsg, 0 );
+      return;
+   }
+#if( ABCC_CFG_64BIT_ADI_SUPPORT_ENABLED )
+   case SERVICE_UINT64:
+   case SERVICE_INT64:
+   {
+      UINT64 l64Value;
+      if( !SetDataSizeValid( psReceivedCommandMsg, ABP_UINT64_SIZEOF ) )
+      {
+         return;
+      }
+      ABCC_PORT_Copy64( &l64Value, 0, ABCC_GetMsgDataPtr( psReceivedCommandMsg ), 0 );
+      SwapElements( &l64Value, 0, ABP_UINT64_SIZEOF, ABP_UINT64_SIZEOF );
+      if( psEntry->eServiceTag == SERVICE_INT64 )
+      {
+         psEntry->uCbx.pnSetInt64Attr( (INT64)l64Value );
+      }
+      else
+      {
+         psEntry->uCbx.pnSetUint64Attr( l64Value );
+      }
+      ABP_SetMsgResponse( psReceivedCommandMsg, 0 );
+      return;
+   }
+#endif
+#if( ABCC_CFG_DOUBLE_ADI_SUPPORT_ENABLED )
+   case SERVICE_DOUBLE:
+   {
+      FLOAT64 dValue;
+      if( !SetDataSizeValid( psReceivedCommandMsg, ABP_DOUBLE_SIZEOF ) )
+      {
+         return;
+      }
+      ABCC_PORT_Copy64( &dValue, 0, ABCC_GetMsgDataPtr( psReceivedCommandMsg ), 0 );
+      SwapElements( &dValue, 0, ABP_DOUBLE_SIZEOF, ABP_DOUBLE_SIZEOF );
+      psEntry->uCbx.pnSetDoubleAttr( dValue );
       ABP_SetMsgResponse( psReceivedCommandMsg, 0 );
       return;
    }
+#endif
    case SERVICE_STR:
       psEntry->uCbx.pnSetStrAttr(
          (char*)ABCC_GetMsgDataPtr( psReceivedCommandMsg ),
@@ -285,16 +1349,44 @@ static void SetAttributeHandler( ABP_MsgType* psReceivedCommandMsg, const Comman
       ABP_SetMsgResponse( psReceivedCommandMsg, 0 );
       return;
    case SERVICE_BUFFER:
+   case SERVICE_UINT16_ARRAY:
+   case SERVICE_INT16_ARRAY:
+   case SERVICE_UINT32_ARRAY:
+   case SERVICE_INT32_ARRAY:
+   case SERVICE_FLOAT_ARRAY:
+   case SERVICE_UINT64_ARRAY:
+   case SERVICE_INT64_ARRAY:
+   case SERVICE_DOUBLE_ARRAY:
+      if( ( psEntry->eServiceTag != SERVICE_BUFFER ) &&
+          ( ArrayElementSize( psEntry->eServiceTag ) == 0 ) )
+      {
+         break;
+      }
+      SwapElements( ABCC_GetMsgDataPtr( psReceivedCommandMsg ), 0,
+                    ABCC_GetMsgDataSize( psReceivedCommandMsg ),
+                    ArrayElementSize( psEntry->eServiceTag ) );
       psEntry->uCbx.pnSetArrAttr(
          ABCC_GetMsgDataPtr( psReceivedCommandMsg ),
          ABCC_GetMsgDataSize( psReceivedCommandMsg ) );
+#if ABCC_API_DEFERRED_RESP_MAX
+      if( appl_fRespDeferred )
+      {
+         /*
+         ** Back to network byte order for the next call of the callback.
+         */
+         SwapElements( ABCC_GetMsgDataPtr( psReceivedCommandMsg ), 0,
+                       ABCC_GetMsgDataSize( psReceivedCommandMsg ),
+                       ArrayElementSize( psEntry->eServiceTag ) );
+      }
+#endif
       ABP_SetMsgResponse( psReceivedCommandMsg, 0 );
       return;
    default:
-     ABP_SetMsgErrorResponse( psReceivedCommandMsg, 1, ABP_ERR_GENERAL_ERROR );
-     ABCC_LOG_ERROR( ABCC_EC_UNSUPPORTED_DATA_TYPE, (UINT32)psEntry->eServiceTag, "Unsupported Set_Attribute datatype.\n" );
      break;
    }
+
+   ABP_SetMsgErrorResponse( psReceivedCommandMsg, 1, ABP_ERR_GENERAL_ERROR );
+   ABCC_LOG_ERROR( ABCC_EC_UNSUPPORTED_DATA_TYPE, (UINT32)psEntry->eServiceTag, "Unsupported Set_Attribute datatype.\n" );
 }
 
 static BOOL ObjectSpecificHandler( ABP_MsgType* psReceivedCommandMsg, const Command_Handler_Lookup_Type* psEntry )
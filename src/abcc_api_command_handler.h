@@ -11,11 +11,25 @@
 #define ABCC_API_CMD_HANDLER_H_
 
 #include "abcc_types.h"
+#include "abcc_config.h"
 #include "abp.h"
 #include "abcc_api_config.h"
 
 /*------------------------------------------------------------------------------
 ** Definitions and prototypes for attribute lookup table.
+**
+** The handler converts the values of the typed services between host and
+** network byte order. The elements of the typed arrays are passed to and from
+** the array callbacks (and given as constants) in host byte order, while a
+** SERVICE_BUFFER is passed on as it is. The 64-bit and DOUBLE services need
+** ABCC_CFG_64BIT_ADI_SUPPORT_ENABLED and ABCC_CFG_DOUBLE_ADI_SUPPORT_ENABLED,
+** and their scalars are only served by callbacks.
+**
+** The buffers passed to the array and string callbacks point into the message
+** data and need not be aligned for the element type, e.g. the data of a record
+** in a ABCC_API_GET_ALL_ATTR_CMD response follows a three-octet header. Typed
+** elements must be accessed with ABCC_PORT_Copy16/32/64() or memcpy(), not
+** through a cast pointer.
 **------------------------------------------------------------------------------
 */
 enum ABCC_ATTR_SERVICE_TAG
@@ -29,6 +43,18 @@ enum ABCC_ATTR_SERVICE_TAG
    SERVICE_INT32,
    SERVICE_STR,
    SERVICE_BUFFER, // Array and struct
+   SERVICE_FLOAT,
+   SERVICE_UINT64,
+   SERVICE_INT64,
+   SERVICE_DOUBLE,
+   SERVICE_UINT16_ARRAY,
+   SERVICE_INT16_ARRAY,
+   SERVICE_UINT32_ARRAY,
+   SERVICE_INT32_ARRAY,
+   SERVICE_FLOAT_ARRAY,
+   SERVICE_UINT64_ARRAY,
+   SERVICE_INT64_ARRAY,
+   SERVICE_DOUBLE_ARRAY,
 };
 
 typedef BOOL8 (*ABCC_BOOL8_Get_AttrFuncType) (void);
@@ -38,6 +64,14 @@ typedef UINT16(*ABCC_UINT16_Get_AttrFuncType)(void);
 typedef INT16 (*ABCC_INT16_Get_AttrFuncType) (void);
 typedef UINT32(*ABCC_UINT32_Get_AttrFuncType)(void);
 typedef INT32 (*ABCC_INT32_Get_AttrFuncType) (void);
+typedef FLOAT32(*ABCC_FLOAT_Get_AttrFuncType)(void);
+#if( ABCC_CFG_64BIT_ADI_SUPPORT_ENABLED )
+typedef UINT64(*ABCC_UINT64_Get_AttrFuncType)(void);
+typedef INT64 (*ABCC_INT64_Get_AttrFuncType) (void);
+#endif
+#if( ABCC_CFG_DOUBLE_ADI_SUPPORT_ENABLED )
+typedef FLOAT64(*ABCC_DOUBLE_Get_AttrFuncType)(void);
+#endif
 typedef UINT16(*ABCC_STR_Get_AttrFuncType)   (char* pcPackedStrDest, UINT16 iBuffSizeBytes);
 typedef UINT16(*ABCC_ARR_Get_AttrFuncType)   (void* pvPackedArrDest, UINT16 iBuffSizeBytes);
 
@@ -48,6 +82,14 @@ typedef void (*ABCC_UINT16_Set_AttrFuncType)(UINT16);
 typedef void (*ABCC_INT16_Set_AttrFuncType) (INT16);
 typedef void (*ABCC_UINT32_Set_AttrFuncType)(UINT32);
 typedef void (*ABCC_INT32_Set_AttrFuncType) (INT32);
+typedef void (*ABCC_FLOAT_Set_AttrFuncType) (FLOAT32);
+#if( ABCC_CFG_64BIT_ADI_SUPPORT_ENABLED )
+typedef void (*ABCC_UINT64_Set_AttrFuncType)(UINT64);
+typedef void (*ABCC_INT64_Set_AttrFuncType) (INT64);
+#endif
+#if( ABCC_CFG_DOUBLE_ADI_SUPPORT_ENABLED )
+typedef void (*ABCC_DOUBLE_Set_AttrFuncType)(FLOAT64);
+#endif
 typedef void (*ABCC_STR_Set_AttrFuncType)   (char* pcPackedStrSrc, UINT16 iBuffSizeBytes);
 typedef void (*ABCC_ARR_Set_AttrFuncType)   (void* pvPackedArrSrc, UINT16 iSizeBytes);
 
@@ -59,16 +101,14 @@ typedef BOOL8(*ABCC_Get_Enum_String_AttrFuncType)(UINT8 bEnumValue, char* pcPack
 typedef BOOL8(*ABCC_APP_ResetReq_ObjFuncType)(ABP_ResetType);
 #endif
 
+/*------------------------------------------------------------------------------
+** Entry of the command handler lookup table. The members are ordered by size
+** to keep the padding down, and the command and service tag are stored in one
+** octet each: 16 octets per entry with 32-bit pointers instead of 24.
+**------------------------------------------------------------------------------
+*/
 typedef struct
 {
-   UINT8 bObject;
-   UINT8 bInstance;
-   union
-   {
-      UINT8 bAttr;
-   }uCmdExt;
-   UINT16 bCommand;
-   enum ABCC_ATTR_SERVICE_TAG eServiceTag;
    union
    {
       ABCC_BOOL8_Get_AttrFuncType       pnGetBool8Attr;
@@ -78,6 +118,14 @@ typedef struct
       ABCC_INT16_Get_AttrFuncType       pnGetInt16Attr;
       ABCC_UINT32_Get_AttrFuncType      pnGetUint32Attr;
       ABCC_INT32_Get_AttrFuncType       pnGetInt32Attr;
+      ABCC_FLOAT_Get_AttrFuncType       pnGetFloatAttr;
+#if( ABCC_CFG_64BIT_ADI_SUPPORT_ENABLED )
+      ABCC_UINT64_Get_AttrFuncType      pnGetUint64Attr;
+      ABCC_INT64_Get_AttrFuncType       pnGetInt64Attr;
+#endif
+#if( ABCC_CFG_DOUBLE_ADI_SUPPORT_ENABLED )
+      ABCC_DOUBLE_Get_AttrFuncType      pnGetDoubleAttr;
+#endif
       ABCC_STR_Get_AttrFuncType         pnGetStrAttr;
       ABCC_ARR_Get_AttrFuncType         pnGetArrAttr;
       ABCC_BOOL8_Set_AttrFuncType       pnSetBool8Attr;
@@ -87,6 +135,14 @@ typedef struct
       ABCC_INT16_Set_AttrFuncType       pnSetInt16Attr;
       ABCC_UINT32_Set_AttrFuncType      pnSetUint32Attr;
       ABCC_INT32_Set_AttrFuncType       pnSetInt32Attr;
+      ABCC_FLOAT_Set_AttrFuncType       pnSetFloatAttr;
+#if( ABCC_CFG_64BIT_ADI_SUPPORT_ENABLED )
+      ABCC_UINT64_Set_AttrFuncType      pnSetUint64Attr;
+      ABCC_INT64_Set_AttrFuncType       pnSetInt64Attr;
+#endif
+#if( ABCC_CFG_DOUBLE_ADI_SUPPORT_ENABLED )
+      ABCC_DOUBLE_Set_AttrFuncType      pnSetDoubleAttr;
+#endif
       ABCC_STR_Set_AttrFuncType         pnSetStrAttr;
       ABCC_ARR_Set_AttrFuncType         pnSetArrAttr;
       ABCC_Reset_ObjFuncType            pnResetObj;
@@ -105,6 +161,7 @@ typedef struct
       INT16  iSigned16;
       UINT32 lUnsigned32;
       INT32  lSigned32;
+      FLOAT32 rFloat;
       char*  pacString;
       char*  pacStringBuffer; // Arrays and structs
    }uData;
@@ -113,6 +170,110 @@ typedef struct
       UINT16 iMaxDataSize; // Max size (array & string)
       UINT16 iDataSize;    // Fixed size (structs)
    }uAttrLength;
+   UINT8 bObject;
+   UINT8 bInstance;
+   union
+   {
+      UINT8 bAttr;
+   }uCmdExt;
+   UINT8 bCommand;
+   UINT8 eServiceTag; // enum ABCC_ATTR_SERVICE_TAG
 }Command_Handler_Lookup_Type;
 
+#if ABCC_API_COMMAND_TABLE_GENERATED
+/*------------------------------------------------------------------------------
+** Key of an entry of the generated lookup table. The keys are kept in a
+** separate table in the same order as the entries, so a lookup only reads
+** four octets per compared entry, and the entry itself once it is found.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   UINT8 bObject;
+   UINT8 bInstance;
+   UINT8 bCommand;
+   UINT8 bAttr;
+}Command_Handler_Key_Type;
+
+/*------------------------------------------------------------------------------
+** Entries of an object in the generated, sorted lookup table:
+** command_handler_lookup_table[ iFirst ] up to, but not including, iEnd.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   UINT8  bObject;
+   UINT16 iFirst;
+   UINT16 iEnd;
+}Command_Handler_Object_Type;
+#endif
+
+#if ABCC_API_COMMAND_RESPONSE_CACHE_SIZE
+/*------------------------------------------------------------------------------
+** Encodes the Get_Attribute responses of the constant entries of the lookup
+** table into the response cache. Called when the driver is initialised.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+**
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+void ABCC_API_CommandResponseCacheBuild( void );
+#endif
+
+#if ABCC_API_DEFERRED_RESP_MAX
+/*------------------------------------------------------------------------------
+** Forgets all deferred commands. Called when the CompactCom is (re)started,
+** since their message buffers are gone with the driver.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+**
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+void ABCC_API_DeferredRespInit( void );
+
+/*------------------------------------------------------------------------------
+** Answers the deferred commands that are ready, failed or timed out.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+**
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+void ABCC_API_DeferredRespRun( void );
+
+/*------------------------------------------------------------------------------
+** Time until ABCC_API_DeferredRespRun() has a response to send. Used by
+** ABCC_API_RunUntilEvent() to limit its wait.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+**
+** Returns:
+**    0 if a deferred command has been completed or has timed out, otherwise
+**    the time until the next one times out, 0xFFFFFFFF if none is deferred.
+**------------------------------------------------------------------------------
+*/
+UINT32 ABCC_API_DeferredRespNextRunMs( void );
+
+/*------------------------------------------------------------------------------
+** Counts down the timeouts of the deferred commands.
+**------------------------------------------------------------------------------
+** Arguments:
+**    iDeltaTimeMs - Milliseconds since last call.
+**
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+void ABCC_API_DeferredRespRunTimer( INT16 iDeltaTimeMs );
+#endif
+
 #endif
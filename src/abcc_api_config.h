@@ -63,6 +63,91 @@
     #define ABCC_API_COMMAND_MESSAGE_HOOK_ENABLED 0
 #endif
 
+/*------------------------------------------------------------------------------
+** #define ABCC_API_COMMAND_TABLE_GENERATED   1 - Enable / 0 - Disable
+**
+** Use the command handler lookup table generated at build time by
+** tools/abcc_api_command_table.py instead of ABCC_API_COMMAND_RESPONSE_LIST.
+** The generated table is sorted, so the entries of a command are found with
+** binary searches instead of scanning the whole table. The searches compare a
+** separate table of four-octet keys and only read the matching entry. This key
+** table exists only for the generated table; ABCC_API_COMMAND_RESPONSE_LIST
+** keeps the linear scan over the entries themselves.
+**
+** Set by abcc-driver-api.cmake and abcc-driver-api.mk when
+** ABCC_API_COMMAND_TABLE_DESC names the object description file.
+**------------------------------------------------------------------------------
+*/
+#ifndef ABCC_API_COMMAND_TABLE_GENERATED
+    #define ABCC_API_COMMAND_TABLE_GENERATED 0
+#endif
+
+/*------------------------------------------------------------------------------
+** #define ABCC_API_COMMAND_RESPONSE_CACHE_SIZE   Size in octets / 0 - Disable
+**
+** Size of the cache for the Get_Attribute responses of the constant entries of
+** the command handler lookup table (entries without a callback). The responses
+** are encoded into the cache when the driver is initialised, and a matching
+** request is then answered by copying them into the message buffer.
+**
+** The value of a constant entry is read once, when the driver is initialised
+** (ABCC_API_INIT). When the cache is enabled, data referred to by a constant
+** entry (e.g. a string or buffer given to a ..._GET_VALUE macro) must NOT change
+** after that, until the next initialisation. A change is not seen by the
+** network, which keeps getting the cached value. Use a callback entry for
+** such data. Entries that do not fit in the cache are answered as usual.
+** Costs two octets of RAM per table entry on top of the cache itself.
+**------------------------------------------------------------------------------
+*/
+#ifndef ABCC_API_COMMAND_RESPONSE_CACHE_SIZE
+    #define ABCC_API_COMMAND_RESPONSE_CACHE_SIZE 0
+#endif
+
+/*------------------------------------------------------------------------------
+** #define ABCC_API_GET_ALL_ATTR_CMD   Command code / 0 - Disable
+**
+** Object specific command code (0x10 - 0x30) answered by the command handler
+** with all gettable attributes of the addressed host object instance, read
+** from the command handler lookup table. Each attribute is serialized as its
+** attribute number (UINT8), the size of its data (UINT16) and the data, in
+** attribute order for a generated table and in table order otherwise. The
+** records are packed, so the data handed to an array callback is generally
+** not aligned (see abcc_api_command_handler.h).
+**
+** The request is rejected with ABP_ERR_NO_RESOURCES if the attributes do not
+** fit in ABCC_GetMaxMessageSize() octets. The code must not be used by an
+** object specific command of the host objects.
+**------------------------------------------------------------------------------
+*/
+#ifndef ABCC_API_GET_ALL_ATTR_CMD
+    #define ABCC_API_GET_ALL_ATTR_CMD 0
+#endif
+
+/*------------------------------------------------------------------------------
+** #define ABCC_API_DEFERRED_RESP_MAX   Number of commands (1 - 255) / 0 - Disable
+**
+** Number of commands to host objects whose responses a callback of the command
+** handler lookup table may defer with ABCC_API_DeferResponse(), e.g. while
+** slow I/O is done. Each deferred command keeps its message buffer until it is
+** answered.
+**------------------------------------------------------------------------------
+*/
+#ifndef ABCC_API_DEFERRED_RESP_MAX
+    #define ABCC_API_DEFERRED_RESP_MAX 0
+#endif
+
+/*------------------------------------------------------------------------------
+** #define ABCC_API_DEFERRED_RESP_TIMEOUT_MS   Time in ms
+**
+** Time a deferred command may wait for ABCC_API_DeferredRespReady() or
+** ABCC_API_DeferredRespError() before it is answered with
+** ABP_ERR_GENERAL_ERROR.
+**------------------------------------------------------------------------------
+*/
+#ifndef ABCC_API_DEFERRED_RESP_TIMEOUT_MS
+    #define ABCC_API_DEFERRED_RESP_TIMEOUT_MS 1000
+#endif
+
 /*------------------------------------------------------------------------------
 ** Define this to be notified about error events reported by the driver. If the
 ** severity is of type ABCC_LOG_SEVERITY_FATAL the driver will get stuck in
@@ -89,6 +174,61 @@
 **------------------------------------------------------------------------------
 */
 
+/*------------------------------------------------------------------------------
+** Define these in abcc_driver_config.h to let ABCC_API_RunUntilEvent() sleep
+** until there is something to do, instead of calling ABCC_API_Run() in a busy
+** loop. Only used when ABCC_CFG_INT_ENABLED is set.
+**
+** ABCC_API_CONFIG_EVENT_WAIT( lTimeoutMs ) shall block until
+** ABCC_API_CONFIG_EVENT_SIGNAL() has been called, or until lTimeoutMs has
+** passed. A signal given while nobody is waiting must be remembered and make
+** the next wait return at once, e.g. an eventfd or a binary semaphore, a
+** futex on a counter, an RTOS event group, or a condition variable with a
+** flag. ABCC_API_CONFIG_EVENT_SIGNAL() is called from ABCC_CbfEvent(), i.e.
+** possibly from interrupt context.
+**
+** Only events enabled in ABCC_CFG_INT_ENABLE_MASK wake up the wait, anything
+** else the driver polls for is handled when the wait times out.
+**
+** Example:
+** #define ABCC_API_CONFIG_EVENT_WAIT( lTimeoutMs ) \
+** Example_AbccEventWait( lTimeoutMs )
+** #define ABCC_API_CONFIG_EVENT_SIGNAL() \
+** Example_AbccEventSignal()
+**
+** The Example_AbccEventWait and Example_AbccEventSignal function definitions
+** are then implemented by the user.
+**------------------------------------------------------------------------------
+*/
+
+/*------------------------------------------------------------------------------
+** Define this in abcc_driver_config.h to enable ABCC_API_RunCycle(), which
+** runs the ABCC handler with a time budget per control cycle. The function
+** shall return a free running microsecond counter, wrapping around at 2^32.
+**
+** Example:
+** #define ABCC_API_CONFIG_GET_TIME_US() Example_GetTimeUs()
+**
+** Optionally define ABCC_API_CONFIG_CYCLE_OVERRUN_NOTIFY to be notified when
+** a cycle took longer than the cycle period.
+**
+** Example:
+** #define ABCC_API_CONFIG_CYCLE_OVERRUN_NOTIFY( lElapsedUs, lPeriodUs ) \
+** Example_CycleOverrunNotify( lElapsedUs, lPeriodUs )
+**
+** The Example_GetTimeUs and Example_CycleOverrunNotify function definitions
+** are then implemented by the user.
+**
+** ABCC_API_CYCLE_MARGIN_US is the part of the cycle period that
+** ABCC_API_RunCycle() keeps free for work that can not be deferred, e.g.
+** ABCC_RunDriver(). Deferrable message work is only started while less than
+** (cycle period - ABCC_API_CYCLE_MARGIN_US) has passed since the cycle start.
+**------------------------------------------------------------------------------
+*/
+#ifndef ABCC_API_CYCLE_MARGIN_US
+   #define ABCC_API_CYCLE_MARGIN_US                ( 100 )
+#endif
+
 /*******************************************************************************
 ** Object configuration macros
 ********************************************************************************
@@ -183,6 +323,216 @@
    #define ANB_FSI_MAX_CONCURRENT_OPERATIONS       ( 4 )
 #endif
 
+/*------------------------------------------------------------------------------
+** The max. number of FSI commands waiting to be sent when no FSI operation or
+** message buffer is available. Queued commands are sent from ABCC_API_Run().
+** One entry more than this is allocated. Each entry holds a copy of the path
+** names of the command, i.e. up to two times ABP_FSI_MAX_PATH_LENGTH octets
+** of static memory. FileWrite data is kept in ANB_FSI_WRITE_BUFFERS instead.
+**------------------------------------------------------------------------------
+*/
+#ifndef ANB_FSI_CMD_QUEUE_SIZE
+   #define ANB_FSI_CMD_QUEUE_SIZE                  ( 2 )
+#endif
+
+/*------------------------------------------------------------------------------
+** The max. number of FSI FileWrite commands that are queued or waiting for a
+** response. The data of each one is copied to a buffer of
+** ABCC_CFG_MAX_MSG_SIZE octets. Should be at least
+** ABCC_API_FW_UPDATE_PIPELINE_DEPTH when the firmware update is used.
+**------------------------------------------------------------------------------
+*/
+#ifndef ANB_FSI_WRITE_BUFFERS
+   #define ANB_FSI_WRITE_BUFFERS                   ( 2 )
+#endif
+
+/*------------------------------------------------------------------------------
+** Message scheduling between control sequences started by the ABCC handler
+** (user init, address/baud rate/comm settings updates, exception read) and
+** bulk FSI commands.
+**
+** ABCC_API_MSG_CONTROL_QUOTA      - Max. number of control sequences in
+**                                   flight. Further sequences wait in a queue
+**                                   of ABCC_API_MSG_CONTROL_QUEUE_SIZE entries.
+**                                   A sequence that does not fit in the queue
+**                                   is aborted.
+** ABCC_API_MSG_BULK_QUOTA         - Max. number of FSI commands in flight.
+**                                   This bounds how many command buffers a
+**                                   control sequence can find occupied by file
+**                                   traffic, keep it below the number of
+**                                   command buffers in the driver.
+** ABCC_API_MSG_BULK_MAX_WAIT_MS   - FSI commands are held back while control
+**                                   sequences are active. After waiting this
+**                                   long one FSI command is let through anyway.
+**------------------------------------------------------------------------------
+*/
+#ifndef ABCC_API_MSG_CONTROL_QUOTA
+   #define ABCC_API_MSG_CONTROL_QUOTA              ( 4 )
+#endif
+
+#ifndef ABCC_API_MSG_CONTROL_QUEUE_SIZE
+   #define ABCC_API_MSG_CONTROL_QUEUE_SIZE         ( 4 )
+#endif
+
+#ifndef ABCC_API_MSG_BULK_QUOTA
+   #define ABCC_API_MSG_BULK_QUOTA                 ( 2 )
+#endif
+
+#ifndef ABCC_API_MSG_BULK_MAX_WAIT_MS
+   #define ABCC_API_MSG_BULK_MAX_WAIT_MS           ( 50 )
+#endif
+
+/*------------------------------------------------------------------------------
+** Network configuration engine, see abcc_api_network_config.h.
+**
+** ABCC_API_NC_MAX_PARALLEL       - Max. number of network configuration
+**                                  commands in flight. Each one is a control
+**                                  sequence, see ABCC_API_MSG_CONTROL_QUOTA.
+** ABCC_API_NC_READ_BACK_ENABLE   - Read settings the CompactCom keeps in
+**                                  non-volatile memory before writing them,
+**                                  and only write them if they differ. Costs
+**                                  a get command per such setting on a cold
+**                                  start, saves writes to non-volatile memory
+**                                  when nothing has changed. Written values
+**                                  are also read back to verify them.
+**                                  Disabled by default, every setting is then
+**                                  written without reading it first.
+** ABCC_API_NC_HOST_NAME_MAX_LEN  - Max. length of the host name, see
+**                                  ABCC_API_SetIpSettings().
+**------------------------------------------------------------------------------
+*/
+#ifndef ABCC_API_NC_MAX_PARALLEL
+   #define ABCC_API_NC_MAX_PARALLEL                ( ABCC_API_MSG_CONTROL_QUOTA )
+#endif
+
+#ifndef ABCC_API_NC_READ_BACK_ENABLE
+   #define ABCC_API_NC_READ_BACK_ENABLE            ( 0 )
+#endif
+
+#ifndef ABCC_API_NC_HOST_NAME_MAX_LEN
+   #define ABCC_API_NC_HOST_NAME_MAX_LEN           ( 64 )
+#endif
+
+/*------------------------------------------------------------------------------
+** Diagnostic event manager, see diagnostic_event_manager.h.
+**
+** DI_MGR_MAX_EVENTS       - Max. number of diagnostic events tracked at a
+**                           time, raised or waiting to be deleted.
+** DI_MGR_HOLD_OFF_MS      - Time a cleared event must stay cleared before its
+**                           diagnostic instance is deleted.
+** DI_MGR_RATE_BURST       - Max. number of create/delete commands sent in a
+**                           burst.
+** DI_MGR_RATE_REFILL_MS   - Time for one more command to be allowed after a
+**                           burst.
+** DI_MGR_MAX_CMDS_PER_RUN - Max. number of create/delete commands sent per
+**                           ABCC_API_Run() call.
+**------------------------------------------------------------------------------
+*/
+#ifndef DI_MGR_MAX_EVENTS
+   #define DI_MGR_MAX_EVENTS                       ( 8 )
+#endif
+
+#ifndef DI_MGR_HOLD_OFF_MS
+   #define DI_MGR_HOLD_OFF_MS                      ( 200 )
+#endif
+
+#ifndef DI_MGR_RATE_BURST
+   #define DI_MGR_RATE_BURST                       ( 4 )
+#endif
+
+#ifndef DI_MGR_RATE_REFILL_MS
+   #define DI_MGR_RATE_REFILL_MS                   ( 50 )
+#endif
+
+#ifndef DI_MGR_MAX_CMDS_PER_RUN
+   #define DI_MGR_MAX_CMDS_PER_RUN                 ( 2 )
+#endif
+
+/*------------------------------------------------------------------------------
+** #define ABCC_API_POSIX_RT_ENABLE   1 - Enable / 0 - Disable
+**
+** Process data and messaging threads for POSIX hosts, see
+** abcc_api_posix_rt.h. Requires a POSIX threads implementation.
+**------------------------------------------------------------------------------
+*/
+#ifndef ABCC_API_POSIX_RT_ENABLE
+   #define ABCC_API_POSIX_RT_ENABLE                0
+#endif
+
+/*------------------------------------------------------------------------------
+** #define ABCC_API_DIAG_HISTORY_ENABLE   1 - Enable / 0 - Disable
+**
+** History of diagnostic events and CompactCom exceptions, see
+** abcc_api_diag_history.h. ABCC_API_DIAG_HISTORY_SIZE is the number of
+** entries kept, each one uses 12 octets of static memory. With
+** ANB_FSI_OBJ_ENABLE another ABCC_API_DIAG_HISTORY_EXPORT_MAX_SIZE octets are
+** used for saving the history to the CompactCom file system.
+**
+** The timestamps are milliseconds counted by ABCC_API_RunTimerSystem(). Define
+** ABCC_API_DIAG_HISTORY_TIMESTAMP() to a function returning a UINT32 to use
+** another time base, e.g. a real time clock.
+**------------------------------------------------------------------------------
+*/
+#ifndef ABCC_API_DIAG_HISTORY_ENABLE
+   #define ABCC_API_DIAG_HISTORY_ENABLE            0
+#endif
+#ifndef ABCC_API_DIAG_HISTORY_SIZE
+   #define ABCC_API_DIAG_HISTORY_SIZE              ( 32 )
+#endif
+
+/*------------------------------------------------------------------------------
+** #define ABCC_API_SYNC_PIPELINE_ENABLE   1 - Enable / 0 - Disable
+**
+** Process data pipeline for isochronous operation, see
+** abcc_api_sync_pipeline.h. Requires SYNC_OBJ_ENABLE. Uses six images of
+** ABCC_CFG_MAX_PROCESS_DATA_SIZE octets of static memory. If
+** ABCC_API_CONFIG_GET_TIME_US() is defined it is also called from the sync
+** interrupt and must be safe to call from there.
+**------------------------------------------------------------------------------
+*/
+#ifndef ABCC_API_SYNC_PIPELINE_ENABLE
+   #define ABCC_API_SYNC_PIPELINE_ENABLE           0
+#endif
+
+/*------------------------------------------------------------------------------
+** Number of FileWrite commands kept in flight when a firmware image is
+** transferred with ABCC_API_FirmwareUpdateFromBuffer() or
+** ABCC_API_FirmwareUpdateFromCallback(). Each one allocates one FSI transaction
+** and, when a read callback is used, one message sized buffer. Must not exceed
+** ANB_FSI_MAX_CONCURRENT_OPERATIONS.
+**------------------------------------------------------------------------------
+*/
+#ifndef ABCC_API_FW_UPDATE_PIPELINE_DEPTH
+   #define ABCC_API_FW_UPDATE_PIPELINE_DEPTH       ( 2 )
+#endif
+
+/*------------------------------------------------------------------------------
+** #define ANB_FSI_CHECKSUM_ENABLE   1 - Enable / 0 - Disable
+**
+** Incremental CRC32C/SHA-256 checksums of data transferred with
+** ANB_FSI_FileRead()/ANB_FSI_FileWrite(), and verify-after-write support via
+** ANB_FSI_FileVerify(). See anybus_file_system_interface_checksum.h.
+**
+** ANB_FSI_MAX_CHECKSUM_INSTANCES is the max. number of FSI instances that can
+** have a checksum context attached at the same time. ANB_FSI_FileVerify() uses
+** one of them while it is running.
+**
+** ANB_FSI_CRC32C_HW_ACCEL_ENABLE allows the CRC32C calculation to use the
+** SSE4.2 or ARMv8 CRC32 instructions when the compiler targets a CPU that has
+** them (__SSE4_2__ or __ARM_FEATURE_CRC32 defined). Otherwise a lookup table
+** is used.
+**------------------------------------------------------------------------------
+*/
+#ifndef ANB_FSI_CHECKSUM_ENABLE
+   #define ANB_FSI_CHECKSUM_ENABLE                 0
+#endif
+#ifndef ANB_FSI_MAX_CHECKSUM_INSTANCES
+   #define ANB_FSI_MAX_CHECKSUM_INSTANCES          ( 2 )
+#endif
+#ifndef ANB_FSI_CRC32C_HW_ACCEL_ENABLE
+   #define ANB_FSI_CRC32C_HW_ACCEL_ENABLE          1
+#endif
+
 /*------------------------------------------------------------------------------
 ** Application data Object (0xFE)
 ** This object is required and always enabled.
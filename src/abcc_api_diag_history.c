@@ -0,0 +1,473 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** History of diagnostic events and CompactCom exceptions. See
+** abcc_api_diag_history.h for a description.
+********************************************************************************
+*/
+
+#include "abcc_api_diag_history.h"
+
+#if ABCC_API_DIAG_HISTORY_ENABLE
+
+#include <string.h>
+
+#include "abcc.h"
+#include "abcc_log.h"
+#include "anybus_file_system_interface_object.h"
+
+/*******************************************************************************
+** Typedefs
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** One history entry, serialised by ABCC_API_DiagHistoryExport().
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   UINT32   lTimeMs;
+   UINT16   iInstance;
+   UINT8    bType;
+   UINT8    bValue1;
+   UINT8    bValue2;
+}
+appl_DiagHistEntryType;
+
+#if ANB_FSI_OBJ_ENABLE
+/*------------------------------------------------------------------------------
+** State of ABCC_API_DiagHistorySave().
+**------------------------------------------------------------------------------
+*/
+typedef enum
+{
+   DIAG_HIST_SAVE_STATE_NOT_STARTED,
+   DIAG_HIST_SAVE_STATE_CREATE_INSTANCE_WAIT_RSP,
+   DIAG_HIST_SAVE_STATE_FOPEN_WAIT_RSP,
+   DIAG_HIST_SAVE_STATE_FWRITE_WAIT_RSP,
+   DIAG_HIST_SAVE_STATE_FCLOSE_WAIT_RSP,
+   DIAG_HIST_SAVE_STATE_DELETE_INSTANCE_WAIT_RSP
+}
+appl_DiagHistSaveState;
+#endif
+
+/*******************************************************************************
+** Private Globals
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** The ring. appl_lDiagHistBeginCount is incremented before an entry is filled
+** in and appl_lDiagHistWriteCount after, which is what lets
+** ABCC_API_DiagHistoryExport() detect entries overwritten while copying.
+**------------------------------------------------------------------------------
+*/
+static appl_DiagHistEntryType appl_asDiagHist[ ABCC_API_DIAG_HISTORY_SIZE ];
+static volatile UINT32 appl_lDiagHistBeginCount = 0;
+static volatile UINT32 appl_lDiagHistWriteCount = 0;
+
+#ifndef ABCC_API_DIAG_HISTORY_TIMESTAMP
+static UINT32 appl_lDiagHistTimeMs = 0;
+#endif
+
+#if ANB_FSI_OBJ_ENABLE
+static appl_DiagHistSaveState appl_eDiagHistSaveState = DIAG_HIST_SAVE_STATE_NOT_STARTED;
+static ABCC_API_pnDiagHistorySaveCallback appl_pnDiagHistSaveCallback = NULL;
+static ABCC_ErrorCodeType appl_eDiagHistSaveResult = ABCC_EC_NO_ERROR;
+static UINT16 appl_iDiagHistSaveInstance = 0;
+static UINT16 appl_iDiagHistSaveSize = 0;
+static UINT16 appl_iDiagHistSaveOffset = 0;
+static UINT16 appl_iDiagHistSaveActSize = 0;
+static UINT32 appl_lDiagHistSaveFileSize = 0;
+static UINT8 appl_abDiagHistSaveData[ ABCC_API_DIAG_HISTORY_EXPORT_MAX_SIZE ];
+static char appl_acDiagHistSavePath[ ABP_FSI_MAX_PATH_LENGTH + 1 ];
+#endif
+
+/*******************************************************************************
+** Private Services
+********************************************************************************
+*/
+
+static void PutUint16Le( UINT8* pbDest, UINT16 iValue )
+{
+   pbDest[ 0 ] = (UINT8)iValue;
+   pbDest[ 1 ] = (UINT8)( iValue >> 8 );
+}
+
+static void PutUint32Le( UINT8* pbDest, UINT32 lValue )
+{
+   PutUint16Le( pbDest, (UINT16)lValue );
+   PutUint16Le( pbDest + 2, (UINT16)( lValue >> 16 ) );
+}
+
+#if ANB_FSI_OBJ_ENABLE
+
+static void FsiResponse( UINT16 iInstance, ABP_MsgErrorCodeType eMsgResult, UINT8 bFsiError );
+
+static void SaveFinish( void )
+{
+   ABCC_API_pnDiagHistorySaveCallback pnResultCallback;
+
+   appl_eDiagHistSaveState = DIAG_HIST_SAVE_STATE_NOT_STARTED;
+
+   pnResultCallback = appl_pnDiagHistSaveCallback;
+   appl_pnDiagHistSaveCallback = NULL;
+
+   if( pnResultCallback )
+   {
+      pnResultCallback( appl_eDiagHistSaveResult );
+   }
+}
+
+/*------------------------------------------------------------------------------
+** Send the next FileWrite, or close the file when everything is written.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    Error from the FSI object.
+**------------------------------------------------------------------------------
+*/
+static ABCC_ErrorCodeType SaveWriteNext( void )
+{
+   UINT16 iChunkSize;
+
+   if( appl_iDiagHistSaveOffset >= appl_iDiagHistSaveSize )
+   {
+      appl_eDiagHistSaveState = DIAG_HIST_SAVE_STATE_FCLOSE_WAIT_RSP;
+      return( ANB_FSI_FileClose( appl_iDiagHistSaveInstance,
+                                 &appl_lDiagHistSaveFileSize,
+                                 FsiResponse ) );
+   }
+
+   iChunkSize = appl_iDiagHistSaveSize - appl_iDiagHistSaveOffset;
+   if( iChunkSize > ABCC_CFG_MAX_MSG_SIZE )
+   {
+      iChunkSize = ABCC_CFG_MAX_MSG_SIZE;
+   }
+
+   appl_iDiagHistSaveActSize = 0;
+   appl_eDiagHistSaveState = DIAG_HIST_SAVE_STATE_FWRITE_WAIT_RSP;
+   return( ANB_FSI_FileWrite( appl_iDiagHistSaveInstance,
+                              &appl_abDiagHistSaveData[ appl_iDiagHistSaveOffset ],
+                              iChunkSize,
+                              &appl_iDiagHistSaveActSize,
+                              FsiResponse ) );
+}
+
+/*------------------------------------------------------------------------------
+** Record the first error of a save and clean up. An open file is closed
+** before the FSI instance is deleted.
+**------------------------------------------------------------------------------
+** Arguments:
+**    eResult - Error to report.
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+static void SaveAbort( ABCC_ErrorCodeType eResult )
+{
+   ABCC_ErrorCodeType eError = ABCC_EC_NO_ERROR;
+
+   if( appl_eDiagHistSaveResult == ABCC_EC_NO_ERROR )
+   {
+      appl_eDiagHistSaveResult = eResult;
+   }
+
+   switch( appl_eDiagHistSaveState )
+   {
+   case DIAG_HIST_SAVE_STATE_FWRITE_WAIT_RSP:
+      appl_eDiagHistSaveState = DIAG_HIST_SAVE_STATE_FCLOSE_WAIT_RSP;
+      eError = ANB_FSI_FileClose( appl_iDiagHistSaveInstance,
+                                  &appl_lDiagHistSaveFileSize,
+                                  FsiResponse );
+      break;
+
+   case DIAG_HIST_SAVE_STATE_FOPEN_WAIT_RSP:
+   case DIAG_HIST_SAVE_STATE_FCLOSE_WAIT_RSP:
+      appl_eDiagHistSaveState = DIAG_HIST_SAVE_STATE_DELETE_INSTANCE_WAIT_RSP;
+      eError = ANB_FSI_Delete( appl_iDiagHistSaveInstance, FsiResponse );
+      break;
+
+   default:
+      eError = ABCC_EC_INTERNAL_ERROR;
+      break;
+   }
+
+   if( eError != ABCC_EC_NO_ERROR )
+   {
+      SaveFinish();
+   }
+}
+
+static void FsiResponse( UINT16 iInstance, ABP_MsgErrorCodeType eMsgResult, UINT8 bFsiError )
+{
+   ABCC_ErrorCodeType eError = ABCC_EC_NO_ERROR;
+
+   if( appl_eDiagHistSaveState == DIAG_HIST_SAVE_STATE_NOT_STARTED )
+   {
+      /*
+      ** Response to a command sent before the save was failed by
+      ** ABCC_API_DiagHistoryModuleReset().
+      */
+      return;
+   }
+
+   if( eMsgResult != ABP_ERR_NO_ERROR )
+   {
+      ABCC_LOG_WARNING( ABCC_EC_RESP_MSG_E_BIT_SET,
+         (UINT32)eMsgResult,
+         "Diagnostic history save failed in state %d (FSI error: %u)\n",
+         (int)appl_eDiagHistSaveState,
+         (unsigned)bFsiError );
+
+      if( appl_eDiagHistSaveState == DIAG_HIST_SAVE_STATE_CREATE_INSTANCE_WAIT_RSP )
+      {
+         appl_eDiagHistSaveResult = ABCC_EC_INTERNAL_ERROR;
+         SaveFinish();
+      }
+      else if( appl_eDiagHistSaveState == DIAG_HIST_SAVE_STATE_DELETE_INSTANCE_WAIT_RSP )
+      {
+         SaveFinish();
+      }
+      else
+      {
+         SaveAbort( ABCC_EC_INTERNAL_ERROR );
+      }
+      return;
+   }
+
+   switch( appl_eDiagHistSaveState )
+   {
+   case DIAG_HIST_SAVE_STATE_CREATE_INSTANCE_WAIT_RSP:
+      appl_iDiagHistSaveInstance = iInstance;
+      appl_eDiagHistSaveState = DIAG_HIST_SAVE_STATE_FOPEN_WAIT_RSP;
+      eError = ANB_FSI_FileOpen( appl_iDiagHistSaveInstance,
+                                 appl_acDiagHistSavePath,
+                                 ABP_FSI_FILE_OPEN_WRITE_MODE,
+                                 FsiResponse );
+      break;
+
+   case DIAG_HIST_SAVE_STATE_FOPEN_WAIT_RSP:
+      eError = SaveWriteNext();
+      break;
+
+   case DIAG_HIST_SAVE_STATE_FWRITE_WAIT_RSP:
+      if( appl_iDiagHistSaveActSize == 0 )
+      {
+         eError = ABCC_EC_INTERNAL_ERROR;
+         break;
+      }
+      appl_iDiagHistSaveOffset += appl_iDiagHistSaveActSize;
+      eError = SaveWriteNext();
+      break;
+
+   case DIAG_HIST_SAVE_STATE_FCLOSE_WAIT_RSP:
+      if( ( appl_eDiagHistSaveResult == ABCC_EC_NO_ERROR ) &&
+          ( appl_lDiagHistSaveFileSize != appl_iDiagHistSaveSize ) )
+      {
+         appl_eDiagHistSaveResult = ABCC_EC_INTERNAL_ERROR;
+      }
+      appl_eDiagHistSaveState = DIAG_HIST_SAVE_STATE_DELETE_INSTANCE_WAIT_RSP;
+      eError = ANB_FSI_Delete( appl_iDiagHistSaveInstance, FsiResponse );
+      break;
+
+   case DIAG_HIST_SAVE_STATE_DELETE_INSTANCE_WAIT_RSP:
+      SaveFinish();
+      break;
+
+   default:
+      break;
+   }
+
+   if( eError != ABCC_EC_NO_ERROR )
+   {
+      SaveAbort( eError );
+   }
+}
+
+#endif /* ANB_FSI_OBJ_ENABLE */
+
+/*******************************************************************************
+** Public Services
+********************************************************************************
+*/
+
+void ABCC_API_DiagHistoryRecord( ABCC_API_DiagHistoryEntryType eType,
+                                 UINT8 bValue1,
+                                 UINT8 bValue2,
+                                 UINT16 iInstance )
+{
+   appl_DiagHistEntryType* psEntry;
+   UINT32                  lSeq;
+
+   lSeq = appl_lDiagHistWriteCount;
+   psEntry = &appl_asDiagHist[ lSeq % ABCC_API_DIAG_HISTORY_SIZE ];
+   appl_lDiagHistBeginCount = lSeq + 1;
+
+#ifdef ABCC_API_DIAG_HISTORY_TIMESTAMP
+   psEntry->lTimeMs = ABCC_API_DIAG_HISTORY_TIMESTAMP();
+#else
+   psEntry->lTimeMs = appl_lDiagHistTimeMs;
+#endif
+   psEntry->iInstance = iInstance;
+   psEntry->bType = (UINT8)eType;
+   psEntry->bValue1 = bValue1;
+   psEntry->bValue2 = bValue2;
+
+   appl_lDiagHistWriteCount = lSeq + 1;
+}
+
+UINT16 ABCC_API_DiagHistoryExport( UINT8* pbDest, UINT16 iMaxSize )
+{
+   const appl_DiagHistEntryType* psEntry;
+   UINT8*                        pbEntry;
+   UINT32                        lStart;
+   UINT32                        lEnd;
+   UINT32                        lSeq;
+   UINT32                        lFirstValid;
+   UINT32                        lCount;
+
+   if( ( pbDest == NULL ) || ( iMaxSize < ABCC_API_DIAG_HISTORY_HEADER_SIZE ) )
+   {
+      return( 0 );
+   }
+
+   lEnd = appl_lDiagHistWriteCount;
+   lStart = ( lEnd > ABCC_API_DIAG_HISTORY_SIZE ) ? ( lEnd - ABCC_API_DIAG_HISTORY_SIZE ) : 0;
+
+   lCount = (UINT32)( iMaxSize - ABCC_API_DIAG_HISTORY_HEADER_SIZE ) / ABCC_API_DIAG_HISTORY_ENTRY_SIZE;
+   if( ( lEnd - lStart ) > lCount )
+   {
+      lStart = lEnd - lCount;
+   }
+
+   pbEntry = &pbDest[ ABCC_API_DIAG_HISTORY_HEADER_SIZE ];
+   for( lSeq = lStart; lSeq < lEnd; lSeq++ )
+   {
+      psEntry = &appl_asDiagHist[ lSeq % ABCC_API_DIAG_HISTORY_SIZE ];
+
+      PutUint32Le( &pbEntry[ 0 ], psEntry->lTimeMs );
+      pbEntry[ 4 ] = psEntry->bType;
+      pbEntry[ 5 ] = psEntry->bValue1;
+      pbEntry[ 6 ] = psEntry->bValue2;
+      pbEntry[ 7 ] = 0;
+      PutUint16Le( &pbEntry[ 8 ], psEntry->iInstance );
+
+      pbEntry += ABCC_API_DIAG_HISTORY_ENTRY_SIZE;
+   }
+
+   /*
+   ** Entries recorded while copying overwrite the oldest ones, and the slot
+   ** of an entry being recorded right now may hold a mix of old and new
+   ** values. Drop everything that could have been affected.
+   */
+   lFirstValid = appl_lDiagHistBeginCount;
+   lFirstValid = ( lFirstValid > ABCC_API_DIAG_HISTORY_SIZE ) ? ( lFirstValid - ABCC_API_DIAG_HISTORY_SIZE ) : 0;
+   if( lFirstValid > lStart )
+   {
+      if( lFirstValid > lEnd )
+      {
+         lFirstValid = lEnd;
+      }
+
+      memmove( &pbDest[ ABCC_API_DIAG_HISTORY_HEADER_SIZE ],
+               &pbDest[ ABCC_API_DIAG_HISTORY_HEADER_SIZE + ( ( lFirstValid - lStart ) * ABCC_API_DIAG_HISTORY_ENTRY_SIZE ) ],
+               ( lEnd - lFirstValid ) * ABCC_API_DIAG_HISTORY_ENTRY_SIZE );
+      lStart = lFirstValid;
+   }
+
+   lCount = lEnd - lStart;
+
+   pbDest[ 0 ] = 'D';
+   pbDest[ 1 ] = 'H';
+   pbDest[ 2 ] = ABCC_API_DIAG_HISTORY_FORMAT_VERSION;
+   pbDest[ 3 ] = ABCC_API_DIAG_HISTORY_ENTRY_SIZE;
+   PutUint16Le( &pbDest[ 4 ], (UINT16)lCount );
+   PutUint32Le( &pbDest[ 6 ], lStart );
+
+   return( (UINT16)( ABCC_API_DIAG_HISTORY_HEADER_SIZE + ( lCount * ABCC_API_DIAG_HISTORY_ENTRY_SIZE ) ) );
+}
+
+void ABCC_API_DiagHistoryClear( void )
+{
+   appl_lDiagHistWriteCount = 0;
+   appl_lDiagHistBeginCount = 0;
+}
+
+#if ANB_FSI_OBJ_ENABLE
+ABCC_ErrorCodeType ABCC_API_DiagHistorySave( const char* pacFileName,
+                                             ABCC_API_pnDiagHistorySaveCallback pnResultCallback )
+{
+   ABCC_ErrorCodeType eError;
+   size_t             xNameLength;
+
+   if( appl_eDiagHistSaveState != DIAG_HIST_SAVE_STATE_NOT_STARTED )
+   {
+      return( ABCC_EC_INCORRECT_STATE );
+   }
+
+   if( pacFileName == NULL )
+   {
+      return( ABCC_EC_PARAMETER_NOT_VALID );
+   }
+
+   xNameLength = strlen( pacFileName );
+   if( ( xNameLength == 0 ) || ( xNameLength >= sizeof( appl_acDiagHistSavePath ) ) )
+   {
+      return( ABCC_EC_PARAMETER_NOT_VALID );
+   }
+
+   eError = ANB_FSI_Create( FsiResponse );
+   if( eError != ABCC_EC_NO_ERROR )
+   {
+      return( eError );
+   }
+
+   strncpy( appl_acDiagHistSavePath, pacFileName, sizeof( appl_acDiagHistSavePath ) );
+
+   appl_pnDiagHistSaveCallback = pnResultCallback;
+   appl_eDiagHistSaveResult = ABCC_EC_NO_ERROR;
+   appl_iDiagHistSaveInstance = 0;
+   appl_iDiagHistSaveOffset = 0;
+   appl_lDiagHistSaveFileSize = 0;
+   appl_iDiagHistSaveSize = ABCC_API_DiagHistoryExport( appl_abDiagHistSaveData,
+                                                        sizeof( appl_abDiagHistSaveData ) );
+   appl_eDiagHistSaveState = DIAG_HIST_SAVE_STATE_CREATE_INSTANCE_WAIT_RSP;
+
+   return( ABCC_EC_NO_ERROR );
+}
+#endif
+
+void ABCC_API_DiagHistoryModuleReset( void )
+{
+#if ANB_FSI_OBJ_ENABLE
+   /*
+   ** All FSI instances and outstanding commands are gone after a reset.
+   */
+   if( appl_eDiagHistSaveState != DIAG_HIST_SAVE_STATE_NOT_STARTED )
+   {
+      appl_eDiagHistSaveResult = ABCC_EC_INCORRECT_STATE;
+      SaveFinish();
+   }
+#endif
+
+   ABCC_API_DiagHistoryRecord( ABCC_API_DIAG_HIST_MODULE_INIT, 0, 0, 0 );
+}
+
+void ABCC_API_DiagHistoryRunTimer( const INT16 iDeltaTimeMs )
+{
+#ifndef ABCC_API_DIAG_HISTORY_TIMESTAMP
+   if( iDeltaTimeMs > 0 )
+   {
+      appl_lDiagHistTimeMs += (UINT32)iDeltaTimeMs;
+   }
+#else
+   (void)iDeltaTimeMs;
+#endif
+}
+
+#endif /* ABCC_API_DIAG_HISTORY_ENABLE */
@@ -0,0 +1,769 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Transfer of firmware images from the host to the CompactCom firmware
+** candidate area.
+********************************************************************************
+*/
+
+#include "abcc_api_firmware_update.h"
+
+#if ANB_FSI_OBJ_ENABLE
+
+#include "abcc.h"
+#include "abcc_api.h"
+#include "anybus_file_system_interface_object.h"
+#include "anybus_file_system_interface_checksum.h"
+
+/*******************************************************************************
+** Defines
+********************************************************************************
+*/
+
+#define ABCC_API_FW_UPDATE_DST_FOLDER "firmware"
+#define ABCC_API_FW_UPDATE_DST_FOLDER_FILENAME_OFFSET ( sizeof( ABCC_API_FW_UPDATE_DST_FOLDER "\\" ) - 1 )
+
+/*
+** Every FileWrite carries at most one message worth of data.
+*/
+#define ABCC_API_FW_UPDATE_CHUNK_SIZE ( ABCC_CFG_MAX_MSG_SIZE )
+
+#if ( ABCC_API_FW_UPDATE_PIPELINE_DEPTH < 1 ) || \
+    ( ABCC_API_FW_UPDATE_PIPELINE_DEPTH > ANB_FSI_MAX_CONCURRENT_OPERATIONS )
+#error "ABCC_API_FW_UPDATE_PIPELINE_DEPTH must be 1..ANB_FSI_MAX_CONCURRENT_OPERATIONS"
+#endif
+
+#if ABCC_API_FW_UPDATE_DEBUG_ENABLED
+#define ABCC_API_FW_UPDATE_DEBUG_PRINT( ... ) ABCC_LOG_DEBUG( __VA_ARGS__ )
+#else
+#define ABCC_API_FW_UPDATE_DEBUG_PRINT( ... )
+#endif
+
+/*******************************************************************************
+** Typedefs
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Firmware update state.
+**------------------------------------------------------------------------------
+*/
+typedef enum
+{
+   FW_UPDATE_STATE_NOT_STARTED,
+   FW_UPDATE_STATE_CREATE_INSTANCE_WAIT_RSP,
+   FW_UPDATE_STATE_FOPEN_WAIT_RSP,
+   FW_UPDATE_STATE_FWRITE_WAIT_RSP,
+   FW_UPDATE_STATE_FCLOSE_WAIT_RSP,
+   FW_UPDATE_STATE_VERIFY_WAIT_RSP,
+   FW_UPDATE_STATE_FDELETE_WAIT_RSP,
+   FW_UPDATE_STATE_DELETE_INSTANCE_WAIT_RSP
+}
+appl_FwUpdateState;
+
+/*------------------------------------------------------------------------------
+** One outstanding FileWrite. The CompactCom answers the writes of an instance
+** in order, so the slots are used as a FIFO.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   UINT16   iReqSize;
+   UINT16   iActSize;
+   UINT8*   pbData;
+   UINT8    abBuffer[ ABCC_API_FW_UPDATE_CHUNK_SIZE ]; /* Used with a read callback. */
+}
+appl_FwUpdateSlotType;
+
+/*******************************************************************************
+** Private Globals
+********************************************************************************
+*/
+static appl_FwUpdateState appl_eFwUpdateState = FW_UPDATE_STATE_NOT_STARTED;
+static ABCC_API_pnFwUpdateResultCallback appl_pnFwUpdateResultCallback = NULL;
+static ABCC_API_pnFwUpdateReadCallback appl_pnFwUpdateReadCallback = NULL;
+static const UINT8* appl_pbFwUpdateImage = NULL;
+static BOOL appl_fFwUpdateRestart = FALSE;
+static BOOL appl_fFwUpdateCleanupPending = FALSE;
+static BOOL appl_fFwUpdateCleanup = FALSE;
+static ABCC_ErrorCodeType appl_eFwUpdateResult = ABCC_EC_NO_ERROR;
+
+static UINT16 appl_iFwUpdateInstance = 0;
+static UINT32 appl_lFwUpdateSize = 0;
+static UINT32 appl_lFwUpdateSentOffset = 0;
+static UINT32 appl_lFwUpdateDoneOffset = 0;
+static UINT32 appl_lFwUpdateFileSize = 0;
+
+static appl_FwUpdateSlotType appl_asFwUpdateSlot[ ABCC_API_FW_UPDATE_PIPELINE_DEPTH ];
+static UINT8 appl_bFwUpdateSlotHead = 0;
+static UINT8 appl_bFwUpdateSlotCount = 0;
+
+static char appl_acFwUpdateDstPath[ ABP_FSI_MAX_PATH_LENGTH + 1 ] = ABCC_API_FW_UPDATE_DST_FOLDER "\\";
+
+#if ANB_FSI_CHECKSUM_ENABLE
+static ANB_FSI_ChecksumType appl_sFwUpdateChecksum;
+static UINT8 appl_abFwUpdateDigest[ ANB_FSI_CHECKSUM_MAX_DIGEST_SIZE ];
+#endif
+
+/*******************************************************************************
+** Private forward declaration
+********************************************************************************
+*/
+static void FsiObjectResponse( UINT16 iInstance, ABP_MsgErrorCodeType eMsgResult, UINT8 bFsiError );
+static void FileWriteResponse( UINT16 iInstance, ABP_MsgErrorCodeType eMsgResult, UINT8 bFsiError );
+#if ANB_FSI_CHECKSUM_ENABLE
+static void VerifyResponse( ABP_MsgErrorCodeType eMsgResult, UINT8 bFsiError, BOOL fMatch );
+#endif
+static void Abort( ABCC_ErrorCodeType eResult );
+static void Finish( void );
+
+/*******************************************************************************
+** Private Services
+********************************************************************************
+*/
+
+static void SetState( appl_FwUpdateState eState )
+{
+   appl_eFwUpdateState = eState;
+   ABCC_API_FW_UPDATE_DEBUG_PRINT( "Firmware update state %d\n", eState );
+}
+
+static BOOL SetupDstPath( const char* pacFileName )
+{
+   size_t xNameLength;
+
+   if( pacFileName == NULL )
+   {
+      return( FALSE );
+   }
+
+   xNameLength = strlen( pacFileName );
+   if( ( xNameLength == 0 ) ||
+       ( ( ABCC_API_FW_UPDATE_DST_FOLDER_FILENAME_OFFSET + xNameLength + 1 ) > sizeof( appl_acFwUpdateDstPath ) ) )
+   {
+      return( FALSE );
+   }
+
+   strncpy( &appl_acFwUpdateDstPath[ ABCC_API_FW_UPDATE_DST_FOLDER_FILENAME_OFFSET ],
+      pacFileName,
+      xNameLength + 1 );
+
+   return( TRUE );
+}
+
+/*------------------------------------------------------------------------------
+** Issue FileWrite commands until the pipeline is full or the whole image has
+** been sent. Running out of message buffers or FSI transaction entries is not
+** an error as long as at least one write is outstanding, the pipeline is then
+** refilled when the next response arrives.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    ABCC_EC_NO_ERROR, or the error that prevented the transfer from
+**    progressing.
+**------------------------------------------------------------------------------
+*/
+static ABCC_ErrorCodeType FillPipeline( void )
+{
+   ABCC_ErrorCodeType      eError;
+   appl_FwUpdateSlotType*  psSlot;
+   UINT32                  lRemaining;
+   UINT16                  iChunkSize;
+
+   while( ( appl_bFwUpdateSlotCount < ABCC_API_FW_UPDATE_PIPELINE_DEPTH ) &&
+          ( appl_lFwUpdateSentOffset < appl_lFwUpdateSize ) )
+   {
+      psSlot = &appl_asFwUpdateSlot[ ( appl_bFwUpdateSlotHead + appl_bFwUpdateSlotCount ) % ABCC_API_FW_UPDATE_PIPELINE_DEPTH ];
+
+      lRemaining = appl_lFwUpdateSize - appl_lFwUpdateSentOffset;
+      iChunkSize = ( lRemaining > ABCC_API_FW_UPDATE_CHUNK_SIZE ) ?
+                   ABCC_API_FW_UPDATE_CHUNK_SIZE : (UINT16)lRemaining;
+
+      if( appl_pbFwUpdateImage != NULL )
+      {
+         psSlot->pbData = (UINT8*)&appl_pbFwUpdateImage[ appl_lFwUpdateSentOffset ];
+      }
+      else
+      {
+         if( appl_pnFwUpdateReadCallback( appl_lFwUpdateSentOffset, psSlot->abBuffer, iChunkSize ) != iChunkSize )
+         {
+            ABCC_API_FW_UPDATE_DEBUG_PRINT( "Image read failed at offset %lu\n", (unsigned long)appl_lFwUpdateSentOffset );
+            return( ABCC_EC_PARAMETER_NOT_VALID );
+         }
+         psSlot->pbData = psSlot->abBuffer;
+      }
+
+      psSlot->iReqSize = iChunkSize;
+      psSlot->iActSize = 0;
+
+      eError = ANB_FSI_FileWrite( appl_iFwUpdateInstance,
+                                  psSlot->pbData,
+                                  iChunkSize,
+                                  &psSlot->iActSize,
+                                  FileWriteResponse );
+
+      if( eError != ABCC_EC_NO_ERROR )
+      {
+         if( ( appl_bFwUpdateSlotCount > 0 ) &&
+             ( ( eError == ABCC_EC_NO_RESOURCES ) ||
+               ( eError == ABCC_EC_OUT_OF_MSG_BUFFERS ) ) )
+         {
+            /*
+            ** The chunk is fetched again when the pipeline is refilled.
+            */
+            return( ABCC_EC_NO_ERROR );
+         }
+
+         return( eError );
+      }
+
+      appl_bFwUpdateSlotCount++;
+      appl_lFwUpdateSentOffset += iChunkSize;
+   }
+
+   return( ABCC_EC_NO_ERROR );
+}
+
+static ABCC_ErrorCodeType CloseFile( void )
+{
+   ABCC_ErrorCodeType eError;
+
+   eError = ANB_FSI_FileClose( appl_iFwUpdateInstance, &appl_lFwUpdateFileSize, FsiObjectResponse );
+
+   if( eError == ABCC_EC_NO_ERROR )
+   {
+      SetState( FW_UPDATE_STATE_FCLOSE_WAIT_RSP );
+   }
+
+   return( eError );
+}
+
+static ABCC_ErrorCodeType DeleteFile( void )
+{
+   ABCC_ErrorCodeType eError;
+
+   eError = ANB_FSI_FileDelete( appl_iFwUpdateInstance, appl_acFwUpdateDstPath, FsiObjectResponse );
+
+   if( eError == ABCC_EC_NO_ERROR )
+   {
+      SetState( FW_UPDATE_STATE_FDELETE_WAIT_RSP );
+   }
+
+   return( eError );
+}
+
+static ABCC_ErrorCodeType DeleteInstance( void )
+{
+   ABCC_ErrorCodeType eError;
+
+   eError = ANB_FSI_Delete( appl_iFwUpdateInstance, FsiObjectResponse );
+
+   if( eError == ABCC_EC_NO_ERROR )
+   {
+      SetState( FW_UPDATE_STATE_DELETE_INSTANCE_WAIT_RSP );
+   }
+
+   return( eError );
+}
+
+/*------------------------------------------------------------------------------
+** The image has been written and the file closed. Compare the size and start
+** the read back verification if checksums are available.
+**------------------------------------------------------------------------------
+*/
+static void FileClosed( void )
+{
+   if( appl_lFwUpdateFileSize != appl_lFwUpdateSize )
+   {
+      ABCC_API_FW_UPDATE_DEBUG_PRINT( "File size mismatch (%lu != %lu)\n",
+         (unsigned long)appl_lFwUpdateFileSize,
+         (unsigned long)appl_lFwUpdateSize );
+      Abort( ABCC_EC_INTERNAL_ERROR );
+      return;
+   }
+
+#if ANB_FSI_CHECKSUM_ENABLE
+   ANB_FSI_DetachChecksum( appl_iFwUpdateInstance );
+   (void)ANB_FSI_ChecksumFinal( &appl_sFwUpdateChecksum, appl_abFwUpdateDigest );
+
+   if( ANB_FSI_FileVerify( appl_iFwUpdateInstance,
+                           appl_acFwUpdateDstPath,
+                           ANB_FSI_CHECKSUM_CRC32C,
+                           appl_abFwUpdateDigest,
+                           VerifyResponse ) != ABCC_EC_NO_ERROR )
+   {
+      Abort( ABCC_EC_NO_RESOURCES );
+      return;
+   }
+
+   SetState( FW_UPDATE_STATE_VERIFY_WAIT_RSP );
+#else
+   if( DeleteInstance() != ABCC_EC_NO_ERROR )
+   {
+      Finish();
+   }
+#endif
+}
+
+#if ANB_FSI_CHECKSUM_ENABLE
+static void VerifyResponse( ABP_MsgErrorCodeType eMsgResult, UINT8 bFsiError, BOOL fMatch )
+{
+   (void)eMsgResult;
+   (void)bFsiError;
+
+   if( !fMatch )
+   {
+      ABCC_API_FW_UPDATE_DEBUG_PRINT( "Verification failed (error code %d, FSI error: %u)\n", eMsgResult, bFsiError );
+      Abort( ABCC_EC_INTERNAL_ERROR );
+      return;
+   }
+
+   if( DeleteInstance() != ABCC_EC_NO_ERROR )
+   {
+      Finish();
+   }
+}
+#endif
+
+/*------------------------------------------------------------------------------
+** Abort the transfer. Whatever has been written is removed from the candidate
+** area so that a partial or corrupt image is not installed on the next reset.
+**------------------------------------------------------------------------------
+** Arguments:
+**    eResult - Result to report.
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+static void Abort( ABCC_ErrorCodeType eResult )
+{
+   ABCC_ErrorCodeType eError;
+
+   if( appl_eFwUpdateResult == ABCC_EC_NO_ERROR )
+   {
+      appl_eFwUpdateResult = eResult;
+   }
+
+#if ANB_FSI_CHECKSUM_ENABLE
+   ANB_FSI_DetachChecksum( appl_iFwUpdateInstance );
+#endif
+
+   switch( appl_eFwUpdateState )
+   {
+   case FW_UPDATE_STATE_FWRITE_WAIT_RSP:
+      if( appl_bFwUpdateSlotCount > 0 )
+      {
+         /*
+         ** Close once the outstanding writes have been answered.
+         */
+         return;
+      }
+      eError = CloseFile();
+      break;
+
+   case FW_UPDATE_STATE_FCLOSE_WAIT_RSP:
+   case FW_UPDATE_STATE_VERIFY_WAIT_RSP:
+      eError = DeleteFile();
+      break;
+
+   case FW_UPDATE_STATE_FOPEN_WAIT_RSP:
+   case FW_UPDATE_STATE_FDELETE_WAIT_RSP:
+      eError = DeleteInstance();
+      break;
+
+   default:
+      eError = ABCC_EC_INTERNAL_ERROR;
+      break;
+   }
+
+   if( eError != ABCC_EC_NO_ERROR )
+   {
+      Finish();
+   }
+}
+
+static void Finish( void )
+{
+   ABCC_API_pnFwUpdateResultCallback pnResultCallback;
+   ABCC_ErrorCodeType eResult;
+
+   SetState( FW_UPDATE_STATE_NOT_STARTED );
+   appl_fFwUpdateCleanup = FALSE;
+
+   pnResultCallback = appl_pnFwUpdateResultCallback;
+   eResult = appl_eFwUpdateResult;
+   appl_pnFwUpdateResultCallback = NULL;
+
+   if( pnResultCallback )
+   {
+      pnResultCallback( eResult );
+   }
+
+   if( ( eResult == ABCC_EC_NO_ERROR ) && appl_fFwUpdateRestart )
+   {
+      ABCC_API_RestartForFirmwareUpdate();
+   }
+}
+
+static void FileWriteResponse( UINT16 iInstance, ABP_MsgErrorCodeType eMsgResult, UINT8 bFsiError )
+{
+   appl_FwUpdateSlotType* psSlot;
+   ABCC_ErrorCodeType     eError;
+
+   (void)iInstance;
+   (void)bFsiError;
+
+   psSlot = &appl_asFwUpdateSlot[ appl_bFwUpdateSlotHead ];
+   appl_bFwUpdateSlotHead = ( appl_bFwUpdateSlotHead + 1 ) % ABCC_API_FW_UPDATE_PIPELINE_DEPTH;
+   appl_bFwUpdateSlotCount--;
+
+   if( appl_eFwUpdateResult != ABCC_EC_NO_ERROR )
+   {
+      /*
+      ** Already aborting, drain the pipeline.
+      */
+      Abort( appl_eFwUpdateResult );
+      return;
+   }
+
+   /*
+   ** Later writes are already in flight, so a short write cannot be resent
+   ** without corrupting the file.
+   */
+   if( ( eMsgResult != ABP_ERR_NO_ERROR ) ||
+       ( psSlot->iActSize != psSlot->iReqSize ) )
+   {
+      ABCC_API_FW_UPDATE_DEBUG_PRINT( "Write failed (error code %d, FSI error: %u, %u of %u octets)\n",
+         eMsgResult, bFsiError, psSlot->iActSize, psSlot->iReqSize );
+      Abort( ABCC_EC_INTERNAL_ERROR );
+      return;
+   }
+
+   appl_lFwUpdateDoneOffset += psSlot->iActSize;
+
+   if( appl_lFwUpdateDoneOffset == appl_lFwUpdateSize )
+   {
+      eError = CloseFile();
+   }
+   else
+   {
+      eError = FillPipeline();
+   }
+
+   if( eError != ABCC_EC_NO_ERROR )
+   {
+      Abort( eError );
+   }
+}
+
+static void FsiObjectResponse( UINT16 iInstance, ABP_MsgErrorCodeType eMsgResult, UINT8 bFsiError )
+{
+   ABCC_ErrorCodeType eError = ABCC_EC_NO_ERROR;
+
+   (void)bFsiError;
+
+   if( eMsgResult != ABP_ERR_NO_ERROR )
+   {
+      ABCC_API_FW_UPDATE_DEBUG_PRINT( "Command failed with error code %d (FSI error: %u)\n", eMsgResult, bFsiError );
+
+      if( appl_eFwUpdateState == FW_UPDATE_STATE_CREATE_INSTANCE_WAIT_RSP )
+      {
+         appl_eFwUpdateResult = ABCC_EC_INTERNAL_ERROR;
+         Finish();
+      }
+      else if( appl_eFwUpdateState == FW_UPDATE_STATE_DELETE_INSTANCE_WAIT_RSP )
+      {
+         Finish();
+      }
+      else if( appl_eFwUpdateState == FW_UPDATE_STATE_FDELETE_WAIT_RSP )
+      {
+         if( DeleteInstance() != ABCC_EC_NO_ERROR )
+         {
+            Finish();
+         }
+      }
+      else
+      {
+         Abort( ABCC_EC_INTERNAL_ERROR );
+      }
+      return;
+   }
+
+   switch( appl_eFwUpdateState )
+   {
+   case FW_UPDATE_STATE_CREATE_INSTANCE_WAIT_RSP:
+      appl_iFwUpdateInstance = iInstance;
+      if( appl_fFwUpdateCleanup )
+      {
+         /*
+         ** Only remove what an interrupted transfer left behind.
+         */
+         eError = DeleteFile();
+         if( eError != ABCC_EC_NO_ERROR )
+         {
+            eError = DeleteInstance();
+         }
+         break;
+      }
+      eError = ANB_FSI_FileOpen( appl_iFwUpdateInstance,
+                                 appl_acFwUpdateDstPath,
+                                 ABP_FSI_FILE_OPEN_WRITE_MODE,
+                                 FsiObjectResponse );
+      if( eError == ABCC_EC_NO_ERROR )
+      {
+         SetState( FW_UPDATE_STATE_FOPEN_WAIT_RSP );
+      }
+      else
+      {
+         appl_eFwUpdateResult = eError;
+         eError = DeleteInstance();
+      }
+      break;
+
+   case FW_UPDATE_STATE_FOPEN_WAIT_RSP:
+#if ANB_FSI_CHECKSUM_ENABLE
+      ANB_FSI_ChecksumInit( &appl_sFwUpdateChecksum, ANB_FSI_CHECKSUM_CRC32C );
+      if( ANB_FSI_AttachChecksum( appl_iFwUpdateInstance, &appl_sFwUpdateChecksum ) != ABCC_EC_NO_ERROR )
+      {
+         appl_eFwUpdateResult = ABCC_EC_NO_RESOURCES;
+         eError = CloseFile();
+         break;
+      }
+#endif
+      SetState( FW_UPDATE_STATE_FWRITE_WAIT_RSP );
+      eError = FillPipeline();
+      if( eError != ABCC_EC_NO_ERROR )
+      {
+         Abort( eError );
+         eError = ABCC_EC_NO_ERROR;
+      }
+      break;
+
+   case FW_UPDATE_STATE_FCLOSE_WAIT_RSP:
+      if( appl_eFwUpdateResult != ABCC_EC_NO_ERROR )
+      {
+         eError = DeleteFile();
+      }
+      else
+      {
+         FileClosed();
+      }
+      break;
+
+   case FW_UPDATE_STATE_FDELETE_WAIT_RSP:
+      eError = DeleteInstance();
+      break;
+
+   case FW_UPDATE_STATE_DELETE_INSTANCE_WAIT_RSP:
+      Finish();
+      break;
+
+   default:
+      ABCC_API_FW_UPDATE_DEBUG_PRINT( "Unexpected response in state %d\n", appl_eFwUpdateState );
+      break;
+   }
+
+   if( eError != ABCC_EC_NO_ERROR )
+   {
+      if( appl_eFwUpdateResult == ABCC_EC_NO_ERROR )
+      {
+         appl_eFwUpdateResult = eError;
+      }
+      Finish();
+   }
+}
+
+static void Start( UINT32 lSize,
+                   BOOL fRestart,
+                   ABCC_API_pnFwUpdateResultCallback pnResultCallback )
+{
+   ABCC_ErrorCodeType eError;
+
+   appl_pnFwUpdateResultCallback = pnResultCallback;
+   appl_fFwUpdateRestart = fRestart;
+   appl_eFwUpdateResult = ABCC_EC_NO_ERROR;
+   appl_iFwUpdateInstance = 0;
+   appl_lFwUpdateSize = lSize;
+   appl_lFwUpdateSentOffset = 0;
+   appl_lFwUpdateDoneOffset = 0;
+   appl_lFwUpdateFileSize = 0;
+   appl_bFwUpdateSlotHead = 0;
+   appl_bFwUpdateSlotCount = 0;
+
+   eError = ANB_FSI_Create( FsiObjectResponse );
+   if( eError != ABCC_EC_NO_ERROR )
+   {
+      appl_eFwUpdateResult = eError;
+      Finish();
+      return;
+   }
+
+   SetState( FW_UPDATE_STATE_CREATE_INSTANCE_WAIT_RSP );
+}
+
+static BOOL CheckArgs( const char* pacFileName,
+                       UINT32 lSize,
+                       ABCC_API_pnFwUpdateResultCallback pnResultCallback )
+{
+   ABCC_ErrorCodeType eError = ABCC_EC_NO_ERROR;
+
+   if( ( appl_eFwUpdateState != FW_UPDATE_STATE_NOT_STARTED ) ||
+       appl_fFwUpdateCleanupPending )
+   {
+      eError = ABCC_EC_NO_RESOURCES;
+   }
+   else if( ( lSize == 0 ) || !SetupDstPath( pacFileName ) )
+   {
+      eError = ABCC_EC_PARAMETER_NOT_VALID;
+   }
+
+   if( eError != ABCC_EC_NO_ERROR )
+   {
+      if( pnResultCallback )
+      {
+         pnResultCallback( eError );
+      }
+      return( FALSE );
+   }
+
+   return( TRUE );
+}
+
+/*******************************************************************************
+** Public Services
+********************************************************************************
+*/
+
+void ABCC_API_FirmwareUpdateFromBuffer(
+   const char* pacFileName,
+   const UINT8* pbImage,
+   UINT32 lSize,
+   BOOL fRestart,
+   ABCC_API_pnFwUpdateResultCallback pnResultCallback )
+{
+   if( pbImage == NULL )
+   {
+      if( pnResultCallback )
+      {
+         pnResultCallback( ABCC_EC_PARAMETER_NOT_VALID );
+      }
+      return;
+   }
+
+   if( !CheckArgs( pacFileName, lSize, pnResultCallback ) )
+   {
+      return;
+   }
+
+   appl_pbFwUpdateImage = pbImage;
+   appl_pnFwUpdateReadCallback = NULL;
+   Start( lSize, fRestart, pnResultCallback );
+}
+
+void ABCC_API_FirmwareUpdateFromCallback(
+   const char* pacFileName,
+   UINT32 lSize,
+   ABCC_API_pnFwUpdateReadCallback pnReadCallback,
+   BOOL fRestart,
+   ABCC_API_pnFwUpdateResultCallback pnResultCallback )
+{
+   if( pnReadCallback == NULL )
+   {
+      if( pnResultCallback )
+      {
+         pnResultCallback( ABCC_EC_PARAMETER_NOT_VALID );
+      }
+      return;
+   }
+
+   if( !CheckArgs( pacFileName, lSize, pnResultCallback ) )
+   {
+      return;
+   }
+
+   appl_pbFwUpdateImage = NULL;
+   appl_pnFwUpdateReadCallback = pnReadCallback;
+   Start( lSize, fRestart, pnResultCallback );
+}
+
+UINT32 ABCC_API_FirmwareUpdateProgress( void )
+{
+   if( appl_eFwUpdateState == FW_UPDATE_STATE_NOT_STARTED )
+   {
+      return( 0 );
+   }
+
+   return( appl_lFwUpdateDoneOffset );
+}
+
+void ABCC_API_FirmwareUpdateModuleReset( void )
+{
+   if( appl_eFwUpdateState == FW_UPDATE_STATE_NOT_STARTED )
+   {
+      return;
+   }
+
+   /*
+   ** The FSI instance and all outstanding commands are gone after a reset.
+   ** Once the instance is being deleted the file has either been verified,
+   ** and is installed by this reset, or a delete has been attempted. Before
+   ** the file is opened nothing has been written. Otherwise a partial or
+   ** unverified file may be left in the candidate area, which is deleted
+   ** once the module is up again. An interrupted clean up is started over.
+   */
+   ABCC_API_FW_UPDATE_DEBUG_PRINT( "Module reset during firmware update\n" );
+   appl_bFwUpdateSlotHead = 0;
+   appl_bFwUpdateSlotCount = 0;
+   appl_fFwUpdateRestart = FALSE;
+
+   if( ( appl_eFwUpdateState == FW_UPDATE_STATE_DELETE_INSTANCE_WAIT_RSP ) ||
+       ( ( appl_eFwUpdateState == FW_UPDATE_STATE_CREATE_INSTANCE_WAIT_RSP ) &&
+         !appl_fFwUpdateCleanup ) )
+   {
+      if( ( appl_eFwUpdateState == FW_UPDATE_STATE_CREATE_INSTANCE_WAIT_RSP ) &&
+          ( appl_eFwUpdateResult == ABCC_EC_NO_ERROR ) )
+      {
+         appl_eFwUpdateResult = ABCC_EC_INTERNAL_ERROR;
+      }
+      Finish();
+      return;
+   }
+
+   if( appl_eFwUpdateResult == ABCC_EC_NO_ERROR )
+   {
+      appl_eFwUpdateResult = ABCC_EC_INTERNAL_ERROR;
+   }
+   SetState( FW_UPDATE_STATE_NOT_STARTED );
+   appl_fFwUpdateCleanup = FALSE;
+   appl_fFwUpdateCleanupPending = TRUE;
+}
+
+void ABCC_API_FirmwareUpdateResume( void )
+{
+   ABCC_ErrorCodeType eError;
+
+   if( !appl_fFwUpdateCleanupPending )
+   {
+      return;
+   }
+
+   ABCC_API_FW_UPDATE_DEBUG_PRINT( "Deleting %s after module reset\n", appl_acFwUpdateDstPath );
+   appl_fFwUpdateCleanupPending = FALSE;
+   appl_fFwUpdateCleanup = TRUE;
+   appl_iFwUpdateInstance = 0;
+
+   eError = ANB_FSI_Create( FsiObjectResponse );
+   if( eError != ABCC_EC_NO_ERROR )
+   {
+      ABCC_LOG_WARNING( eError, 0, "Could not delete interrupted firmware image\n" );
+      Finish();
+      return;
+   }
+
+   SetState( FW_UPDATE_STATE_CREATE_INSTANCE_WAIT_RSP );
+}
+
+#endif
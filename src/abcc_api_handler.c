@@ -15,6 +15,7 @@
 */
 
 #include <stdio.h>
+#include <string.h>
 #include <inttypes.h>
 #include "abcc_types.h"
 #include "abcc_api_config.h"
@@ -30,40 +31,16 @@
 #include "host_objects/application_data_object.h"   /* Application data object:   254 */
 
 #include "abcc_api.h"
+#include "abcc_api_command_handler.h"
 #include "abcc_api_command_handler_lookup.h"
 #include "anybus_file_system_interface_object.h"
-
-/*------------------------------------------------------------------------------
-** Comm settings values
-**------------------------------------------------------------------------------
-*/
-#define ABCC_API_COMM_SETTING_1_INSTANCE            7
-#define ABCC_API_COMM_SETTING_2_INSTANCE            8
-
-/*------------------------------------------------------------------------------
-** The basic IPv4 settings.
-**------------------------------------------------------------------------------
-*/
-typedef struct
-{
-   UINT16   iInstance;
-   union
-   {
-      UINT8 abValue[ 4 ];
-      BOOL  fValue;
-   }
-   uValue;
-}
-appl_IpElementType;
-
-typedef struct
-{
-   appl_IpElementType  sAddress;
-   appl_IpElementType  sNetmask;
-   appl_IpElementType  sGateway;
-   appl_IpElementType  sDhcp;
-}
-appl_IpSettingsType;
+#include "abcc_api_select_firmware.h"
+#include "abcc_api_firmware_update.h"
+#include "abcc_api_msg_scheduler.h"
+#include "abcc_api_network_config.h"
+#include "diagnostic_event_manager.h"
+#include "abcc_api_diag_history.h"
+#include "abcc_api_sync_pipeline.h"
 
 /*------------------------------------------------------------------------------
 ** ABCC Handler states
@@ -87,76 +64,85 @@ appl_AbccHandlerStateType;
 static appl_AbccHandlerStateType appl_eAbccHandlerState = ABCC_API_INIT;
 
 /*------------------------------------------------------------------------------
-** Network Node address.
+** Set by ABCC_API_SetAddress(), ABCC_API_SetBaudrate(),
+** ABCC_API_SetCommSettings() and ABCC_API_SetIpSettings() and handled by the
+** next ABCC_API_Run(). The
+** values themselves are kept by the network configuration engine, see
+** abcc_api_network_config.h.
 **------------------------------------------------------------------------------
 */
-static UINT16 appl_iNwNodeAddress;
+static BOOL appl_fNcApplyRequested = FALSE;
 
 /*------------------------------------------------------------------------------
-** Network IP address settings
+** Set while the user init preparation waits for the network settings to be
+** written.
 **------------------------------------------------------------------------------
 */
-static appl_IpSettingsType appl_sIpSettings =
-{
-   { 3, { ABCC_API_DEFAULT_IP_NETWORK_ADDRESS } },
-   { 4, { ABCC_API_DEFAULT_NETMASK } },
-   { 5, { ABCC_API_DEFAULT_GATEWAY } },
-   { 6, { ABCC_API_DEFAULT_DHCP_ENABLE } }
-};
+static BOOL appl_fNcUserInitPending = FALSE;
 
 /*------------------------------------------------------------------------------
-** Common address variables (used for both node address and IP address depending
-** on network type).
+** Set to TRUE the user init sequence is done.
 **------------------------------------------------------------------------------
 */
-static BOOL appl_fSetAddr = FALSE;
-static BOOL appl_fSetAddrInProgress = FALSE;
+static BOOL appl_fUserInitPrepDone = FALSE;
 
 /*------------------------------------------------------------------------------
-** Network baud rate.
+** Set to TRUE when the next restart is expected to install a new firmware.
 **------------------------------------------------------------------------------
 */
-static UINT8 appl_bNwBaudRate;
-static BOOL  appl_fSetBaudRate = FALSE;
-static BOOL  appl_fSetBaudRateInProgress = FALSE;
+static BOOL appl_fFwUpdatePending = FALSE;
 
 /*------------------------------------------------------------------------------
-** Comm setting variables. Used for setting speed and duplex on ethernet based
-** networks.
+** Set by ABCC_API_WarmRestart() and cleared when the user init sequence is
+** done.
 **------------------------------------------------------------------------------
 */
-static ABCC_API_CommSettingType appl_eCommSettings1 = ABCC_API_DEFAULT_COMM_SETTING;
-static ABCC_API_CommSettingType appl_eCommSettings2 = ABCC_API_DEFAULT_COMM_SETTING;
-static BOOL appl_fSetCommSettings = FALSE;
-static BOOL appl_fSetCommSettingsInProgress = FALSE;
+static BOOL appl_fWarmStart = FALSE;
 
 /*------------------------------------------------------------------------------
-** Flags to keep track of if the network type supports node ID/IP address,
-** baud rate and/or Comm settings to be set.
+** Set when AD_Init() has succeeded with appl_iAdInitNumAdi ADIs, so that a
+** warm start can keep the ADI maps.
 **------------------------------------------------------------------------------
 */
-static BOOL appl_fNwSupportsNodeId;
-static BOOL appl_fNwSupportsBaudRate;
-static BOOL appl_fNwSupportsDhcp;
-static BOOL appl_fNwSupportsCommSettings;
+static BOOL appl_fAdInitValid = FALSE;
+static UINT16 appl_iAdInitNumAdi = 0;
 
 /*------------------------------------------------------------------------------
-** Set to TRUE the user init sequence is done.
+** Time from the start of the driver to the PROCESS_ACTIVE state, counted by
+** ABCC_API_RunTimerSystem().
 **------------------------------------------------------------------------------
 */
-static BOOL appl_fUserInitPrepDone = FALSE;
+static UINT32 appl_lStartupTimeMs = 0;
+static UINT32 appl_lLastStartupTimeMs = 0;
+static BOOL appl_fStartupTimeRunning = FALSE;
 
 #if ABCC_CFG_INT_ENABLED
 /*------------------------------------------------------------------------------
-** Event flags used by application to invoke the corresponding
-** ABCC_Trigger<event_action> function from the desired context. The flag will
-** be set to TRUE in ABCC_CbfEvent().
+** Events (ABCC_ISR_EVENT_xxx) used by application to invoke the corresponding
+** ABCC_Trigger<event_action> function from the desired context. The bits are
+** set in ABCC_CbfEvent() and fetched and cleared in one step by
+** FetchAndClearEvents(), both inside a critical section, so an event arriving
+** while the previous ones are being fetched is never lost.
 **------------------------------------------------------------------------------
 */
-static volatile BOOL appl_fMsgReceivedEvent = FALSE;
-static volatile BOOL appl_fRdPdReceivedEvent = FALSE;
-static volatile BOOL appl_fTransmitMsgEvent = FALSE;
-static volatile BOOL appl_fAbccStatusEvent = FALSE;
+static volatile UINT16 appl_iPendingEvents = 0;
+static ABCC_API_EventStatsType appl_sEventStats;
+#endif
+
+#ifdef ABCC_API_CONFIG_GET_TIME_US
+/*------------------------------------------------------------------------------
+** Cycle scheduling for ABCC_API_RunCycle(). While appl_fCycleBudgetActive is
+** set, deferrable work is skipped once appl_lCycleBudgetUs has passed since
+** appl_lCycleStartUs. appl_fCycleDeferred is set once work of the cycle has
+** been skipped, so that the cycle is counted once.
+**------------------------------------------------------------------------------
+*/
+static UINT32 appl_lCyclePeriodUs = 0;
+static BOOL appl_fCycleBudgetActive = FALSE;
+static BOOL appl_fCycleDeferred = FALSE;
+static UINT32 appl_lCycleStartUs = 0;
+static UINT32 appl_lCycleBudgetUs = 0;
+static ABCC_API_CycleStatsType appl_sCycleStats;
 #endif
 
 /*------------------------------------------------------------------------------
@@ -168,17 +154,17 @@ static ABCC_CmdSeqRespStatusType HandleExceptionResp( ABP_MsgType* psMsg, void*
 static ABCC_CmdSeqRespStatusType HandleExceptionInfoResp( ABP_MsgType* psMsg, void* pxUserData );
 static ABCC_CmdSeqCmdStatusType ReadExeption( ABP_MsgType* psMsg, void* pxUserData );
 static ABCC_CmdSeqCmdStatusType ReadExeptionInfo( ABP_MsgType* psMsg, void* pxUserData );
-static ABCC_CmdSeqCmdStatusType UpdateNodeAddress( ABP_MsgType* psMsg, void* pxUserData );
-static ABCC_CmdSeqCmdStatusType UpdateIpAddress( ABP_MsgType* psMsg, void* pxUserData );
-static ABCC_CmdSeqCmdStatusType UpdateNetmask( ABP_MsgType* psMsg, void* pxUserData );
-static ABCC_CmdSeqCmdStatusType UpdateGateway( ABP_MsgType* psMsg, void* pxUserData );
-static ABCC_CmdSeqCmdStatusType UpdateDhcp( ABP_MsgType* psMsg, void* pxUserData );
-static void UpdateAddressDone( const ABCC_CmdSeqResultType eSeqResult, void* pxUserData );
-static ABCC_CmdSeqCmdStatusType UpdateBaudRate( ABP_MsgType* psMsg, void* pxUserData );
-static void UpdateBaudRateDone( const ABCC_CmdSeqResultType eSeqResult, void* pxUserData );
-static ABCC_CmdSeqCmdStatusType UpdateCommSetting1( ABP_MsgType* psMsg, void* pxUserData );
-static ABCC_CmdSeqCmdStatusType UpdateCommSetting2( ABP_MsgType* psMsg, void* pxUserData );
-static void UpdateCommSettingsDone( const ABCC_CmdSeqResultType eSeqResult, void* pxUserData );
+static void NcApplyDone( const ABCC_CmdSeqResultType eSeqResult, void* pxUserData );
+static void UserInitPrepDone( const ABCC_CmdSeqResultType eSeqResult, void* pxUserData );
+#if ABCC_CFG_INT_ENABLED
+static UINT16 FetchAndClearEvents( UINT16 iMask );
+#endif
+static ABCC_ErrorCodeType RunHandler( BOOL fProcessData );
+static void TriggerWrPdUpdate( void );
+static BOOL CycleBudgetLeft( void );
+#if ABCC_CFG_INT_ENABLED && defined( ABCC_API_CONFIG_EVENT_WAIT )
+static UINT32 NextWorkMs( void );
+#endif
 
 #ifdef ABCC_API_CONFIG_ERROR_EVENT_NOTIFY
 EXTFUNC void ABCC_API_CONFIG_ERROR_EVENT_NOTIFY( ABCC_LogSeverityType eSeverity,
@@ -190,60 +176,13 @@ EXTFUNC void ABCC_API_CONFIG_ERROR_EVENT_NOTIFY( ABCC_LogSeverityType eSeverity,
 EXTFUNC void ABCC_API_CONFIG_ANYBUS_STATE_CHANGE_NOTIFY( ABP_AnbStateType eNewAnbState );
 #endif
 
-/*------------------------------------------------------------------------------
-** User init sequence. See abcc_command_sequencer_interface.h
-**------------------------------------------------------------------------------
-*/
-static const ABCC_CmdSeqType appl_asUserInitPrepCmdSeq[] =
-{
-   ABCC_CMD_SEQ( UpdateIpAddress, NULL ),
-   ABCC_CMD_SEQ( UpdateNetmask, NULL ),
-   ABCC_CMD_SEQ( UpdateGateway, NULL ),
-   ABCC_CMD_SEQ( UpdateDhcp, NULL ),
-   ABCC_CMD_SEQ( UpdateNodeAddress, NULL ),
-   ABCC_CMD_SEQ( UpdateBaudRate, NULL ),
-   ABCC_CMD_SEQ( UpdateCommSetting1, NULL ),
-   ABCC_CMD_SEQ( UpdateCommSetting2, NULL ),
-   ABCC_CMD_SEQ_END()
-};
-
-/*------------------------------------------------------------------------------
-** Set IP or node address.
-** Sequence triggered when the address switch has changed value.
-** See abcc_command_sequencer_interface.h.
-**------------------------------------------------------------------------------
-*/
-static const ABCC_CmdSeqType appl_asAddressChangedCmdSeq[] =
-{
-   ABCC_CMD_SEQ( UpdateIpAddress, NULL ),
-   ABCC_CMD_SEQ( UpdateNodeAddress, NULL ),
-   ABCC_CMD_SEQ_END()
-};
-
-/*------------------------------------------------------------------------------
-** Set baud rate.
-** Sequence triggered when the baud rate switch has changed value.
-** See abcc_command_sequencer_interface.h.
-**------------------------------------------------------------------------------
-*/
-static const ABCC_CmdSeqType appl_asBaudRateChangedCmdSeq[] =
-{
-   ABCC_CMD_SEQ( UpdateBaudRate, NULL ),
-   ABCC_CMD_SEQ_END()
-};
+#ifdef ABCC_API_CONFIG_EVENT_WAIT
+EXTFUNC void ABCC_API_CONFIG_EVENT_WAIT( UINT32 lTimeoutMs );
+#endif
 
-/*------------------------------------------------------------------------------
-** Set Comm settings.
-** Sequence triggered when the Comm settings has changed value.
-** See abcc_command_sequencer_interface.h.
-**------------------------------------------------------------------------------
-*/
-static const ABCC_CmdSeqType appl_asCommSettingsChangedCmdSeq[] =
-{
-   ABCC_CMD_SEQ( UpdateCommSetting1, NULL ),
-   ABCC_CMD_SEQ( UpdateCommSetting2, NULL ),
-   ABCC_CMD_SEQ_END()
-};
+#ifdef ABCC_API_CONFIG_CYCLE_OVERRUN_NOTIFY
+EXTFUNC void ABCC_API_CONFIG_CYCLE_OVERRUN_NOTIFY( UINT32 lElapsedUs, UINT32 lPeriodUs );
+#endif
 
 /*------------------------------------------------------------------------------
 ** Read exception info.
@@ -312,6 +251,9 @@ static ABCC_CmdSeqRespStatusType HandleExceptionResp( ABP_MsgType* psMsg, void*
 
    ABCC_GetMsgData8( psMsg, &bException, 0 );
    ABCC_LOG_INFO( "Exception Code: %X:\n", bException );
+#if ABCC_API_DIAG_HISTORY_ENABLE
+   ABCC_API_DiagHistoryRecord( ABCC_API_DIAG_HIST_EXCEPTION, bException, 0, 0 );
+#endif
 
    (void)bException;
    return( ABCC_CMDSEQ_RESP_EXEC_NEXT );
@@ -340,23 +282,30 @@ static ABCC_CmdSeqRespStatusType HandleExceptionInfoResp( ABP_MsgType* psMsg, vo
 
    ABCC_GetMsgData8( psMsg, &bExceptionInfo, 0 );
    ABCC_LOG_INFO( "Exception Info: %X:\n", bExceptionInfo );
+#if ABCC_API_DIAG_HISTORY_ENABLE
+   ABCC_API_DiagHistoryRecord( ABCC_API_DIAG_HIST_EXCEPTION_INFO, bExceptionInfo, 0, 0 );
+#endif
 
    (void)bExceptionInfo;
    return( ABCC_CMDSEQ_RESP_EXEC_NEXT );
 }
 
 /*------------------------------------------------------------------------------
-**  Notification that the address is updated.
+**  Notification that the network configuration engine has written the changed
+**  network settings. Finishes the user init preparation if it was waiting.
 **
 **  This function is a part of a command sequence. See description of
 **  ABCC_CmdSeqDoneHandler type in cmd_seq_if.h
 **------------------------------------------------------------------------------
 */
-static void UpdateAddressDone( const ABCC_CmdSeqResultType eSeqResult, void* pxUserData )
+static void NcApplyDone( const ABCC_CmdSeqResultType eSeqResult, void* pxUserData )
 {
-   (void)pxUserData;
-
-   appl_fSetAddrInProgress = FALSE;
+   if( appl_fNcUserInitPending )
+   {
+      appl_fNcUserInitPending = FALSE;
+      UserInitPrepDone( eSeqResult, pxUserData );
+      return;
+   }
 
    switch( eSeqResult )
    {
@@ -364,303 +313,60 @@ static void UpdateAddressDone( const ABCC_CmdSeqResultType eSeqResult, void* pxU
       break;
 
    case ABCC_CMDSEQ_RESULT_ABORT_INT:
-      ABCC_LOG_INFO( "UpdateAddressDone reported internally aborted command sequence.\n" );
+      ABCC_LOG_INFO( "NcApplyDone reported internally aborted command sequence.\n" );
       break;
 
    case ABCC_CMDSEQ_RESULT_ABORT_EXT:
-      ABCC_LOG_INFO( "UpdateAddressDone reported externally aborted command sequence.\n" );
+      ABCC_LOG_INFO( "NcApplyDone reported externally aborted command sequence.\n" );
       break;
 
    default:
-      ABCC_LOG_INFO( "UpdateAddressDone reported aborted command sequence.\n" );
+      ABCC_LOG_INFO( "NcApplyDone reported aborted command sequence.\n" );
       break;
    }
 }
 
+#if ABCC_CFG_INT_ENABLED
 /*------------------------------------------------------------------------------
-**  Builds the command for setting the ip-address (set attribute).
-**
-**  This function is a part of a command sequence. See description of
-**  ABCC_CmdSeqCmdHandler type in cmd_seq_if.h
-**------------------------------------------------------------------------------
-*/
-static ABCC_CmdSeqCmdStatusType UpdateIpAddress( ABP_MsgType* psMsg, void* pxUserData )
-{
-   (void)pxUserData;
-
-   if( ( !appl_fNwSupportsNodeId ) &&
-       ( appl_fSetAddr ) )
-   {
-      ABCC_SetMsgHeader( psMsg,
-                         ABP_OBJ_NUM_NC,
-                         appl_sIpSettings.sAddress.iInstance,
-                         ABP_NC_VAR_IA_VALUE,
-                         ABP_CMD_SET_ATTR,
-                         4,
-                         ABCC_GetNewSourceId() );
-
-      ABCC_SetMsgString( psMsg, (char*)appl_sIpSettings.sAddress.uValue.abValue, 4, 0 );
-
-      return( ABCC_CMDSEQ_CMD_SEND );
-   }
-
-   return( ABCC_CMDSEQ_CMD_SKIP );
-}
-
-/*------------------------------------------------------------------------------
-**  Builds the command for setting the netmask (set attribute).
-**
-**  This function is a part of a command sequence. See description of
-**  ABCC_CmdSeqCmdHandler type in cmd_seq_if.h
-**------------------------------------------------------------------------------
-*/
-static ABCC_CmdSeqCmdStatusType UpdateNetmask( ABP_MsgType* psMsg, void* pxUserData )
-{
-   (void)pxUserData;
-
-   if( ( !appl_fNwSupportsNodeId ) &&
-       ( appl_fSetAddr ) )
-   {
-      ABCC_SetMsgHeader( psMsg,
-                         ABP_OBJ_NUM_NC,
-                         appl_sIpSettings.sNetmask.iInstance,
-                         ABP_NC_VAR_IA_VALUE,
-                         ABP_CMD_SET_ATTR,
-                         4,
-                         ABCC_GetNewSourceId() );
-
-      ABCC_SetMsgString( psMsg, (char*)appl_sIpSettings.sNetmask.uValue.abValue, 4, 0 );
-
-      return( ABCC_CMDSEQ_CMD_SEND );
-   }
-
-   return( ABCC_CMDSEQ_CMD_SKIP );
-}
-
-/*------------------------------------------------------------------------------
-**  Builds the command for setting the gateway (set attribute).
-**
-**  This function is a part of a command sequence. See description of
-**  ABCC_CmdSeqCmdHandler type in cmd_seq_if.h
-**------------------------------------------------------------------------------
-*/
-static ABCC_CmdSeqCmdStatusType UpdateGateway( ABP_MsgType* psMsg, void* pxUserData )
-{
-   (void)pxUserData;
-
-   if( ( !appl_fNwSupportsNodeId ) &&
-       ( appl_fSetAddr ) )
-   {
-      ABCC_SetMsgHeader( psMsg,
-                         ABP_OBJ_NUM_NC,
-                         appl_sIpSettings.sGateway.iInstance,
-                         ABP_NC_VAR_IA_VALUE,
-                         ABP_CMD_SET_ATTR,
-                         4,
-                         ABCC_GetNewSourceId() );
-
-      ABCC_SetMsgString( psMsg, (char*)appl_sIpSettings.sGateway.uValue.abValue, 4, 0 );
-
-      return( ABCC_CMDSEQ_CMD_SEND );
-   }
-
-   return( ABCC_CMDSEQ_CMD_SKIP );
-}
-
-/*------------------------------------------------------------------------------
-**  Builds the command for enable/disable dhcp (set attribute).
-**
-**  This function is a part of a command sequence. See description of
-**  ABCC_CmdSeqCmdHandler type in cmd_seq_if.h
+**  Fetches and clears the events in iMask set by ABCC_CbfEvent() in one step
+**  and counts them as handled. Events outside iMask are left pending.
 **------------------------------------------------------------------------------
 */
-static ABCC_CmdSeqCmdStatusType UpdateDhcp( ABP_MsgType* psMsg, void* pxUserData )
+static UINT16 FetchAndClearEvents( UINT16 iMask )
 {
-   (void)pxUserData;
+   UINT16 iEvents;
+   ABCC_PORT_UseCritical();
 
-   if( ( appl_fNwSupportsDhcp ) &&
-       ( appl_fSetAddr ) )
-   {
-      ABCC_SetByteAttribute( psMsg, ABP_OBJ_NUM_NC,
-                             appl_sIpSettings.sDhcp.iInstance,
-                             ABP_NC_VAR_IA_VALUE,
-                             (UINT8)appl_sIpSettings.sDhcp.uValue.fValue,
-                             ABCC_GetNewSourceId() );
+   ABCC_PORT_EnterCritical();
 
-      return( ABCC_CMDSEQ_CMD_SEND );
-   }
-   return( ABCC_CMDSEQ_CMD_SKIP );
-}
+   iEvents = appl_iPendingEvents & iMask;
+   appl_iPendingEvents &= (UINT16)~iMask;
 
-/*------------------------------------------------------------------------------
-**  Builds the command for setting the node-address (set attribute).
-**
-**  This function is a part of a command sequence. See description of
-**  ABCC_CmdSeqCmdHandler type in cmd_seq_if.h
-**------------------------------------------------------------------------------
-*/
-static ABCC_CmdSeqCmdStatusType UpdateNodeAddress( ABP_MsgType* psMsg, void* pxUserData )
-{
-   (void)pxUserData;
-
-   if( ( appl_fNwSupportsNodeId ) &&
-       ( appl_fSetAddr ) )
+   if( iEvents & ABCC_ISR_EVENT_RDPD )
    {
-      ABCC_SetMsgHeader( psMsg,
-                         ABP_OBJ_NUM_NC,
-                         ABP_NC_INST_NUM_SW1,
-                         ABP_NC_VAR_IA_VALUE,
-                         ABP_CMD_SET_ATTR,
-                         ABP_UINT16_SIZEOF,
-                         ABCC_GetNewSourceId() );
-
-      ABCC_SetMsgData16( psMsg, appl_iNwNodeAddress, 0 );
-
-      return( ABCC_CMDSEQ_CMD_SEND );
+      appl_sEventStats.sRdPd.lHandled++;
    }
 
-   return( ABCC_CMDSEQ_CMD_SKIP );
-}
-
-/*------------------------------------------------------------------------------
-**  Notification that the Comm settings are updated.
-**
-**  This function is a part of a command sequence. See description of
-**  ABCC_CmdSeqDoneHandler type in cmd_seq_if.h
-**------------------------------------------------------------------------------
-*/
-static void UpdateCommSettingsDone( const ABCC_CmdSeqResultType eSeqResult, void* pxUserData )
-{
-   (void)pxUserData;
-
-   appl_fSetCommSettingsInProgress = FALSE;
-
-   switch( eSeqResult )
+   if( iEvents & ABCC_ISR_EVENT_RDMSG )
    {
-   case ABCC_CMDSEQ_RESULT_COMPLETED:
-      break;
-
-   case ABCC_CMDSEQ_RESULT_ABORT_INT:
-      ABCC_LOG_INFO( "UpdateCommSettingsDone reported internally aborted command sequence.\n" );
-      break;
-
-   case ABCC_CMDSEQ_RESULT_ABORT_EXT:
-      ABCC_LOG_INFO( "UpdateCommSettingsDone reported externally aborted command sequence.\n" );
-      break;
-
-   default:
-      ABCC_LOG_INFO( "UpdateCommSettingsDone reported aborted command sequence.\n" );
-      break;
+      appl_sEventStats.sRdMsg.lHandled++;
    }
-}
 
-/*------------------------------------------------------------------------------
-**  Builds the command for Comm settings.
-**------------------------------------------------------------------------------
-*/
-static ABCC_CmdSeqCmdStatusType SetCommSettingCmdMsgData( ABP_MsgType* psMsg,
-                                                          UINT16 iInstance,
-                                                          ABCC_API_CommSettingType eCommSetting )
-{
-   if( ( appl_fNwSupportsCommSettings ) &&
-       ( appl_fSetCommSettings ) )
+   if( iEvents & ABCC_ISR_EVENT_WRMSG )
    {
-      ABCC_SetByteAttribute( psMsg,
-                             ABP_OBJ_NUM_NC,
-                             iInstance,
-                             ABP_NC_VAR_IA_VALUE,
-                             (UINT8)eCommSetting,
-                             ABCC_GetNewSourceId() );
-      return( ABCC_CMDSEQ_CMD_SEND );
+      appl_sEventStats.sWrMsg.lHandled++;
    }
 
-   return( ABCC_CMDSEQ_CMD_SKIP );
-}
-
-/*------------------------------------------------------------------------------
-**  Builds the command for Comm 1 setting.
-**
-**  This function is a part of a command sequence. See description of
-**  ABCC_CmdSeqCmdHandler type in cmd_seq_if.h
-**------------------------------------------------------------------------------
-*/
-static ABCC_CmdSeqCmdStatusType UpdateCommSetting1( ABP_MsgType* psMsg, void* pxUserData )
-{
-   (void)pxUserData;
-
-   return( SetCommSettingCmdMsgData( psMsg, ABCC_API_COMM_SETTING_1_INSTANCE, appl_eCommSettings1 ) );
-}
-
-/*------------------------------------------------------------------------------
-**  Builds the command for Comm 2 setting.
-**
-**  This function is a part of a command sequence. See description of
-**  ABCC_CmdSeqCmdHandler type in cmd_seq_if.h
-**------------------------------------------------------------------------------
-*/
-static ABCC_CmdSeqCmdStatusType UpdateCommSetting2( ABP_MsgType* psMsg, void* pxUserData )
-{
-   (void)pxUserData;
-
-   return( SetCommSettingCmdMsgData( psMsg, ABCC_API_COMM_SETTING_2_INSTANCE, appl_eCommSettings2 ) );
-}
-
-/*------------------------------------------------------------------------------
-**  Notification that the baud rate is updated.
-**
-**  This function is a part of a command sequence. See description of
-**  ABCC_CmdSeqDoneHandler type in cmd_seq_if.h
-**------------------------------------------------------------------------------
-*/
-static void UpdateBaudRateDone( const ABCC_CmdSeqResultType eSeqResult, void* pxUserData )
-{
-   (void)pxUserData;
-
-   appl_fSetBaudRateInProgress = FALSE;
-
-   switch( eSeqResult )
+   if( iEvents & ABCC_ISR_EVENT_STATUS )
    {
-   case ABCC_CMDSEQ_RESULT_COMPLETED:
-      break;
-
-   case ABCC_CMDSEQ_RESULT_ABORT_INT:
-      ABCC_LOG_INFO( "UpdateBaudRateDone reported internally aborted command sequence.\n" );
-      break;
-
-   case ABCC_CMDSEQ_RESULT_ABORT_EXT:
-      ABCC_LOG_INFO( "UpdateBaudRateDone reported externally aborted command sequence.\n" );
-      break;
-
-   default:
-      ABCC_LOG_INFO( "UpdateBaudRateDone reported aborted command sequence.\n" );
-      break;
+      appl_sEventStats.sStatus.lHandled++;
    }
-}
 
-/*------------------------------------------------------------------------------
-**  Builds the command for setting the baud rate (set attribute).
-**
-**  This function is a part of a command sequence. See description of
-**  ABCC_CmdSeqCmdHandler type in cmd_seq_if.h
-**------------------------------------------------------------------------------
-*/
-static ABCC_CmdSeqCmdStatusType UpdateBaudRate( ABP_MsgType* psMsg, void* pxUserData )
-{
-   (void)pxUserData;
-
-   if( ( appl_fNwSupportsBaudRate ) &&
-       ( appl_fSetBaudRate ) )
-   {
-      ABCC_SetByteAttribute( psMsg, ABP_OBJ_NUM_NC,
-                             ABP_NC_INST_NUM_SW2,
-                             ABP_NC_VAR_IA_VALUE,
-                             appl_bNwBaudRate,
-                             ABCC_GetNewSourceId() );
+   ABCC_PORT_ExitCritical();
 
-      return( ABCC_CMDSEQ_CMD_SEND );
-   }
-   return( ABCC_CMDSEQ_CMD_SKIP );
+   return( iEvents );
 }
+#endif
 
 /*------------------------------------------------------------------------------
 **  Notification that the user init preparation sequence is done.
@@ -673,6 +379,11 @@ static void UserInitPrepDone( const ABCC_CmdSeqResultType eSeqResult, void* pxUs
 {
    (void)pxUserData;
 
+   /*
+   ** The next start is a cold one, unless ABCC_API_WarmRestart() is called.
+   */
+   appl_fWarmStart = FALSE;
+
    switch( eSeqResult )
    {
    case ABCC_CMDSEQ_RESULT_COMPLETED:
@@ -709,6 +420,10 @@ void ABCC_API_UserInitComplete( void )
 {
       appl_fUserInitPrepDone = TRUE;
       ABCC_UserInitComplete();
+#if ANB_FSI_OBJ_ENABLE
+      ABCC_API_SelectFirmwareResume();
+      ABCC_API_FirmwareUpdateResume();
+#endif
 }
 
 void ABCC_API_RunTimerSystem( const INT16 iDeltaTimeMs )
@@ -716,6 +431,20 @@ void ABCC_API_RunTimerSystem( const INT16 iDeltaTimeMs )
    if( appl_eAbccHandlerState > ABCC_API_INIT )
    {
       ABCC_RunTimerSystem( iDeltaTimeMs );
+      ABCC_API_MsgSchedRunTimer( iDeltaTimeMs );
+      if( appl_fStartupTimeRunning && ( iDeltaTimeMs > 0 ) )
+      {
+         appl_lStartupTimeMs += (UINT32)iDeltaTimeMs;
+      }
+#if DI_OBJ_ENABLE
+      DI_MgrRunTimer( iDeltaTimeMs );
+#endif
+#if ABCC_API_DIAG_HISTORY_ENABLE
+      ABCC_API_DiagHistoryRunTimer( iDeltaTimeMs );
+#endif
+#if ABCC_API_DEFERRED_RESP_MAX
+      ABCC_API_DeferredRespRunTimer( iDeltaTimeMs );
+#endif
    }
 }
 
@@ -724,11 +453,117 @@ EXTFUNC ABCC_ErrorCodeType ABCC_API_Init( void )
    return( ABCC_HwInit() );
 }
 
-ABCC_ErrorCodeType ABCC_API_Run( void )
+/*------------------------------------------------------------------------------
+**  Triggers the write process data update, unless the SYNC object is in a
+**  mode where the application does that from ABCC_API_CbfSyncIsr(). With the
+**  sync pipeline the outputs are staged here and sent from the sync ISR.
+**------------------------------------------------------------------------------
+*/
+static void TriggerWrPdUpdate( void )
+{
+#if SYNC_OBJ_ENABLE
+   if( ABCC_CbfSyncObjSyncMode_Get() == 0 )
+   {
+      ABCC_TriggerWrPdUpdate();
+   }
+#if ABCC_API_SYNC_PIPELINE_ENABLE
+   else
+   {
+      ABCC_API_SyncPipelineStageOutputs();
+   }
+#endif
+#else
+   /*
+   ** Always update write process data
+   */
+   ABCC_TriggerWrPdUpdate();
+#endif
+}
+
+/*------------------------------------------------------------------------------
+**  Checks if there is time left for deferrable work in the current
+**  ABCC_API_RunCycle() cycle. Always TRUE outside ABCC_API_RunCycle().
+**------------------------------------------------------------------------------
+*/
+static BOOL CycleBudgetLeft( void )
+{
+#ifdef ABCC_API_CONFIG_GET_TIME_US
+   if( appl_fCycleBudgetActive &&
+       ( (UINT32)( ABCC_API_CONFIG_GET_TIME_US() - appl_lCycleStartUs ) >= appl_lCycleBudgetUs ) )
+   {
+      if( !appl_fCycleDeferred )
+      {
+         appl_fCycleDeferred = TRUE;
+         appl_sCycleStats.lDeferred++;
+      }
+      return( FALSE );
+   }
+#endif
+
+   return( TRUE );
+}
+
+#if ABCC_CFG_INT_ENABLED && defined( ABCC_API_CONFIG_EVENT_WAIT )
+/*------------------------------------------------------------------------------
+**  Time until the RUN state has work that is not triggered by an ABCC event,
+**  e.g. network settings to apply, queued commands that can now be sent,
+**  diagnostic events held back by the hold-off time or the rate limiter, and
+**  deferred responses. 0 if there is work now, 0xFFFFFFFF if there is none.
+**------------------------------------------------------------------------------
+*/
+static UINT32 NextWorkMs( void )
+{
+   UINT32 lNextMs;
+   UINT32 lMs;
+
+   if( appl_fNcApplyRequested )
+   {
+      return( 0 );
+   }
+
+   lNextMs = ABCC_API_MsgSchedNextRunMs();
+#if DI_OBJ_ENABLE
+   lMs = DI_MgrNextRunMs();
+   if( lMs < lNextMs )
+   {
+      lNextMs = lMs;
+   }
+#endif
+#if ABCC_API_DEFERRED_RESP_MAX
+   lMs = ABCC_API_DeferredRespNextRunMs();
+   if( lMs < lNextMs )
+   {
+      lNextMs = lMs;
+   }
+#endif
+#if ANB_FSI_OBJ_ENABLE
+   if( ANB_FSI_IsRunPending() )
+   {
+      lNextMs = 0;
+   }
+#endif
+   (void)lMs;
+
+   return( lNextMs );
+}
+#endif
+
+/*------------------------------------------------------------------------------
+**  The ABCC handler. Runs the start up state machine and, in the RUN state,
+**  the driver, the message related work and, if fProcessData is set, the
+**  process data exchange.
+**------------------------------------------------------------------------------
+*/
+static ABCC_ErrorCodeType RunHandler( BOOL fProcessData )
 {
    static ABCC_ErrorCodeType eErrorCode = ABCC_EC_NO_ERROR;
    UINT32 lStartupTimeMs;
    ABCC_CommunicationStateType eAbccComState;
+#if ABCC_CFG_INT_ENABLED
+   UINT16 iEvents;
+   UINT16 iEventMask;
+   ABCC_PORT_UseCritical();
+#endif
 
    switch( appl_eAbccHandlerState )
    {
@@ -736,12 +571,30 @@ ABCC_ErrorCodeType ABCC_API_Run( void )
 
       eErrorCode = ABCC_EC_NO_ERROR;
 #if ABCC_CFG_INT_ENABLED
-      appl_fMsgReceivedEvent = FALSE;
-      appl_fRdPdReceivedEvent = FALSE;
-      appl_fTransmitMsgEvent = FALSE;
-      appl_fAbccStatusEvent = FALSE;
+      ABCC_PORT_EnterCritical();
+      appl_iPendingEvents = 0;
+      ABCC_PORT_ExitCritical();
 #endif
       appl_fUserInitPrepDone = FALSE;
+      appl_fNcUserInitPending = FALSE;
+      appl_lStartupTimeMs = 0;
+      appl_fStartupTimeRunning = TRUE;
+      ABCC_API_MsgSchedInit();
+#if ABCC_API_COMMAND_RESPONSE_CACHE_SIZE
+      ABCC_API_CommandResponseCacheBuild();
+#endif
+#if ABCC_API_DEFERRED_RESP_MAX
+      ABCC_API_DeferredRespInit();
+#endif
+
+      /*
+      ** A warm start trusts the CompactCom to still hold the network settings
+      ** written by the last start.
+      */
+      ABCC_API_NcInit( appl_fWarmStart, NcApplyDone );
+#if ABCC_API_SYNC_PIPELINE_ENABLE
+      ABCC_API_SyncPipelineReset();
+#endif
 
       if( !ABCC_ModuleDetect() )
       {
@@ -751,13 +604,27 @@ ABCC_ErrorCodeType ABCC_API_Run( void )
       if( eErrorCode == ABCC_EC_NO_ERROR )
       {
          /*
-         ** Init application data object
+         ** Init application data object. A warm start keeps the ADI maps of
+         ** the last start, unless they have been remapped since.
          */
-         if( AD_Init( ABCC_API_asAdiEntryList,
-                      ABCC_API_CbfGetNumAdi(),
-                      ABCC_API_asAdObjDefaultMap ) != ABCC_EC_NO_ERROR )
+         if( !( appl_fWarmStart &&
+                appl_fAdInitValid &&
+                ( appl_iAdInitNumAdi == ABCC_API_CbfGetNumAdi() ) &&
+                AD_IsDefaultMap() ) )
          {
-            eErrorCode = ABCC_EC_INTERNAL_ERROR;
+            appl_fAdInitValid = FALSE;
+            appl_iAdInitNumAdi = ABCC_API_CbfGetNumAdi();
+
+            if( AD_Init( ABCC_API_asAdiEntryList,
+                         appl_iAdInitNumAdi,
+                         ABCC_API_asAdObjDefaultMap ) != ABCC_EC_NO_ERROR )
+            {
+               eErrorCode = ABCC_EC_INTERNAL_ERROR;
+            }
+            else
+            {
+               appl_fAdInitValid = TRUE;
+            }
          }
 #if ASM_OBJ_ENABLE
 #error "Assembly Mapping Object is not supported in this version of the ABCC API"
@@ -768,11 +635,25 @@ ABCC_ErrorCodeType ABCC_API_Run( void )
 #endif
 #if ANB_FSI_OBJ_ENABLE
          ANB_FSI_Init();
+         ABCC_API_SelectFirmwareModuleReset();
+         ABCC_API_FirmwareUpdateModuleReset();
+#endif
+#if DI_OBJ_ENABLE
+         DI_MgrInit();
+#endif
+#if ABCC_API_DIAG_HISTORY_ENABLE
+         ABCC_API_DiagHistoryModuleReset();
 #endif
       }
 
       if( eErrorCode == ABCC_EC_NO_ERROR )
       {
+         if( appl_fFwUpdatePending )
+         {
+            ABCC_LOG_INFO( "Waiting for firmware update to complete.\n" );
+            lStartupTimeMs = ABCC_API_FW_UPGRADE_STARTUP_TIME_MS;
+         }
+         else
 #if APP_OBJ_ENABLE
          if( ABCC_CbfApplicationObjFirmwareAvailable_Get() == TRUE )
          {
@@ -791,7 +672,8 @@ ABCC_ErrorCodeType ABCC_API_Run( void )
          if( ABCC_StartDriver( lStartupTimeMs ) == ABCC_EC_NO_ERROR )
          {
             ABCC_HWReleaseReset();
-            appl_eAbccHandlerState = ABCC_API_WAITCOM;
+            appl_eAbccHandlerState = appl_fFwUpdatePending ? ABCC_API_WAIT_FW_UPDATE : ABCC_API_WAITCOM;
+            appl_fFwUpdatePending = FALSE;
          }
          else
          {
@@ -835,27 +717,35 @@ ABCC_ErrorCodeType ABCC_API_Run( void )
    case ABCC_API_RUN:
 
 #if ABCC_CFG_INT_ENABLED
-      if( appl_fRdPdReceivedEvent )
+      /*
+      ** Leave the read process data event to ABCC_API_RunProcessData() when
+      ** the process data is exchanged separately, and received messages to
+      ** the next cycle when the cycle budget is used up.
+      */
+      iEventMask = fProcessData ? (UINT16)0xFFFF : (UINT16)~ABCC_ISR_EVENT_RDPD;
+      if( !CycleBudgetLeft() )
+      {
+         iEventMask &= (UINT16)~ABCC_ISR_EVENT_RDMSG;
+      }
+      iEvents = FetchAndClearEvents( iEventMask );
+
+      if( iEvents & ABCC_ISR_EVENT_RDPD )
       {
-         appl_fRdPdReceivedEvent = FALSE;
          ABCC_TriggerRdPdUpdate();
       }
 
-      if( appl_fMsgReceivedEvent )
+      if( iEvents & ABCC_ISR_EVENT_RDMSG )
       {
-         appl_fMsgReceivedEvent = FALSE;
          ABCC_TriggerReceiveMessage();
       }
 
-      if( appl_fTransmitMsgEvent )
+      if( iEvents & ABCC_ISR_EVENT_WRMSG )
       {
-         appl_fTransmitMsgEvent = FALSE;
          ABCC_TriggerTransmitMessage();
       }
 
-      if( appl_fAbccStatusEvent )
+      if( iEvents & ABCC_ISR_EVENT_STATUS )
       {
-         appl_fAbccStatusEvent = FALSE;
          ABCC_TriggerAnbStatusUpdate();
       }
 #endif
@@ -864,23 +754,66 @@ ABCC_ErrorCodeType ABCC_API_Run( void )
       ** End event handling.
       */
 
-#if SYNC_OBJ_ENABLE
-      if( ABCC_CbfSyncObjSyncMode_Get() == 0 )
+      if( fProcessData )
       {
-         ABCC_TriggerWrPdUpdate();
+         TriggerWrPdUpdate();
       }
-#else
-      /*
-      ** Always update write process data
-      */
-      ABCC_TriggerWrPdUpdate();
-#endif
 
       eErrorCode = ABCC_RunDriver();
 
       if( eErrorCode == ABCC_EC_NO_ERROR )
       {
-         ABCC_API_CbfCyclicalProcessing();
+         /*
+         ** Start waiting control sequences before any queued FSI commands
+         ** are sent. All of this is left for the next cycle when the cycle
+         ** budget is used up.
+         */
+         if( CycleBudgetLeft() )
+         {
+            /*
+            ** Network settings changed since the last run. A burst of
+            ** changes, e.g. from a rotary switch being turned, ends up as one
+            ** update with the last values.
+            */
+            if( appl_fNcApplyRequested )
+            {
+               appl_fNcApplyRequested = FALSE;
+               (void)ABCC_API_NcApply();
+            }
+
+            ABCC_API_MsgSchedRun();
+         }
+#if DI_OBJ_ENABLE
+         if( CycleBudgetLeft() )
+         {
+            DI_MgrRun();
+         }
+#endif
+#if ABCC_API_DEFERRED_RESP_MAX
+         /*
+         ** Answer deferred commands whose callbacks are done.
+         */
+         if( CycleBudgetLeft() )
+         {
+            ABCC_API_DeferredRespRun();
+         }
+#endif
+#if ANB_FSI_OBJ_ENABLE
+         /*
+         ** Send FSI commands that were queued while out of resources.
+         */
+         if( CycleBudgetLeft() )
+         {
+            ANB_FSI_Run();
+         }
+#endif
+         if( fProcessData )
+         {
+#if ABCC_API_SYNC_PIPELINE_ENABLE
+            ABCC_API_SyncPipelineTakeInputs();
+#endif
+            ABCC_API_CbfCyclicalProcessing();
+         }
       }
 
       break;
@@ -904,117 +837,287 @@ ABCC_ErrorCodeType ABCC_API_Run( void )
    return( eErrorCode );
 }
 
-BOOL ABCC_API_SetAddress( UINT16 iSwitchValue )
+ABCC_ErrorCodeType ABCC_API_Run( void )
+{
+   return( RunHandler( TRUE ) );
+}
+
+ABCC_ErrorCodeType ABCC_API_RunMessaging( void )
+{
+   return( RunHandler( FALSE ) );
+}
+
+void ABCC_API_RunProcessData( void )
 {
-   appl_fSetAddr = TRUE;
+   if( appl_eAbccHandlerState != ABCC_API_RUN )
+   {
+      return;
+   }
 
-   if( appl_fSetAddrInProgress )
+#if ABCC_CFG_INT_ENABLED
+   if( FetchAndClearEvents( ABCC_ISR_EVENT_RDPD ) )
    {
-      /*
-      ** Address update already in progress.
-      */
-      return FALSE;
+      ABCC_TriggerRdPdUpdate();
    }
+#endif
+
+#if ABCC_API_SYNC_PIPELINE_ENABLE
+   ABCC_API_SyncPipelineTakeInputs();
+#endif
+   ABCC_API_CbfCyclicalProcessing();
+
+   TriggerWrPdUpdate();
+}
+
+ABCC_ErrorCodeType ABCC_API_RunUntilEvent( UINT32 lTimeoutMs )
+{
+#if ABCC_CFG_INT_ENABLED && defined( ABCC_API_CONFIG_EVENT_WAIT )
+   UINT32 lWorkMs;
 
    /*
-   ** Check if still in SETUP state.
+   ** The startup states poll the module and must not wait. An event that
+   ** arrives after the flags have been checked is remembered by the wait
+   ** primitive, so the wait returns at once in that case. Work queued inside
+   ** the API is not signalled, so the wait ends when it is due.
    */
-   if( appl_fUserInitPrepDone == FALSE )
+   if( ( appl_eAbccHandlerState == ABCC_API_RUN ) ||
+       ( appl_eAbccHandlerState == ABCC_API_HALT ) )
    {
-      /*
-      ** HW switch 1 will the last octet in the IP address
-      ** for applicable networks ( 192.168.0.X )
-      */
-      appl_sIpSettings.sAddress.uValue.abValue[ 3 ] = (UINT8)iSwitchValue;
+      lWorkMs = ( appl_eAbccHandlerState == ABCC_API_RUN ) ? NextWorkMs() : 0xFFFFFFFF;
+      if( lWorkMs < lTimeoutMs )
+      {
+         lTimeoutMs = lWorkMs;
+      }
 
-      /*
-      ** Switch 1 is node address for applicable networks
-      */
-      appl_iNwNodeAddress = iSwitchValue;
+      if( ( appl_iPendingEvents == 0 ) && ( lTimeoutMs > 0 ) )
+      {
+         ABCC_API_CONFIG_EVENT_WAIT( lTimeoutMs );
+      }
+   }
+#else
+   (void)lTimeoutMs;
+#endif
+
+   return( ABCC_API_Run() );
+}
+
+void ABCC_API_SignalEvent( void )
+{
+#ifdef ABCC_API_CONFIG_EVENT_SIGNAL
+   ABCC_API_CONFIG_EVENT_SIGNAL();
+#endif
+}
 
+#ifdef ABCC_API_CONFIG_GET_TIME_US
+ABCC_ErrorCodeType ABCC_API_RunCycle( void )
+{
+   ABCC_ErrorCodeType eErrorCode;
+   UINT32 lPeriodUs;
+   UINT32 lElapsedUs;
+
+   if( appl_eAbccHandlerState != ABCC_API_RUN )
+   {
+      return( RunHandler( TRUE ) );
+   }
+
+   lPeriodUs = appl_lCyclePeriodUs;
+#if SYNC_OBJ_ENABLE
+   if( lPeriodUs == 0 )
+   {
       /*
-      ** Indicate to application that the address will be set.
+      ** The SYNC object cycle time is in nanoseconds.
       */
-      return TRUE;
+      lPeriodUs = ABCC_CbfSyncObjCycleTime_Get() / 1000;
    }
+#endif
+
+   appl_lCycleStartUs = ABCC_API_CONFIG_GET_TIME_US();
+
    /*
-   ** If post-SETUP state and new value differs from active value.
+   ** Process data first, the message work gets what is left of the cycle.
    */
-   else if( appl_iNwNodeAddress != iSwitchValue )
+   ABCC_API_RunProcessData();
+
+   if( lPeriodUs != 0 )
    {
-     /*
-     ** Start command sequence to update address if the value has changed.
-     */
-     appl_sIpSettings.sAddress.uValue.abValue[ 3 ] = (UINT8)iSwitchValue;
-     appl_iNwNodeAddress = iSwitchValue;
-     appl_fSetAddrInProgress = TRUE;
-     ABCC_CmdSeqAdd( appl_asAddressChangedCmdSeq, UpdateAddressDone, NULL, NULL );
+      appl_lCycleBudgetUs = ( lPeriodUs > ABCC_API_CYCLE_MARGIN_US ) ?
+                            ( lPeriodUs - ABCC_API_CYCLE_MARGIN_US ) : 0;
+      appl_fCycleDeferred = FALSE;
+      appl_fCycleBudgetActive = TRUE;
+   }
 
-      /*
-      ** Indicate to application that the address will be set.
-      */
-      return TRUE;
+   eErrorCode = RunHandler( FALSE );
+   appl_fCycleBudgetActive = FALSE;
+
+   lElapsedUs = (UINT32)( ABCC_API_CONFIG_GET_TIME_US() - appl_lCycleStartUs );
+
+   appl_sCycleStats.lCycles++;
+   appl_sCycleStats.lLastElapsedUs = lElapsedUs;
+   if( lElapsedUs > appl_sCycleStats.lMaxElapsedUs )
+   {
+      appl_sCycleStats.lMaxElapsedUs = lElapsedUs;
+   }
+
+   if( ( lPeriodUs != 0 ) && ( lElapsedUs > lPeriodUs ) )
+   {
+      appl_sCycleStats.lOverruns++;
+#ifdef ABCC_API_CONFIG_CYCLE_OVERRUN_NOTIFY
+      ABCC_API_CONFIG_CYCLE_OVERRUN_NOTIFY( lElapsedUs, lPeriodUs );
+#endif
+   }
+
+   return( eErrorCode );
+}
+
+void ABCC_API_SetCyclePeriod( UINT32 lPeriodUs )
+{
+   appl_lCyclePeriodUs = lPeriodUs;
+}
+
+void ABCC_API_GetCycleStats( ABCC_API_CycleStatsType* psStats, BOOL fReset )
+{
+   if( psStats != NULL )
+   {
+      *psStats = appl_sCycleStats;
+   }
+
+   if( fReset )
+   {
+      memset( &appl_sCycleStats, 0, sizeof( appl_sCycleStats ) );
    }
+}
+#endif
+
+BOOL ABCC_API_SetAddress( UINT16 iSwitchValue )
+{
+   UINT8 abIpAddress[ 4 ];
+
+   /*
+   ** HW switch 1 will the last octet in the IP address
+   ** for applicable networks ( 192.168.0.X )
+   */
+   ABCC_API_NcGetValue( ABCC_API_NC_IP_ADDRESS, abIpAddress );
+   abIpAddress[ 3 ] = (UINT8)iSwitchValue;
+   ABCC_API_NcSetValue( ABCC_API_NC_IP_ADDRESS, abIpAddress );
+
+   /*
+   ** Switch 1 is node address for applicable networks
+   */
+   ABCC_API_NcSetValue( ABCC_API_NC_NODE_ADDRESS, &iSwitchValue );
+
+   /*
+   ** The rest of the IP settings are written along with the address.
+   */
+   ABCC_API_NcSetValue( ABCC_API_NC_NETMASK, NULL );
+   ABCC_API_NcSetValue( ABCC_API_NC_GATEWAY, NULL );
+   ABCC_API_NcSetValue( ABCC_API_NC_DHCP, NULL );
+
+   /*
+   ** Before the user init request the values are only stored. After it, the
+   ** ones that differ from the CompactCom's are written by the next
+   ** ABCC_API_Run(), or when the update in progress is done.
+   */
+   appl_fNcApplyRequested = TRUE;
+
    /*
-   ** Indicate to application that the address is already set to the requested value.
+   ** Indicate to application that the address will be set.
    */
    return TRUE;
 }
 
 BOOL ABCC_API_SetBaudrate( UINT8 bSwitchValue )
 {
-   if( appl_fSetBaudRateInProgress )
+   ABCC_API_NcSetValue( ABCC_API_NC_BAUD_RATE, &bSwitchValue );
+   appl_fNcApplyRequested = TRUE;
+
+   return TRUE;
+}
+
+void ABCC_API_SetCommSettings( ABCC_API_CommSettingType eCommSettings1,
+                               ABCC_API_CommSettingType eCommSettings2 )
+{
+   UINT8 bCommSetting;
+
+   bCommSetting = (UINT8)eCommSettings1;
+   ABCC_API_NcSetValue( ABCC_API_NC_COMM_SETTING_1, &bCommSetting );
+   bCommSetting = (UINT8)eCommSettings2;
+   ABCC_API_NcSetValue( ABCC_API_NC_COMM_SETTING_2, &bCommSetting );
+   appl_fNcApplyRequested = TRUE;
+}
+
+BOOL ABCC_API_SetIpSettings( const ABCC_API_IpSettingsType* psSettings )
+{
+   UINT8 bDhcp;
+
+   if( psSettings == NULL )
    {
-      /*
-      ** Baud rate updated next time
-      */
       return FALSE;
    }
 
-   if( appl_fUserInitPrepDone == FALSE )
+   /*
+   ** The host name is the only setting that can be refused, take it first
+   ** so that nothing is changed if it is.
+   */
+   if( ( psSettings->pcHostName != NULL ) &&
+       ( !ABCC_API_NcSetString( ABCC_API_NC_HOST_NAME, psSettings->pcHostName ) ) )
    {
-      appl_bNwBaudRate = bSwitchValue;
+      return FALSE;
    }
-   else if( appl_bNwBaudRate != bSwitchValue )
+
+   bDhcp = psSettings->fDhcp ? TRUE : FALSE;
+   ABCC_API_NcSetValue( ABCC_API_NC_IP_ADDRESS, psSettings->abAddress );
+   ABCC_API_NcSetValue( ABCC_API_NC_NETMASK, psSettings->abNetmask );
+   ABCC_API_NcSetValue( ABCC_API_NC_GATEWAY, psSettings->abGateway );
+   ABCC_API_NcSetValue( ABCC_API_NC_DHCP, &bDhcp );
+
+   if( psSettings->fSetDns )
    {
-      /*
-      ** Start command sequence to update baud rate if the value has changed.
-      */
-      appl_bNwBaudRate = bSwitchValue;
-      ABCC_CmdSeqAdd( appl_asBaudRateChangedCmdSeq, UpdateBaudRateDone, NULL, NULL );
+      ABCC_API_NcSetValue( ABCC_API_NC_DNS_1, psSettings->abDns1 );
+      ABCC_API_NcSetValue( ABCC_API_NC_DNS_2, psSettings->abDns2 );
    }
-   appl_fSetBaudRate = TRUE;
+
+   /*
+   ** Written together by the next ABCC_API_Run(), see ABCC_API_SetAddress().
+   */
+   appl_fNcApplyRequested = TRUE;
+
    return TRUE;
 }
 
-void ABCC_API_SetCommSettings( ABCC_API_CommSettingType eCommSettings1,
-                               ABCC_API_CommSettingType eCommSettings2 )
+ABCC_API_IpSettingsStatusType ABCC_API_GetIpSettingsStatus( void )
 {
-   if( appl_fSetCommSettingsInProgress )
+   static const ABCC_API_NcSettingType aeIpSetting[] =
    {
-      /*
-      ** Comm settings updated next time
-      */
-      return;
-   }
+      ABCC_API_NC_IP_ADDRESS,
+      ABCC_API_NC_NETMASK,
+      ABCC_API_NC_GATEWAY,
+      ABCC_API_NC_DHCP,
+      ABCC_API_NC_DNS_1,
+      ABCC_API_NC_DNS_2,
+      ABCC_API_NC_HOST_NAME
+   };
+   ABCC_API_IpSettingsStatusType eStatus;
+   UINT8                         bIndex;
 
-   if( appl_fUserInitPrepDone == FALSE )
-   {
-      appl_eCommSettings1 = eCommSettings1;
-      appl_eCommSettings2 = eCommSettings2;
-   }
-   else if( ( appl_eCommSettings1 != eCommSettings1 ) ||
-            ( appl_eCommSettings2 != eCommSettings2 ) )
+   eStatus = ABCC_API_IP_SETTINGS_VERIFIED;
+
+   for( bIndex = 0; bIndex < sizeof( aeIpSetting ) / sizeof( aeIpSetting[ 0 ] ); bIndex++ )
    {
-      /*
-      ** Start command sequence to update Comm settings if values have changed.
-      */
-      appl_eCommSettings1 = eCommSettings1;
-      appl_eCommSettings2 = eCommSettings2;
-      appl_fSetCommSettingsInProgress = TRUE;
-      ABCC_CmdSeqAdd( appl_asCommSettingsChangedCmdSeq, UpdateCommSettingsDone, NULL, NULL );
+      switch( ABCC_API_NcGetStatus( aeIpSetting[ bIndex ] ) )
+      {
+      case ABCC_API_NC_STATUS_FAILED:
+         return( ABCC_API_IP_SETTINGS_FAILED );
+
+      case ABCC_API_NC_STATUS_PENDING:
+         eStatus = ABCC_API_IP_SETTINGS_PENDING;
+         break;
+
+      default:
+         break;
+      }
    }
-   appl_fSetCommSettings = TRUE;
+
+   return( eStatus );
 }
 
 void ABCC_API_Shutdown( void )
@@ -1024,9 +1127,28 @@ void ABCC_API_Shutdown( void )
 
 void ABCC_API_Restart( void )
 {
+   appl_fWarmStart = FALSE;
+   appl_eAbccHandlerState = ABCC_API_RESTART;
+}
+
+void ABCC_API_WarmRestart( void )
+{
+   appl_fWarmStart = TRUE;
+   appl_eAbccHandlerState = ABCC_API_RESTART;
+}
+
+void ABCC_API_RestartForFirmwareUpdate( void )
+{
+   appl_fWarmStart = FALSE;
+   appl_fFwUpdatePending = TRUE;
    appl_eAbccHandlerState = ABCC_API_RESTART;
 }
 
+UINT32 ABCC_API_GetLastStartupTimeMs( void )
+{
+   return( appl_lLastStartupTimeMs );
+}
+
 #if ABCC_CFG_SPI_DYNAMIC_MSG_FRAG_LEN
 ABCC_ErrorCodeType ABCC_API_SetMsgFragSize( const UINT16 iReqMsgFragSize )
 {
@@ -1052,6 +1174,15 @@ UINT16  ABCC_CbfAdiMappingReq( const AD_AdiEntryType**  const ppsAdiEntry,
 
 BOOL ABCC_CbfUpdateWriteProcessData( void* pxWritePd )
 {
+#if ABCC_API_SYNC_PIPELINE_ENABLE
+   /*
+   ** Outputs sent from the sync ISR are already serialised.
+   */
+   if( ABCC_API_SyncPipelineCopyOutputs( pxWritePd ) )
+   {
+      return( TRUE );
+   }
+#endif
 
    /*
    ** AD_UpdatePdWriteData is a general function that updates all ADI:s according
@@ -1066,11 +1197,23 @@ BOOL ABCC_CbfUpdateWriteProcessData( void* pxWritePd )
 void ABCC_CbfRemapDone( void )
 {
    AD_RemapDone();
+#if ABCC_API_SYNC_PIPELINE_ENABLE
+   ABCC_API_SyncPipelineReset();
+#endif
 }
 #endif
 
 void ABCC_CbfNewReadPd( void* pxReadPd )
 {
+#if ABCC_API_SYNC_PIPELINE_ENABLE
+   /*
+   ** In sync mode the inputs are held until the next sync event.
+   */
+   if( ABCC_API_SyncPipelineStoreInputs( pxReadPd ) )
+   {
+      return;
+   }
+#endif
    /*
    ** AD_UpdatePdReadData is a general function that updates all ADI:s according
    ** to current map.
@@ -1116,6 +1259,10 @@ void ABCC_CbfWdTimeoutRecovered( void )
 #if ABCC_CFG_SYNC_ENABLED
 void ABCC_CbfSyncIsr( void )
 {
+#if ABCC_API_SYNC_PIPELINE_ENABLE
+   ABCC_API_SyncPipelineSyncEvent();
+#endif
+
    /*
    ** Call application specific handling of sync event
    */
@@ -1142,31 +1289,64 @@ void ABCC_API_SetAppStatus( ABP_AppStatusType eAppStatus )
 #if ABCC_CFG_INT_ENABLED
 void ABCC_CbfEvent( UINT16 iEvents )
 {
+   ABCC_PORT_UseCritical();
 
    /*
-   ** Set flag to indicate that an event has occurred and the corresponding
+   ** Set the event bits to indicate that the corresponding
    ** ABCC_Trigger<event_action> must be called. In the sample code the the
    ** trigger function is called from main loop context.
    */
+   ABCC_PORT_EnterCritical();
+
+   appl_iPendingEvents |= iEvents;
+
    if( iEvents & ABCC_ISR_EVENT_RDPD )
    {
-      appl_fRdPdReceivedEvent = TRUE;
+      appl_sEventStats.sRdPd.lSignalled++;
    }
 
    if( iEvents & ABCC_ISR_EVENT_RDMSG )
    {
-      appl_fMsgReceivedEvent = TRUE;
+      appl_sEventStats.sRdMsg.lSignalled++;
    }
 
    if( iEvents & ABCC_ISR_EVENT_WRMSG )
    {
-      appl_fTransmitMsgEvent = TRUE;
+      appl_sEventStats.sWrMsg.lSignalled++;
+   }
+
+   if( iEvents & ABCC_ISR_EVENT_STATUS )
+   {
+      appl_sEventStats.sStatus.lSignalled++;
+   }
+
+   ABCC_PORT_ExitCritical();
+
+   /*
+   ** Wake up ABCC_API_RunUntilEvent().
+   */
+#ifdef ABCC_API_CONFIG_EVENT_SIGNAL
+   ABCC_API_CONFIG_EVENT_SIGNAL();
+#endif
+}
+
+void ABCC_API_GetEventStats( ABCC_API_EventStatsType* psStats, BOOL fReset )
+{
+   ABCC_PORT_UseCritical();
+
+   ABCC_PORT_EnterCritical();
+
+   if( psStats != NULL )
+   {
+      *psStats = appl_sEventStats;
    }
 
-   if( iEvents & ABCC_ISR_EVENT_STATUS  )
+   if( fReset )
    {
-      appl_fAbccStatusEvent = TRUE;
+      memset( &appl_sEventStats, 0, sizeof( appl_sEventStats ) );
    }
+
+   ABCC_PORT_ExitCritical();
 }
 #endif
 
@@ -1193,12 +1373,19 @@ void ABCC_CbfAnbStateChanged( ABP_AnbStateType eNewAnbState )
    case ABP_ANB_STATE_PROCESS_ACTIVE:
 
       ABCC_TriggerWrPdUpdate();
+
+      if( appl_fStartupTimeRunning )
+      {
+         appl_fStartupTimeRunning = FALSE;
+         appl_lLastStartupTimeMs = appl_lStartupTimeMs;
+         ABCC_LOG_INFO( "PROCESS_ACTIVE %" PRIu32 " ms after start\n", appl_lLastStartupTimeMs );
+      }
       break;
 
    case ABP_ANB_STATE_EXCEPTION:
 
       /* Trigger message sequence for reading exception data */
-      ABCC_CmdSeqAdd( appl_asReadExeptionCmdSeq, NULL, NULL, NULL );
+      ABCC_API_MsgSchedAddControlSeq( appl_asReadExeptionCmdSeq, NULL );
       break;
 
    default:
@@ -1213,53 +1400,17 @@ void ABCC_CbfAnbStateChanged( ABP_AnbStateType eNewAnbState )
 
 void ABCC_CbfUserInitReq( void )
 {
-   UINT16 iNetworkType;
-   iNetworkType = ABCC_NetworkType();
-
-   if( ( iNetworkType == ABP_NW_TYPE_DEV ) ||
-       ( iNetworkType == ABP_NW_TYPE_PDPV0 ) ||
-       ( iNetworkType == ABP_NW_TYPE_PDPV1 ) ||
-       ( iNetworkType == ABP_NW_TYPE_COP ) ||
-       ( iNetworkType == ABP_NW_TYPE_CNT ) ||
-       ( iNetworkType == ABP_NW_TYPE_CCL ) ||
-       ( iNetworkType == ABP_NW_TYPE_CFN ) ||
-       ( iNetworkType == ABP_NW_TYPE_CPN ) ||
-       ( iNetworkType == ABP_NW_TYPE_ECT ) ||
-       ( iNetworkType == ABP_NW_TYPE_EPL ) )
-   {
-      appl_fNwSupportsNodeId = TRUE;
-      appl_fNwSupportsDhcp = FALSE;
-   }
-   else
-   {
-      appl_fNwSupportsNodeId = FALSE;
-      appl_fNwSupportsDhcp = TRUE;
-   }
-
-   if( ( iNetworkType == ABP_NW_TYPE_DEV ) ||
-       ( iNetworkType == ABP_NW_TYPE_COP ) ||
-       ( iNetworkType == ABP_NW_TYPE_CCL ) )
-   {
-      appl_fNwSupportsBaudRate = TRUE;
-   }
-   else
-   {
-      appl_fNwSupportsBaudRate = FALSE;
-   }
-
-   if( iNetworkType == ABP_NW_TYPE_CIET )
-   {
-      appl_fNwSupportsCommSettings = TRUE;
-      appl_fNwSupportsDhcp = FALSE;
-   }
-   else
-   {
-      appl_fNwSupportsCommSettings = FALSE;
-   }
-
    /*
-   ** Start user init preparation command sequence
+   ** Write the network settings given by the application that differ from
+   ** the CompactCom's, the user init preparation is done when they are
+   ** written. The flag is set first since there may be nothing to write.
    */
-   ABCC_CmdSeqAdd( appl_asUserInitPrepCmdSeq, UserInitPrepDone, NULL, NULL );
+   ABCC_API_NcSetNetworkType( ABCC_NetworkType() );
 
+   appl_fNcUserInitPending = TRUE;
+   if( !ABCC_API_NcApply() )
+   {
+      appl_fNcUserInitPending = FALSE;
+      UserInitPrepDone( ABCC_CMDSEQ_RESULT_COMPLETED, NULL );
+   }
 }
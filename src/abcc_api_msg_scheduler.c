@@ -0,0 +1,295 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Message scheduler sharing the command message channel between latency
+** sensitive control sequences and bulk FSI traffic. See
+** abcc_api_msg_scheduler.h for a description.
+********************************************************************************
+*/
+
+#include "abcc_types.h"
+#include "abcc_api_config.h"
+#include "abcc.h"
+#include "abcc_log.h"
+#include "abcc_command_sequencer_interface.h"
+
+#include "abcc_api_msg_scheduler.h"
+
+/*******************************************************************************
+** Private typedefs
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Control sequence waiting for a free control slot.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   const ABCC_CmdSeqType*  pasCmdSeq;
+   ABCC_CmdSeqDoneHandler  pnCmdSeqDone;
+}
+appl_PendingControlSeqType;
+
+/*------------------------------------------------------------------------------
+** Control sequence in flight.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   BOOL                    fInUse;
+   ABCC_CmdSeqDoneHandler  pnCmdSeqDone;
+}
+appl_ActiveControlSeqType;
+
+/*******************************************************************************
+** Private Globals
+********************************************************************************
+*/
+
+static appl_ActiveControlSeqType appl_asActiveControlSeq[ ABCC_API_MSG_CONTROL_QUOTA ];
+static UINT8 appl_bActiveControlCount;
+
+static appl_PendingControlSeqType appl_asPendingControlSeq[ ABCC_API_MSG_CONTROL_QUEUE_SIZE ];
+static UINT8 appl_bPendingControlHead;
+static UINT8 appl_bPendingControlCount;
+
+/*------------------------------------------------------------------------------
+** Number of bulk messages in flight and the time bulk traffic has been held
+** back by control sequences.
+**------------------------------------------------------------------------------
+*/
+static UINT8 appl_bBulkInFlight;
+static BOOL appl_fBulkWaiting;
+static UINT32 appl_lBulkWaitMs;
+
+/*******************************************************************************
+** Private Services
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Done handler for all control sequences started by the scheduler. Frees the
+** control slot and forwards the result to the original done handler.
+**
+** This function is a part of a command sequence. See description of
+** ABCC_CmdSeqDoneHandler type in abcc_command_sequencer_interface.h
+**------------------------------------------------------------------------------
+*/
+static void ControlSeqDone( const ABCC_CmdSeqResultType eSeqResult, void* pxUserData )
+{
+   appl_ActiveControlSeqType* psSlot;
+   ABCC_CmdSeqDoneHandler     pnCmdSeqDone;
+
+   psSlot = (appl_ActiveControlSeqType*)pxUserData;
+   pnCmdSeqDone = psSlot->pnCmdSeqDone;
+
+   psSlot->fInUse = FALSE;
+   psSlot->pnCmdSeqDone = NULL;
+   appl_bActiveControlCount--;
+
+   if( pnCmdSeqDone != NULL )
+   {
+      pnCmdSeqDone( eSeqResult, NULL );
+   }
+}
+
+/*------------------------------------------------------------------------------
+** Start a control sequence in a free control slot.
+**------------------------------------------------------------------------------
+** Arguments:
+**    pasCmdSeq    - Command sequence.
+**    pnCmdSeqDone - Original done handler.
+** Returns:
+**    TRUE if the sequence was started.
+**------------------------------------------------------------------------------
+*/
+static BOOL StartControlSeq( const ABCC_CmdSeqType* pasCmdSeq,
+                             const ABCC_CmdSeqDoneHandler pnCmdSeqDone )
+{
+   UINT8 bIndex;
+
+   for( bIndex = 0; bIndex < ABCC_API_MSG_CONTROL_QUOTA; bIndex++ )
+   {
+      if( !appl_asActiveControlSeq[ bIndex ].fInUse )
+      {
+         break;
+      }
+   }
+
+   if( bIndex == ABCC_API_MSG_CONTROL_QUOTA )
+   {
+      return( FALSE );
+   }
+
+   appl_asActiveControlSeq[ bIndex ].fInUse = TRUE;
+   appl_asActiveControlSeq[ bIndex ].pnCmdSeqDone = pnCmdSeqDone;
+   appl_bActiveControlCount++;
+
+   if( ABCC_CmdSeqAdd( pasCmdSeq,
+                       ControlSeqDone,
+                       &appl_asActiveControlSeq[ bIndex ],
+                       NULL ) != ABCC_EC_NO_ERROR )
+   {
+      appl_asActiveControlSeq[ bIndex ].fInUse = FALSE;
+      appl_asActiveControlSeq[ bIndex ].pnCmdSeqDone = NULL;
+      appl_bActiveControlCount--;
+
+      return( FALSE );
+   }
+
+   return( TRUE );
+}
+
+/*******************************************************************************
+** Public Services
+********************************************************************************
+*/
+
+void ABCC_API_MsgSchedInit( void )
+{
+   UINT8 bIndex;
+
+   for( bIndex = 0; bIndex < ABCC_API_MSG_CONTROL_QUOTA; bIndex++ )
+   {
+      appl_asActiveControlSeq[ bIndex ].fInUse = FALSE;
+      appl_asActiveControlSeq[ bIndex ].pnCmdSeqDone = NULL;
+   }
+
+   appl_bActiveControlCount = 0;
+   appl_bPendingControlHead = 0;
+   appl_bPendingControlCount = 0;
+
+   appl_bBulkInFlight = 0;
+   appl_fBulkWaiting = FALSE;
+   appl_lBulkWaitMs = 0;
+}
+
+void ABCC_API_MsgSchedAddControlSeq( const ABCC_CmdSeqType* pasCmdSeq,
+                                     const ABCC_CmdSeqDoneHandler pnCmdSeqDone )
+{
+   appl_PendingControlSeqType* psPending;
+
+   /*
+   ** Keep the order of the control sequences, only start right away if
+   ** nothing is waiting.
+   */
+   if( ( appl_bPendingControlCount == 0 ) &&
+       StartControlSeq( pasCmdSeq, pnCmdSeqDone ) )
+   {
+      return;
+   }
+
+   if( appl_bPendingControlCount >= ABCC_API_MSG_CONTROL_QUEUE_SIZE )
+   {
+      /*
+      ** The sequence is not started. Report it as aborted so that the owner
+      ** does not wait for it.
+      */
+      ABCC_LOG_WARNING( ABCC_EC_NO_RESOURCES, 0, "Control sequence queue full\n" );
+
+      if( pnCmdSeqDone != NULL )
+      {
+         pnCmdSeqDone( ABCC_CMDSEQ_RESULT_ABORT_INT, NULL );
+      }
+      return;
+   }
+
+   psPending = &appl_asPendingControlSeq[ ( appl_bPendingControlHead + appl_bPendingControlCount ) % ABCC_API_MSG_CONTROL_QUEUE_SIZE ];
+   psPending->pasCmdSeq = pasCmdSeq;
+   psPending->pnCmdSeqDone = pnCmdSeqDone;
+   appl_bPendingControlCount++;
+}
+
+BOOL ABCC_API_MsgSchedAcquireBulk( void )
+{
+   if( appl_bBulkInFlight >= ABCC_API_MSG_BULK_QUOTA )
+   {
+      return( FALSE );
+   }
+
+   if( !ABCC_API_MsgSchedBulkAvailable() )
+   {
+      appl_fBulkWaiting = TRUE;
+      return( FALSE );
+   }
+
+   appl_fBulkWaiting = FALSE;
+   appl_lBulkWaitMs = 0;
+   appl_bBulkInFlight++;
+
+   return( TRUE );
+}
+
+void ABCC_API_MsgSchedReleaseBulk( void )
+{
+   if( appl_bBulkInFlight > 0 )
+   {
+      appl_bBulkInFlight--;
+   }
+}
+
+void ABCC_API_MsgSchedRun( void )
+{
+   appl_PendingControlSeqType* psPending;
+
+   while( appl_bPendingControlCount > 0 )
+   {
+      psPending = &appl_asPendingControlSeq[ appl_bPendingControlHead ];
+
+      if( !StartControlSeq( psPending->pasCmdSeq, psPending->pnCmdSeqDone ) )
+      {
+         break;
+      }
+
+      appl_bPendingControlHead = ( appl_bPendingControlHead + 1 ) % ABCC_API_MSG_CONTROL_QUEUE_SIZE;
+      appl_bPendingControlCount--;
+   }
+}
+
+void ABCC_API_MsgSchedRunTimer( const INT16 iDeltaTimeMs )
+{
+   if( appl_fBulkWaiting && ( iDeltaTimeMs > 0 ) )
+   {
+      appl_lBulkWaitMs += (UINT32)iDeltaTimeMs;
+   }
+}
+
+BOOL ABCC_API_MsgSchedBulkAvailable( void )
+{
+   if( appl_bBulkInFlight >= ABCC_API_MSG_BULK_QUOTA )
+   {
+      return( FALSE );
+   }
+
+   if( ( ( appl_bActiveControlCount > 0 ) ||
+         ( appl_bPendingControlCount > 0 ) ) &&
+       ( appl_lBulkWaitMs < ABCC_API_MSG_BULK_MAX_WAIT_MS ) )
+   {
+      return( FALSE );
+   }
+
+   return( TRUE );
+}
+
+UINT32 ABCC_API_MsgSchedNextRunMs( void )
+{
+   if( ( appl_bPendingControlCount > 0 ) &&
+       ( appl_bActiveControlCount < ABCC_API_MSG_CONTROL_QUOTA ) )
+   {
+      return( 0 );
+   }
+
+   /*
+   ** Once the wait is over, the bulk sender itself reports that it can go on.
+   */
+   if( appl_fBulkWaiting &&
+       ( appl_lBulkWaitMs < ABCC_API_MSG_BULK_MAX_WAIT_MS ) )
+   {
+      return( ABCC_API_MSG_BULK_MAX_WAIT_MS - appl_lBulkWaitMs );
+   }
+
+   return( 0xFFFFFFFF );
+}
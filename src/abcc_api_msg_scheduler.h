@@ -0,0 +1,134 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Header file for the message scheduler of the ABCC API.
+**
+** Command messages sent by the API are divided into two classes:
+**
+**    Control - Short command sequences started by the ABCC handler, e.g. the
+**              user init preparation, address updates and reading the
+**              exception information. Latency sensitive.
+**    Bulk    - File System Interface commands, e.g. file and firmware
+**              transfers. Throughput oriented.
+**
+** Each class has a quota of messages in flight. Bulk messages are also held
+** back while control sequences are active or waiting, so that a file
+** transfer never holds more than ABCC_API_MSG_BULK_QUOTA command buffers when
+** a control sequence needs one. To keep bulk traffic from being starved by a
+** steady stream of control sequences, one bulk message is let through when
+** bulk traffic has been held back for ABCC_API_MSG_BULK_MAX_WAIT_MS.
+********************************************************************************
+*/
+
+#ifndef ABCC_API_MSG_SCHEDULER_H_
+#define ABCC_API_MSG_SCHEDULER_H_
+
+#include "abcc_types.h"
+#include "abcc_api_config.h"
+#include "abcc_command_sequencer_interface.h"
+
+/*------------------------------------------------------------------------------
+** Clear all scheduler bookkeeping. Called when the CompactCom is (re)started.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+void ABCC_API_MsgSchedInit( void );
+
+/*------------------------------------------------------------------------------
+** Start a control class command sequence. If the control quota is used up the
+** sequence is started later from ABCC_API_MsgSchedRun(), in the order the
+** sequences were added. If the queue is full as well the sequence is dropped
+** and pnCmdSeqDone is called with ABCC_CMDSEQ_RESULT_ABORT_INT before this
+** function returns.
+**------------------------------------------------------------------------------
+** Arguments:
+**    pasCmdSeq    - Command sequence, see ABCC_CmdSeqAdd().
+**    pnCmdSeqDone - Done handler, may be NULL. Called with NULL as user data.
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+void ABCC_API_MsgSchedAddControlSeq( const ABCC_CmdSeqType* pasCmdSeq,
+                                     const ABCC_CmdSeqDoneHandler pnCmdSeqDone );
+
+/*------------------------------------------------------------------------------
+** Ask for permission to send a bulk class command message. Every granted
+** message must be followed by a call to ABCC_API_MsgSchedReleaseBulk() when
+** its response has arrived, or when it could not be sent after all.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    TRUE if the message may be sent now.
+**------------------------------------------------------------------------------
+*/
+BOOL ABCC_API_MsgSchedAcquireBulk( void );
+
+/*------------------------------------------------------------------------------
+** Release a bulk slot granted by ABCC_API_MsgSchedAcquireBulk().
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+void ABCC_API_MsgSchedReleaseBulk( void );
+
+/*------------------------------------------------------------------------------
+** Start control sequences that are waiting for a free slot. Called from
+** ABCC_API_Run() before any bulk messages are dispatched.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+void ABCC_API_MsgSchedRun( void );
+
+/*------------------------------------------------------------------------------
+** Advance the time used for the bulk starvation protection. Called from
+** ABCC_API_RunTimerSystem().
+**------------------------------------------------------------------------------
+** Arguments:
+**    iDeltaTimeMs - Milliseconds since the last call.
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+void ABCC_API_MsgSchedRunTimer( const INT16 iDeltaTimeMs );
+
+/*------------------------------------------------------------------------------
+** Tell if a bulk class message would be granted right now, without asking
+** for it.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    TRUE if ABCC_API_MsgSchedAcquireBulk() would return TRUE.
+**------------------------------------------------------------------------------
+*/
+BOOL ABCC_API_MsgSchedBulkAvailable( void );
+
+/*------------------------------------------------------------------------------
+** Time until the scheduler has work that does not wait for a response from
+** the ABCC. Used by ABCC_API_RunUntilEvent() to limit its wait.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    0 if a waiting control sequence can be started now, the time left until
+**    held back bulk traffic is let through, or 0xFFFFFFFF if nothing waits
+**    for either.
+**------------------------------------------------------------------------------
+*/
+UINT32 ABCC_API_MsgSchedNextRunMs( void );
+
+#endif
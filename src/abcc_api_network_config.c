@@ -0,0 +1,868 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Network configuration engine writing the Network Configuration object
+** instances from a table. See abcc_api_network_config.h for a description.
+********************************************************************************
+*/
+
+#include <string.h>
+#include <inttypes.h>
+
+#include "abcc_types.h"
+#include "abcc_api_config.h"
+#include "abp.h"
+#include "abcc.h"
+#include "abcc_log.h"
+#include "abcc_command_sequencer_interface.h"
+
+#include "abcc_api_network_settings.h"
+#include "abcc_api_msg_scheduler.h"
+#include "abcc_api_network_config.h"
+
+/*******************************************************************************
+** Defines
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Network Configuration object instances not defined by abp.h.
+**------------------------------------------------------------------------------
+*/
+#define APPL_NC_INST_IP_ADDRESS        3
+#define APPL_NC_INST_NETMASK           4
+#define APPL_NC_INST_GATEWAY           5
+#define APPL_NC_INST_DHCP              6
+#define APPL_NC_INST_COMM_SETTING_1    7
+#define APPL_NC_INST_COMM_SETTING_2    8
+#define APPL_NC_INST_DNS_1             9
+#define APPL_NC_INST_DNS_2             10
+#define APPL_NC_INST_HOST_NAME         11
+
+/*------------------------------------------------------------------------------
+** Groups of settings a network type may support.
+**------------------------------------------------------------------------------
+*/
+#define APPL_NC_NW_NODE_ID             0x01
+#define APPL_NC_NW_BAUD_RATE           0x02
+#define APPL_NC_NW_IP                  0x04
+#define APPL_NC_NW_DHCP                0x08
+#define APPL_NC_NW_COMM_SETTINGS       0x10
+#define APPL_NC_NW_DNS                 0x20
+
+/*------------------------------------------------------------------------------
+** Groups supported by network types not listed in appl_asNcNetwork.
+**------------------------------------------------------------------------------
+*/
+#define APPL_NC_NW_DEFAULT             ( APPL_NC_NW_IP | APPL_NC_NW_DHCP | APPL_NC_NW_DNS )
+
+/*------------------------------------------------------------------------------
+** Offset of each value in the value buffers, see appl_abNcValue.
+**------------------------------------------------------------------------------
+*/
+#define APPL_NC_IPV4_SIZEOF            4
+
+#define APPL_NC_OFS_NODE_ADDRESS       ( 0 )
+#define APPL_NC_OFS_BAUD_RATE          ( APPL_NC_OFS_NODE_ADDRESS + ABP_UINT16_SIZEOF )
+#define APPL_NC_OFS_IP_ADDRESS         ( APPL_NC_OFS_BAUD_RATE + ABP_UINT8_SIZEOF )
+#define APPL_NC_OFS_NETMASK            ( APPL_NC_OFS_IP_ADDRESS + APPL_NC_IPV4_SIZEOF )
+#define APPL_NC_OFS_GATEWAY            ( APPL_NC_OFS_NETMASK + APPL_NC_IPV4_SIZEOF )
+#define APPL_NC_OFS_DHCP               ( APPL_NC_OFS_GATEWAY + APPL_NC_IPV4_SIZEOF )
+#define APPL_NC_OFS_COMM_SETTING_1     ( APPL_NC_OFS_DHCP + ABP_BOOL_SIZEOF )
+#define APPL_NC_OFS_COMM_SETTING_2     ( APPL_NC_OFS_COMM_SETTING_1 + ABP_ENUM_SIZEOF )
+#define APPL_NC_OFS_DNS_1              ( APPL_NC_OFS_COMM_SETTING_2 + ABP_ENUM_SIZEOF )
+#define APPL_NC_OFS_DNS_2              ( APPL_NC_OFS_DNS_1 + APPL_NC_IPV4_SIZEOF )
+#define APPL_NC_OFS_HOST_NAME          ( APPL_NC_OFS_DNS_2 + APPL_NC_IPV4_SIZEOF )
+#define APPL_NC_VALUE_BUFFER_SIZE      ( APPL_NC_OFS_HOST_NAME + ABCC_API_NC_HOST_NAME_MAX_LEN )
+
+/*
+** The size of a value is stored in one octet, see appl_NcSettingDescType.
+*/
+#if ( ABCC_API_NC_HOST_NAME_MAX_LEN > 255 )
+#error "ABCC_API_NC_HOST_NAME_MAX_LEN must not exceed 255"
+#endif
+
+/*******************************************************************************
+** Private typedefs
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Description of a setting.
+**
+** iInstance    - Network Configuration object instance.
+** bType        - ABP data type of the value attribute. ABP_CHAR settings are
+**                strings of 0 up to bSize characters, the others have a fixed
+**                size.
+** bSize        - Size of the value in octets.
+** iOffset      - Offset of the value in the value buffers.
+** bNetworks    - Group the setting belongs to, APPL_NC_NW_xxx.
+** fNonVolatile - TRUE if the CompactCom keeps the value over a restart. Such
+**                values are only written when they differ from the value
+**                read back from the CompactCom, and are read back again after
+**                being written. The others are written on every start.
+** pbDefault    - Value until the application sets one, NULL for all zeros.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   UINT16         iInstance;
+   UINT8          bType;
+   UINT8          bSize;
+   UINT16         iOffset;
+   UINT8          bNetworks;
+   BOOL           fNonVolatile;
+   const UINT8*   pbDefault;
+}
+appl_NcSettingDescType;
+
+/*------------------------------------------------------------------------------
+** Groups of settings supported by a network type.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   UINT16   iNetworkType;
+   UINT8    bNetworks;
+}
+appl_NcNetworkType;
+
+/*------------------------------------------------------------------------------
+** Command in flight for a setting.
+**------------------------------------------------------------------------------
+*/
+typedef enum appl_NcState
+{
+   APPL_NC_STATE_IDLE,
+   APPL_NC_STATE_READING,
+   APPL_NC_STATE_WRITING
+}
+appl_NcStateType;
+
+/*------------------------------------------------------------------------------
+** What is known about a setting in the CompactCom. The values are kept in
+** appl_abNcValue, appl_abNcSent and appl_abNcModule.
+**
+** bValueLength  - Length of the value requested by the application.
+** bSentLength   - Length of the value of the set command in flight.
+** bModuleLength - Length of the value held by the CompactCom, valid if fKnown
+**                 is set.
+** fSet          - The application has given a value to write.
+** fReadDone     - The value has been read back since the start.
+** fVerify       - The value has been written and is to be read back.
+** fFailed       - The CompactCom refused the value, or read back another
+**                 one. It is not written again until the application changes
+**                 it.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   UINT8             bValueLength;
+   UINT8             bSentLength;
+   UINT8             bModuleLength;
+   appl_NcStateType  eState;
+   BOOL              fSet;
+   BOOL              fKnown;
+   BOOL              fReadDone;
+   BOOL              fVerify;
+   BOOL              fFailed;
+}
+appl_NcEntryType;
+
+/*******************************************************************************
+** Private Globals
+********************************************************************************
+*/
+
+static const UINT8 appl_abNcDefaultIpAddress[] = ABCC_API_DEFAULT_IP_NETWORK_ADDRESS;
+static const UINT8 appl_abNcDefaultNetmask[] = ABCC_API_DEFAULT_NETMASK;
+static const UINT8 appl_abNcDefaultGateway[] = ABCC_API_DEFAULT_GATEWAY;
+static const UINT8 appl_abNcDefaultDhcp[] = ABCC_API_DEFAULT_DHCP_ENABLE;
+static const UINT8 appl_abNcDefaultCommSetting[] = { ABCC_API_DEFAULT_COMM_SETTING };
+
+/*------------------------------------------------------------------------------
+** The settings, indexed by ABCC_API_NcSettingType.
+**------------------------------------------------------------------------------
+*/
+static const appl_NcSettingDescType appl_asNcSetting[ ABCC_API_NC_NUM_SETTINGS ] =
+{
+   { ABP_NC_INST_NUM_SW1,         ABP_UINT16, ABP_UINT16_SIZEOF,   APPL_NC_OFS_NODE_ADDRESS,   APPL_NC_NW_NODE_ID,       FALSE, NULL },
+   { ABP_NC_INST_NUM_SW2,         ABP_UINT8,  ABP_UINT8_SIZEOF,    APPL_NC_OFS_BAUD_RATE,      APPL_NC_NW_BAUD_RATE,     FALSE, NULL },
+   { APPL_NC_INST_IP_ADDRESS,     ABP_OCTET,  APPL_NC_IPV4_SIZEOF, APPL_NC_OFS_IP_ADDRESS,     APPL_NC_NW_IP,            TRUE,  appl_abNcDefaultIpAddress },
+   { APPL_NC_INST_NETMASK,        ABP_OCTET,  APPL_NC_IPV4_SIZEOF, APPL_NC_OFS_NETMASK,        APPL_NC_NW_IP,            TRUE,  appl_abNcDefaultNetmask },
+   { APPL_NC_INST_GATEWAY,        ABP_OCTET,  APPL_NC_IPV4_SIZEOF, APPL_NC_OFS_GATEWAY,        APPL_NC_NW_IP,            TRUE,  appl_abNcDefaultGateway },
+   { APPL_NC_INST_DHCP,           ABP_BOOL,   ABP_BOOL_SIZEOF,     APPL_NC_OFS_DHCP,           APPL_NC_NW_DHCP,          TRUE,  appl_abNcDefaultDhcp },
+   { APPL_NC_INST_COMM_SETTING_1, ABP_ENUM,   ABP_ENUM_SIZEOF,     APPL_NC_OFS_COMM_SETTING_1, APPL_NC_NW_COMM_SETTINGS, TRUE,  appl_abNcDefaultCommSetting },
+   { APPL_NC_INST_COMM_SETTING_2, ABP_ENUM,   ABP_ENUM_SIZEOF,     APPL_NC_OFS_COMM_SETTING_2, APPL_NC_NW_COMM_SETTINGS, TRUE,  appl_abNcDefaultCommSetting },
+   { APPL_NC_INST_DNS_1,          ABP_OCTET,  APPL_NC_IPV4_SIZEOF, APPL_NC_OFS_DNS_1,          APPL_NC_NW_DNS,           TRUE,  NULL },
+   { APPL_NC_INST_DNS_2,          ABP_OCTET,  APPL_NC_IPV4_SIZEOF, APPL_NC_OFS_DNS_2,          APPL_NC_NW_DNS,           TRUE,  NULL },
+   { APPL_NC_INST_HOST_NAME,      ABP_CHAR,   ABCC_API_NC_HOST_NAME_MAX_LEN, APPL_NC_OFS_HOST_NAME, APPL_NC_NW_DNS,     TRUE,  NULL }
+};
+
+/*------------------------------------------------------------------------------
+** Network types supporting other groups than APPL_NC_NW_DEFAULT.
+**------------------------------------------------------------------------------
+*/
+static const appl_NcNetworkType appl_asNcNetwork[] =
+{
+   { ABP_NW_TYPE_DEV,   APPL_NC_NW_NODE_ID | APPL_NC_NW_BAUD_RATE },
+   { ABP_NW_TYPE_PDPV0, APPL_NC_NW_NODE_ID },
+   { ABP_NW_TYPE_PDPV1, APPL_NC_NW_NODE_ID },
+   { ABP_NW_TYPE_COP,   APPL_NC_NW_NODE_ID | APPL_NC_NW_BAUD_RATE },
+   { ABP_NW_TYPE_CNT,   APPL_NC_NW_NODE_ID },
+   { ABP_NW_TYPE_CCL,   APPL_NC_NW_NODE_ID | APPL_NC_NW_BAUD_RATE },
+   { ABP_NW_TYPE_CFN,   APPL_NC_NW_NODE_ID },
+   { ABP_NW_TYPE_CPN,   APPL_NC_NW_NODE_ID },
+   { ABP_NW_TYPE_ECT,   APPL_NC_NW_NODE_ID },
+   { ABP_NW_TYPE_EPL,   APPL_NC_NW_NODE_ID },
+   { ABP_NW_TYPE_CIET,  APPL_NC_NW_IP | APPL_NC_NW_COMM_SETTINGS }
+};
+
+#define APPL_NC_NUM_NETWORKS ( sizeof( appl_asNcNetwork ) / sizeof( appl_asNcNetwork[ 0 ] ) )
+
+/*------------------------------------------------------------------------------
+** Values requested by the application, values of the set commands in flight
+** and values held by the CompactCom. The requested values are set to the
+** defaults on first use and kept over restarts.
+**------------------------------------------------------------------------------
+*/
+static UINT8 appl_abNcValue[ APPL_NC_VALUE_BUFFER_SIZE ];
+static UINT8 appl_abNcSent[ APPL_NC_VALUE_BUFFER_SIZE ];
+static UINT8 appl_abNcModule[ APPL_NC_VALUE_BUFFER_SIZE ];
+static BOOL appl_fNcValueValid = FALSE;
+
+static appl_NcEntryType appl_asNcEntry[ ABCC_API_NC_NUM_SETTINGS ];
+
+/*------------------------------------------------------------------------------
+** Groups supported by the network type, 0 until the network type is known.
+**------------------------------------------------------------------------------
+*/
+static UINT8 appl_bNcNetworks = 0;
+
+/*------------------------------------------------------------------------------
+** Update in progress. appl_bNcWorkersLeft is the number of worker sequences
+** still running and appl_eNcResult the first result of a worker that was not
+** ABCC_CMDSEQ_RESULT_COMPLETED.
+**------------------------------------------------------------------------------
+*/
+static UINT8 appl_bNcWorkersLeft = 0;
+static ABCC_CmdSeqResultType appl_eNcResult;
+static ABCC_CmdSeqDoneHandler appl_pnNcApplyDone = NULL;
+
+/*******************************************************************************
+** Private Services
+********************************************************************************
+*/
+
+static ABCC_CmdSeqCmdStatusType NcNextCmd( ABP_MsgType* psMsg, void* pxUserData );
+static ABCC_CmdSeqRespStatusType NcHandleResp( ABP_MsgType* psMsg, void* pxUserData );
+
+/*------------------------------------------------------------------------------
+** Worker sequence. Each command takes the next setting that needs a command
+** and the response asks for the command to be executed again, until there is
+** nothing more to send. Several workers run in parallel and share the
+** settings between them. See abcc_command_sequencer_interface.h.
+**------------------------------------------------------------------------------
+*/
+static const ABCC_CmdSeqType appl_asNcWorkerCmdSeq[] =
+{
+   ABCC_CMD_SEQ( NcNextCmd, NcHandleResp ),
+   ABCC_CMD_SEQ_END()
+};
+
+/*------------------------------------------------------------------------------
+** Sets the requested values to the defaults the first time they are used.
+**------------------------------------------------------------------------------
+*/
+static void NcValueInit( void )
+{
+   const appl_NcSettingDescType* psDesc;
+   UINT8                         bSetting;
+
+   if( appl_fNcValueValid )
+   {
+      return;
+   }
+
+   memset( appl_abNcValue, 0, sizeof( appl_abNcValue ) );
+
+   for( bSetting = 0; bSetting < ABCC_API_NC_NUM_SETTINGS; bSetting++ )
+   {
+      psDesc = &appl_asNcSetting[ bSetting ];
+
+      if( psDesc->pbDefault != NULL )
+      {
+         memcpy( &appl_abNcValue[ psDesc->iOffset ], psDesc->pbDefault, psDesc->bSize );
+      }
+
+      appl_asNcEntry[ bSetting ].bValueLength = ( psDesc->bType == ABP_CHAR ) ? 0 : psDesc->bSize;
+   }
+
+   appl_fNcValueValid = TRUE;
+}
+
+/*------------------------------------------------------------------------------
+** Maps a Network Configuration object instance to its setting. Returns
+** ABCC_API_NC_NUM_SETTINGS for instances not in the table.
+**------------------------------------------------------------------------------
+*/
+static ABCC_API_NcSettingType NcSettingFromInstance( UINT16 iInstance )
+{
+   UINT8 bSetting;
+
+   for( bSetting = 0; bSetting < ABCC_API_NC_NUM_SETTINGS; bSetting++ )
+   {
+      if( appl_asNcSetting[ bSetting ].iInstance == iInstance )
+      {
+         break;
+      }
+   }
+
+   return( (ABCC_API_NcSettingType)bSetting );
+}
+
+/*------------------------------------------------------------------------------
+** Checks if the value held by the CompactCom is the one requested by the
+** application.
+**------------------------------------------------------------------------------
+*/
+static BOOL NcIsHeld( UINT8 bSetting )
+{
+   const appl_NcSettingDescType* psDesc;
+   appl_NcEntryType*             psEntry;
+
+   psDesc = &appl_asNcSetting[ bSetting ];
+   psEntry = &appl_asNcEntry[ bSetting ];
+
+   return( ( psEntry->fKnown ) &&
+           ( psEntry->bModuleLength == psEntry->bValueLength ) &&
+           ( memcmp( &appl_abNcModule[ psDesc->iOffset ],
+                     &appl_abNcValue[ psDesc->iOffset ],
+                     psEntry->bValueLength ) == 0 ) );
+}
+
+/*------------------------------------------------------------------------------
+** Checks if a setting needs a command: it applies to the network, the
+** application has given a value and the CompactCom's value is unknown,
+** differs from it or is to be read back.
+**------------------------------------------------------------------------------
+*/
+static BOOL NcIsPending( UINT8 bSetting )
+{
+   appl_NcEntryType* psEntry;
+
+   psEntry = &appl_asNcEntry[ bSetting ];
+
+   if( ( ( appl_asNcSetting[ bSetting ].bNetworks & appl_bNcNetworks ) == 0 ) ||
+       ( !psEntry->fSet ) ||
+       ( psEntry->fFailed ) ||
+       ( psEntry->eState != APPL_NC_STATE_IDLE ) )
+   {
+      return( FALSE );
+   }
+
+   return( psEntry->fVerify || !NcIsHeld( bSetting ) );
+}
+
+static UINT8 NcNumPending( void )
+{
+   UINT8 bSetting;
+   UINT8 bNumPending;
+
+   bNumPending = 0;
+   for( bSetting = 0; bSetting < ABCC_API_NC_NUM_SETTINGS; bSetting++ )
+   {
+      if( NcIsPending( bSetting ) )
+      {
+         bNumPending++;
+      }
+   }
+
+   return( bNumPending );
+}
+
+/*------------------------------------------------------------------------------
+** Writes a value into a set attribute command, or reads it from a get
+** attribute response, according to the data type of the setting. The read
+** function returns the length of the value.
+**------------------------------------------------------------------------------
+*/
+static void NcSetMsgValue( ABP_MsgType* psMsg,
+                           const appl_NcSettingDescType* psDesc,
+                           UINT8* pbValue,
+                           UINT8 bLength )
+{
+   UINT16 iValue;
+
+   switch( psDesc->bType )
+   {
+   case ABP_UINT16:
+      memcpy( &iValue, pbValue, ABP_UINT16_SIZEOF );
+      ABCC_SetMsgData16( psMsg, iValue, 0 );
+      break;
+
+   case ABP_OCTET:
+   case ABP_CHAR:
+      ABCC_SetMsgString( psMsg, (char*)pbValue, bLength, 0 );
+      break;
+
+   default:
+      ABCC_SetMsgData8( psMsg, pbValue[ 0 ], 0 );
+      break;
+   }
+}
+
+static UINT8 NcGetMsgValue( ABP_MsgType* psMsg, const appl_NcSettingDescType* psDesc, UINT8* pbValue )
+{
+   UINT16 iValue;
+   UINT16 iLength;
+
+   switch( psDesc->bType )
+   {
+   case ABP_UINT16:
+      ABCC_GetMsgData16( psMsg, &iValue, 0 );
+      memcpy( pbValue, &iValue, ABP_UINT16_SIZEOF );
+      iLength = ABP_UINT16_SIZEOF;
+      break;
+
+   case ABP_OCTET:
+   case ABP_CHAR:
+      iLength = ABCC_GetMsgDataSize( psMsg );
+      if( iLength > psDesc->bSize )
+      {
+         iLength = psDesc->bSize;
+      }
+      ABCC_GetMsgString( psMsg, (char*)pbValue, iLength, 0 );
+      break;
+
+   default:
+      ABCC_GetMsgData8( psMsg, &pbValue[ 0 ], 0 );
+      iLength = ABP_UINT8_SIZEOF;
+      break;
+   }
+
+   return( (UINT8)iLength );
+}
+
+/*------------------------------------------------------------------------------
+**  Builds the command for the next setting that needs one: a get attribute
+**  if a non-volatile setting is to be read back, otherwise a set attribute.
+**
+**  This function is a part of a command sequence. See description of
+**  ABCC_CmdSeqCmdHandler type in abcc_command_sequencer_interface.h
+**------------------------------------------------------------------------------
+*/
+static ABCC_CmdSeqCmdStatusType NcNextCmd( ABP_MsgType* psMsg, void* pxUserData )
+{
+   const appl_NcSettingDescType* psDesc;
+   appl_NcEntryType*             psEntry;
+   UINT8                         bSetting;
+
+   (void)pxUserData;
+
+   for( bSetting = 0; bSetting < ABCC_API_NC_NUM_SETTINGS; bSetting++ )
+   {
+      if( NcIsPending( bSetting ) )
+      {
+         break;
+      }
+   }
+
+   if( bSetting == ABCC_API_NC_NUM_SETTINGS )
+   {
+      return( ABCC_CMDSEQ_CMD_SKIP );
+   }
+
+   psDesc = &appl_asNcSetting[ bSetting ];
+   psEntry = &appl_asNcEntry[ bSetting ];
+
+#if ABCC_API_NC_READ_BACK_ENABLE
+   if( ( psDesc->fNonVolatile ) &&
+       ( psEntry->fVerify || ( !psEntry->fKnown && !psEntry->fReadDone ) ) )
+   {
+      ABCC_GetAttribute( psMsg,
+                         ABP_OBJ_NUM_NC,
+                         psDesc->iInstance,
+                         ABP_NC_VAR_IA_VALUE,
+                         ABCC_GetNewSourceId() );
+      psEntry->eState = APPL_NC_STATE_READING;
+
+      return( ABCC_CMDSEQ_CMD_SEND );
+   }
+#endif
+
+   /*
+   ** The application may change the value before the response arrives, what
+   ** the CompactCom accepted is the value sent.
+   */
+   psEntry->bSentLength = psEntry->bValueLength;
+   memcpy( &appl_abNcSent[ psDesc->iOffset ],
+           &appl_abNcValue[ psDesc->iOffset ],
+           psEntry->bSentLength );
+
+   ABCC_SetMsgHeader( psMsg,
+                      ABP_OBJ_NUM_NC,
+                      psDesc->iInstance,
+                      ABP_NC_VAR_IA_VALUE,
+                      ABP_CMD_SET_ATTR,
+                      psEntry->bSentLength,
+                      ABCC_GetNewSourceId() );
+   NcSetMsgValue( psMsg, psDesc, &appl_abNcSent[ psDesc->iOffset ], psEntry->bSentLength );
+   psEntry->eState = APPL_NC_STATE_WRITING;
+
+   return( ABCC_CMDSEQ_CMD_SEND );
+}
+
+/*------------------------------------------------------------------------------
+**  Handles the response to a get or set attribute command of NcNextCmd() and
+**  asks for the next command.
+**
+**  This function is a part of a command sequence. See description of
+**  ABCC_CmdSeqRespHandler type in abcc_command_sequencer_interface.h
+**------------------------------------------------------------------------------
+*/
+static ABCC_CmdSeqRespStatusType NcHandleResp( ABP_MsgType* psMsg, void* pxUserData )
+{
+   const appl_NcSettingDescType* psDesc;
+   appl_NcEntryType*             psEntry;
+   ABCC_API_NcSettingType        eSetting;
+   UINT8*                        pbModule;
+   UINT8*                        pbSent;
+   BOOL                          fOk;
+
+   (void)pxUserData;
+
+   eSetting = NcSettingFromInstance( ABCC_GetMsgInstance( psMsg ) );
+   if( eSetting == ABCC_API_NC_NUM_SETTINGS )
+   {
+      return( ABCC_CMDSEQ_RESP_EXEC_CURRENT );
+   }
+
+   psDesc = &appl_asNcSetting[ eSetting ];
+   psEntry = &appl_asNcEntry[ eSetting ];
+   pbModule = &appl_abNcModule[ psDesc->iOffset ];
+   pbSent = &appl_abNcSent[ psDesc->iOffset ];
+   fOk = ( ABCC_VerifyMessage( psMsg ) == ABCC_EC_NO_ERROR );
+
+   if( ( psEntry->eState == APPL_NC_STATE_READING ) && psEntry->fVerify )
+   {
+      /*
+      ** Read back after a write. If the value cannot be read the accepted
+      ** value is trusted.
+      */
+      psEntry->fVerify = FALSE;
+      if( fOk )
+      {
+         psEntry->bModuleLength = NcGetMsgValue( psMsg, psDesc, pbModule );
+         if( ( psEntry->bModuleLength != psEntry->bSentLength ) ||
+             ( memcmp( pbModule, pbSent, psEntry->bSentLength ) != 0 ) )
+         {
+            psEntry->fFailed = TRUE;
+            ABCC_LOG_WARNING( ABCC_EC_INTERNAL_ERROR,
+               psDesc->iInstance,
+               "Network configuration instance %" PRIu16 " read back another value\n",
+               psDesc->iInstance );
+         }
+      }
+   }
+   else if( psEntry->eState == APPL_NC_STATE_READING )
+   {
+      /*
+      ** Read before a write. If the value cannot be read it is written
+      ** without comparing.
+      */
+      psEntry->fReadDone = TRUE;
+      if( fOk )
+      {
+         psEntry->bModuleLength = NcGetMsgValue( psMsg, psDesc, pbModule );
+         psEntry->fKnown = TRUE;
+      }
+      else
+      {
+         ABCC_LOG_WARNING( ABCC_EC_RESP_MSG_E_BIT_SET,
+            ABCC_GetErrorCode( psMsg ),
+            "Get network configuration instance %" PRIu16 " failed (%" PRIu8 ")\n",
+            psDesc->iInstance,
+            ABCC_GetErrorCode( psMsg ) );
+      }
+   }
+   else if( psEntry->eState == APPL_NC_STATE_WRITING )
+   {
+      if( fOk )
+      {
+         psEntry->bModuleLength = psEntry->bSentLength;
+         memcpy( pbModule, pbSent, psEntry->bSentLength );
+         psEntry->fKnown = TRUE;
+#if ABCC_API_NC_READ_BACK_ENABLE
+         psEntry->fVerify = psDesc->fNonVolatile;
+#endif
+      }
+      else
+      {
+         psEntry->fKnown = FALSE;
+         psEntry->fFailed = TRUE;
+         ABCC_LOG_WARNING( ABCC_EC_RESP_MSG_E_BIT_SET,
+            ABCC_GetErrorCode( psMsg ),
+            "Set network configuration instance %" PRIu16 " failed (%" PRIu8 ")\n",
+            psDesc->iInstance,
+            ABCC_GetErrorCode( psMsg ) );
+      }
+   }
+
+   psEntry->eState = APPL_NC_STATE_IDLE;
+
+   return( ABCC_CMDSEQ_RESP_EXEC_CURRENT );
+}
+
+/*------------------------------------------------------------------------------
+** Stores a value requested by the application, NULL to keep the present one.
+** A changed value is written again even if it failed before.
+**------------------------------------------------------------------------------
+*/
+static void NcStoreValue( ABCC_API_NcSettingType eSetting, const void* pxValue, UINT8 bLength )
+{
+   appl_NcEntryType* psEntry;
+   UINT8*            pbValue;
+
+   NcValueInit();
+
+   psEntry = &appl_asNcEntry[ eSetting ];
+   pbValue = &appl_abNcValue[ appl_asNcSetting[ eSetting ].iOffset ];
+
+   if( ( pxValue != NULL ) &&
+       ( ( bLength != psEntry->bValueLength ) ||
+         ( memcmp( pbValue, pxValue, bLength ) != 0 ) ) )
+   {
+      memcpy( pbValue, pxValue, bLength );
+      psEntry->bValueLength = bLength;
+      psEntry->fFailed = FALSE;
+   }
+
+   psEntry->fSet = TRUE;
+}
+
+static void NcWorkerDone( const ABCC_CmdSeqResultType eSeqResult, void* pxUserData );
+
+/*------------------------------------------------------------------------------
+** Start one worker per pending setting, up to ABCC_API_NC_MAX_PARALLEL. The
+** counter is set first since a worker that finds nothing to send may be done
+** right away.
+**------------------------------------------------------------------------------
+*/
+static void NcStartWorkers( UINT8 bNumPending )
+{
+   UINT8 bWorker;
+
+   if( bNumPending > ABCC_API_NC_MAX_PARALLEL )
+   {
+      bNumPending = ABCC_API_NC_MAX_PARALLEL;
+   }
+
+   appl_eNcResult = ABCC_CMDSEQ_RESULT_COMPLETED;
+   appl_bNcWorkersLeft = bNumPending;
+
+   for( bWorker = 0; bWorker < bNumPending; bWorker++ )
+   {
+      ABCC_API_MsgSchedAddControlSeq( appl_asNcWorkerCmdSeq, NcWorkerDone );
+   }
+}
+
+/*------------------------------------------------------------------------------
+**  Collects the result of one worker. When the last one is done, settings
+**  changed while the workers were finishing are written by a new set of
+**  workers, otherwise the done handler is called.
+**
+**  This function is a part of a command sequence. See description of
+**  ABCC_CmdSeqDoneHandler type in abcc_command_sequencer_interface.h
+**------------------------------------------------------------------------------
+*/
+static void NcWorkerDone( const ABCC_CmdSeqResultType eSeqResult, void* pxUserData )
+{
+   UINT8 bSetting;
+   UINT8 bNumPending;
+
+   if( ( eSeqResult != ABCC_CMDSEQ_RESULT_COMPLETED ) &&
+       ( appl_eNcResult == ABCC_CMDSEQ_RESULT_COMPLETED ) )
+   {
+      appl_eNcResult = eSeqResult;
+   }
+
+   if( appl_bNcWorkersLeft == 0 )
+   {
+      return;
+   }
+
+   appl_bNcWorkersLeft--;
+   if( appl_bNcWorkersLeft > 0 )
+   {
+      return;
+   }
+
+   /*
+   ** An aborted worker leaves its command without a response.
+   */
+   for( bSetting = 0; bSetting < ABCC_API_NC_NUM_SETTINGS; bSetting++ )
+   {
+      appl_asNcEntry[ bSetting ].eState = APPL_NC_STATE_IDLE;
+   }
+
+   if( appl_eNcResult == ABCC_CMDSEQ_RESULT_COMPLETED )
+   {
+      bNumPending = NcNumPending();
+      if( bNumPending > 0 )
+      {
+         NcStartWorkers( bNumPending );
+         return;
+      }
+   }
+
+   if( appl_pnNcApplyDone != NULL )
+   {
+      appl_pnNcApplyDone( appl_eNcResult, pxUserData );
+   }
+}
+
+/*******************************************************************************
+** Public Services
+********************************************************************************
+*/
+
+void ABCC_API_NcInit( BOOL fKeepNonVolatile, const ABCC_CmdSeqDoneHandler pnApplyDone )
+{
+   UINT8 bSetting;
+
+   NcValueInit();
+
+   for( bSetting = 0; bSetting < ABCC_API_NC_NUM_SETTINGS; bSetting++ )
+   {
+      appl_asNcEntry[ bSetting ].eState = APPL_NC_STATE_IDLE;
+      appl_asNcEntry[ bSetting ].fReadDone = FALSE;
+      appl_asNcEntry[ bSetting ].fVerify = FALSE;
+      appl_asNcEntry[ bSetting ].fFailed = FALSE;
+
+      if( !( fKeepNonVolatile && appl_asNcSetting[ bSetting ].fNonVolatile ) )
+      {
+         appl_asNcEntry[ bSetting ].fKnown = FALSE;
+      }
+   }
+
+   appl_bNcNetworks = 0;
+   appl_bNcWorkersLeft = 0;
+   appl_pnNcApplyDone = pnApplyDone;
+}
+
+void ABCC_API_NcSetNetworkType( UINT16 iNetworkType )
+{
+   UINT8 bNetwork;
+
+   appl_bNcNetworks = APPL_NC_NW_DEFAULT;
+
+   for( bNetwork = 0; bNetwork < APPL_NC_NUM_NETWORKS; bNetwork++ )
+   {
+      if( appl_asNcNetwork[ bNetwork ].iNetworkType == iNetworkType )
+      {
+         appl_bNcNetworks = appl_asNcNetwork[ bNetwork ].bNetworks;
+         break;
+      }
+   }
+}
+
+void ABCC_API_NcSetValue( ABCC_API_NcSettingType eSetting, const void* pxValue )
+{
+   if( eSetting < ABCC_API_NC_NUM_SETTINGS )
+   {
+      NcStoreValue( eSetting, pxValue, appl_asNcSetting[ eSetting ].bSize );
+   }
+}
+
+BOOL ABCC_API_NcSetString( ABCC_API_NcSettingType eSetting, const char* pcValue )
+{
+   size_t xLength;
+
+   if( ( eSetting >= ABCC_API_NC_NUM_SETTINGS ) ||
+       ( appl_asNcSetting[ eSetting ].bType != ABP_CHAR ) ||
+       ( pcValue == NULL ) )
+   {
+      return( FALSE );
+   }
+
+   xLength = strlen( pcValue );
+   if( xLength > appl_asNcSetting[ eSetting ].bSize )
+   {
+      return( FALSE );
+   }
+
+   NcStoreValue( eSetting, pcValue, (UINT8)xLength );
+
+   return( TRUE );
+}
+
+void ABCC_API_NcGetValue( ABCC_API_NcSettingType eSetting, void* pxValue )
+{
+   if( eSetting < ABCC_API_NC_NUM_SETTINGS )
+   {
+      NcValueInit();
+      memcpy( pxValue,
+              &appl_abNcValue[ appl_asNcSetting[ eSetting ].iOffset ],
+              appl_asNcEntry[ eSetting ].bValueLength );
+   }
+}
+
+ABCC_API_NcStatusType ABCC_API_NcGetStatus( ABCC_API_NcSettingType eSetting )
+{
+   appl_NcEntryType* psEntry;
+
+   if( eSetting >= ABCC_API_NC_NUM_SETTINGS )
+   {
+      return( ABCC_API_NC_STATUS_NOT_USED );
+   }
+
+   psEntry = &appl_asNcEntry[ eSetting ];
+
+   if( ( !psEntry->fSet ) ||
+       ( ( appl_bNcNetworks != 0 ) &&
+         ( ( appl_asNcSetting[ eSetting ].bNetworks & appl_bNcNetworks ) == 0 ) ) )
+   {
+      return( ABCC_API_NC_STATUS_NOT_USED );
+   }
+
+   if( psEntry->fFailed )
+   {
+      return( ABCC_API_NC_STATUS_FAILED );
+   }
+
+   if( ( appl_bNcNetworks == 0 ) ||
+       ( psEntry->eState != APPL_NC_STATE_IDLE ) ||
+       ( NcIsPending( (UINT8)eSetting ) ) )
+   {
+      return( ABCC_API_NC_STATUS_PENDING );
+   }
+
+   return( ABCC_API_NC_STATUS_DONE );
+}
+
+BOOL ABCC_API_NcApply( void )
+{
+   UINT8 bNumPending;
+
+   if( appl_bNcWorkersLeft > 0 )
+   {
+      /*
+      ** The running workers, or the ones started when they are done, pick up
+      ** the changed settings.
+      */
+      return( TRUE );
+   }
+
+   bNumPending = NcNumPending();
+   if( bNumPending == 0 )
+   {
+      return( FALSE );
+   }
+
+   NcStartWorkers( bNumPending );
+
+   return( TRUE );
+}
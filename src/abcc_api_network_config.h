@@ -0,0 +1,180 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Header file for the network configuration engine of the ABCC API.
+**
+** The Network Configuration object instances the ABCC API writes are
+** described by a table, see abcc_api_network_config.c. For each setting the
+** engine keeps the value requested by the application and the value the
+** CompactCom is known to hold. Which settings apply is decided by a table of
+** network types.
+**
+** ABCC_API_NcApply() starts command sequences that write the settings where
+** the two values differ, and nothing else. Settings the CompactCom keeps in
+** non-volatile memory are first read back from the CompactCom if their value
+** is not known yet, and read back again after being written to verify them,
+** see ABCC_API_NC_READ_BACK_ENABLE. Adding a setting only
+** needs a new table entry.
+********************************************************************************
+*/
+
+#ifndef ABCC_API_NETWORK_CONFIG_H_
+#define ABCC_API_NETWORK_CONFIG_H_
+
+#include "abcc_types.h"
+#include "abcc_api_config.h"
+#include "abcc_command_sequencer_interface.h"
+
+/*------------------------------------------------------------------------------
+** Network configuration settings. The value of each setting is passed as:
+**
+** ABCC_API_NC_NODE_ADDRESS   - UINT16
+** ABCC_API_NC_BAUD_RATE      - UINT8
+** ABCC_API_NC_IP_ADDRESS     - UINT8[ 4 ], network byte order
+** ABCC_API_NC_NETMASK        - UINT8[ 4 ], network byte order
+** ABCC_API_NC_GATEWAY        - UINT8[ 4 ], network byte order
+** ABCC_API_NC_DHCP           - UINT8, TRUE to enable
+** ABCC_API_NC_COMM_SETTING_1 - UINT8, ABCC_API_CommSettingType
+** ABCC_API_NC_COMM_SETTING_2 - UINT8, ABCC_API_CommSettingType
+** ABCC_API_NC_DNS_1          - UINT8[ 4 ], network byte order
+** ABCC_API_NC_DNS_2          - UINT8[ 4 ], network byte order
+** ABCC_API_NC_HOST_NAME      - String of up to ABCC_API_NC_HOST_NAME_MAX_LEN
+**                              characters, see ABCC_API_NcSetString()
+**------------------------------------------------------------------------------
+*/
+typedef enum ABCC_API_NcSetting
+{
+   ABCC_API_NC_NODE_ADDRESS,
+   ABCC_API_NC_BAUD_RATE,
+   ABCC_API_NC_IP_ADDRESS,
+   ABCC_API_NC_NETMASK,
+   ABCC_API_NC_GATEWAY,
+   ABCC_API_NC_DHCP,
+   ABCC_API_NC_COMM_SETTING_1,
+   ABCC_API_NC_COMM_SETTING_2,
+   ABCC_API_NC_DNS_1,
+   ABCC_API_NC_DNS_2,
+   ABCC_API_NC_HOST_NAME,
+   ABCC_API_NC_NUM_SETTINGS
+}
+ABCC_API_NcSettingType;
+
+/*------------------------------------------------------------------------------
+** Status of a setting, see ABCC_API_NcGetStatus().
+**
+** ABCC_API_NC_STATUS_NOT_USED - Not set by the application, or not supported
+**                               by the network type.
+** ABCC_API_NC_STATUS_PENDING  - Not yet written, or not yet read back.
+** ABCC_API_NC_STATUS_DONE     - The CompactCom holds the value. With
+**                               ABCC_API_NC_READ_BACK_ENABLE the value of a
+**                               non-volatile setting has been read back.
+** ABCC_API_NC_STATUS_FAILED   - The CompactCom refused the value or read back
+**                               another one.
+**------------------------------------------------------------------------------
+*/
+typedef enum ABCC_API_NcStatus
+{
+   ABCC_API_NC_STATUS_NOT_USED,
+   ABCC_API_NC_STATUS_PENDING,
+   ABCC_API_NC_STATUS_DONE,
+   ABCC_API_NC_STATUS_FAILED
+}
+ABCC_API_NcStatusType;
+
+/*------------------------------------------------------------------------------
+** Forget what is known about the CompactCom and the network type. Called when
+** the CompactCom is (re)started. The values requested by the application are
+** kept.
+**------------------------------------------------------------------------------
+** Arguments:
+**    fKeepNonVolatile - TRUE to keep the known values of the settings the
+**                       CompactCom stores in non-volatile memory, for a warm
+**                       start where they are known to be unchanged.
+**    pnApplyDone      - Called when ABCC_API_NcApply() has nothing more to
+**                       write. Called with NULL as user data.
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+void ABCC_API_NcInit( BOOL fKeepNonVolatile, const ABCC_CmdSeqDoneHandler pnApplyDone );
+
+/*------------------------------------------------------------------------------
+** Select the settings that apply to the network type. Nothing is written
+** before this has been called.
+**------------------------------------------------------------------------------
+** Arguments:
+**    iNetworkType - Network type of the CompactCom.
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+void ABCC_API_NcSetNetworkType( UINT16 iNetworkType );
+
+/*------------------------------------------------------------------------------
+** Set the value of a setting. The setting is written by the next
+** ABCC_API_NcApply() if the value differs from the CompactCom's.
+**------------------------------------------------------------------------------
+** Arguments:
+**    eSetting - Setting.
+**    pxValue  - New value, see ABCC_API_NcSettingType. NULL to write the
+**               present value, e.g. a default value.
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+void ABCC_API_NcSetValue( ABCC_API_NcSettingType eSetting, const void* pxValue );
+
+/*------------------------------------------------------------------------------
+** Set the value of a string setting, see ABCC_API_NcSetValue().
+**------------------------------------------------------------------------------
+** Arguments:
+**    eSetting - Setting, ABCC_API_NC_HOST_NAME.
+**    pcValue  - New value, NUL terminated.
+** Returns:
+**    TRUE if the value was set, FALSE if the setting is not a string or the
+**    value is too long.
+**------------------------------------------------------------------------------
+*/
+BOOL ABCC_API_NcSetString( ABCC_API_NcSettingType eSetting, const char* pcValue );
+
+/*------------------------------------------------------------------------------
+** Get the value of a setting as set by the application, or the default value.
+** String values are not NUL terminated.
+**------------------------------------------------------------------------------
+** Arguments:
+**    eSetting - Setting.
+**    pxValue  - Destination of the value, see ABCC_API_NcSettingType.
+** Returns:
+**    None
+**------------------------------------------------------------------------------
+*/
+void ABCC_API_NcGetValue( ABCC_API_NcSettingType eSetting, void* pxValue );
+
+/*------------------------------------------------------------------------------
+** Get the status of a setting.
+**------------------------------------------------------------------------------
+** Arguments:
+**    eSetting - Setting.
+** Returns:
+**    See ABCC_API_NcStatusType.
+**------------------------------------------------------------------------------
+*/
+ABCC_API_NcStatusType ABCC_API_NcGetStatus( ABCC_API_NcSettingType eSetting );
+
+/*------------------------------------------------------------------------------
+** Write the settings that differ from the CompactCom's. If an update is
+** already running the changed settings are written by it.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    TRUE if an update is running, the done handler given to
+**    ABCC_API_NcInit() is called when it is done. FALSE if there was nothing
+**    to write.
+**------------------------------------------------------------------------------
+*/
+BOOL ABCC_API_NcApply( void );
+
+#endif
@@ -0,0 +1,382 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Process data and messaging threads for POSIX hosts. See
+** abcc_api_posix_rt.h for a description.
+********************************************************************************
+*/
+
+/*
+** Needed for the CPU affinity functions, must come before any system header.
+*/
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "abcc_api_posix_rt.h"
+
+#if ABCC_API_POSIX_RT_ENABLE
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+
+#include "abcc.h"
+#include "abcc_log.h"
+#include "abcc_api.h"
+
+/*******************************************************************************
+** Defines
+********************************************************************************
+*/
+
+#define NSEC_PER_SEC ( 1000000000L )
+
+/*******************************************************************************
+** Private Globals
+********************************************************************************
+*/
+
+static ABCC_API_PosixRtConfigType appl_sPosixRtConfig;
+static BOOL appl_fPosixRtStarted = FALSE;
+static volatile BOOL appl_fPosixRtRunning = FALSE;
+static volatile BOOL appl_fPosixRtFailed = FALSE;
+static volatile ABCC_ErrorCodeType appl_ePosixRtLastError = ABCC_EC_NO_ERROR;
+static pthread_t appl_xPosixRtPdThread;
+static pthread_t appl_xPosixRtMsgThread;
+
+/*
+** Held by the process data thread around ABCC_API_RunProcessData() and by the
+** messaging thread around ABCC_API_RunMessaging() and the timer system. The
+** threads are normally pinned to different CPUs, so without it the process
+** data could be exchanged while the messaging thread runs the driver or
+** restarts the ABCC.
+*/
+static pthread_mutex_t appl_xPosixRtDriverLock;
+
+/*******************************************************************************
+** Private Services
+********************************************************************************
+*/
+
+static void AddUs( struct timespec* psTime, UINT32 lUs )
+{
+   psTime->tv_nsec += (long)( lUs % 1000000 ) * 1000;
+   psTime->tv_sec += (time_t)( lUs / 1000000 );
+   if( psTime->tv_nsec >= NSEC_PER_SEC )
+   {
+      psTime->tv_nsec -= NSEC_PER_SEC;
+      psTime->tv_sec++;
+   }
+}
+
+static BOOL IsBefore( const struct timespec* psA, const struct timespec* psB )
+{
+   return( ( psA->tv_sec < psB->tv_sec ) ||
+           ( ( psA->tv_sec == psB->tv_sec ) && ( psA->tv_nsec < psB->tv_nsec ) ) );
+}
+
+/*------------------------------------------------------------------------------
+** Sleep until the next period. If the deadline has already passed the
+** schedule is restarted from now, instead of running a burst of late cycles.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psNext    - Start of the current period, advanced to the next one.
+**    lPeriodUs - Period in microseconds.
+** Returns:
+**    TRUE, or FALSE if the sleep failed for another reason than a signal.
+**------------------------------------------------------------------------------
+*/
+static BOOL WaitNextPeriod( struct timespec* psNext, UINT32 lPeriodUs )
+{
+   struct timespec sNow;
+   int             iResult;
+
+   AddUs( psNext, lPeriodUs );
+
+   clock_gettime( CLOCK_MONOTONIC, &sNow );
+   if( IsBefore( psNext, &sNow ) )
+   {
+      *psNext = sNow;
+      return( TRUE );
+   }
+
+   do
+   {
+      iResult = clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, psNext, NULL );
+   }
+   while( iResult == EINTR );
+
+   if( iResult != 0 )
+   {
+      ABCC_LOG_ERROR( ABCC_EC_INTERNAL_ERROR, (UINT32)iResult, "Period sleep failed (%d)\n", iResult );
+      return( FALSE );
+   }
+
+   return( TRUE );
+}
+
+/*------------------------------------------------------------------------------
+** Stop both threads after a failure in one of them. ABCC_API_PosixRtStop()
+** then returns ABCC_EC_INTERNAL_ERROR.
+**------------------------------------------------------------------------------
+*/
+static void Fail( void )
+{
+   appl_fPosixRtFailed = TRUE;
+   appl_fPosixRtRunning = FALSE;
+}
+
+static void* PdThread( void* pxArg )
+{
+   struct timespec sNext;
+
+   (void)pxArg;
+
+   clock_gettime( CLOCK_MONOTONIC, &sNext );
+
+   while( appl_fPosixRtRunning )
+   {
+      pthread_mutex_lock( &appl_xPosixRtDriverLock );
+      ABCC_API_RunProcessData();
+      pthread_mutex_unlock( &appl_xPosixRtDriverLock );
+
+      if( !WaitNextPeriod( &sNext, appl_sPosixRtConfig.lPdPeriodUs ) )
+      {
+         Fail();
+      }
+   }
+
+   return( NULL );
+}
+
+static void* MsgThread( void* pxArg )
+{
+   struct timespec sNext;
+   struct timespec sLastTimer;
+   struct timespec sNow;
+   INT32           lElapsedMs;
+
+   (void)pxArg;
+
+   clock_gettime( CLOCK_MONOTONIC, &sNext );
+   sLastTimer = sNext;
+
+   while( appl_fPosixRtRunning )
+   {
+      /*
+      ** Feed the timer system with whole milliseconds, the remainder is
+      ** carried over to the next round.
+      */
+      pthread_mutex_lock( &appl_xPosixRtDriverLock );
+
+      clock_gettime( CLOCK_MONOTONIC, &sNow );
+      lElapsedMs = (INT32)( ( ( (INT64)( sNow.tv_sec - sLastTimer.tv_sec ) * NSEC_PER_SEC ) +
+                              ( sNow.tv_nsec - sLastTimer.tv_nsec ) ) / 1000000 );
+      if( lElapsedMs > 0 )
+      {
+         if( lElapsedMs > 0x7FFF )
+         {
+            lElapsedMs = 0x7FFF;
+         }
+         ABCC_API_RunTimerSystem( (INT16)lElapsedMs );
+         AddUs( &sLastTimer, (UINT32)lElapsedMs * 1000 );
+      }
+
+      appl_ePosixRtLastError = ABCC_API_RunMessaging();
+
+      pthread_mutex_unlock( &appl_xPosixRtDriverLock );
+
+      if( !WaitNextPeriod( &sNext, appl_sPosixRtConfig.lMsgPeriodUs ) )
+      {
+         Fail();
+      }
+   }
+
+   return( NULL );
+}
+
+/*------------------------------------------------------------------------------
+** Create a thread with the given scheduling priority and CPU affinity.
+**------------------------------------------------------------------------------
+** Arguments:
+**    pxThread  - Thread handle.
+**    pnEntry   - Thread function.
+**    iPriority - SCHED_FIFO priority, 0 for SCHED_OTHER.
+**    iCpu      - CPU to pin the thread to, -1 for no pinning.
+** Returns:
+**    0 on success, otherwise an error number.
+**------------------------------------------------------------------------------
+*/
+static int CreateThread( pthread_t* pxThread,
+                         void* (*pnEntry)( void* ),
+                         INT16 iPriority,
+                         INT16 iCpu )
+{
+   pthread_attr_t     xAttr;
+   struct sched_param sParam;
+   cpu_set_t          xCpuSet;
+   int                iResult;
+
+   iResult = pthread_attr_init( &xAttr );
+   if( iResult != 0 )
+   {
+      return( iResult );
+   }
+
+   if( iPriority > 0 )
+   {
+      memset( &sParam, 0, sizeof( sParam ) );
+      sParam.sched_priority = iPriority;
+
+      iResult = pthread_attr_setinheritsched( &xAttr, PTHREAD_EXPLICIT_SCHED );
+      if( iResult == 0 )
+      {
+         iResult = pthread_attr_setschedpolicy( &xAttr, SCHED_FIFO );
+      }
+      if( iResult == 0 )
+      {
+         iResult = pthread_attr_setschedparam( &xAttr, &sParam );
+      }
+   }
+
+   if( ( iResult == 0 ) && ( iCpu >= 0 ) )
+   {
+      CPU_ZERO( &xCpuSet );
+      CPU_SET( iCpu, &xCpuSet );
+      iResult = pthread_attr_setaffinity_np( &xAttr, sizeof( xCpuSet ), &xCpuSet );
+   }
+
+   if( iResult == 0 )
+   {
+      iResult = pthread_create( pxThread, &xAttr, pnEntry, NULL );
+   }
+
+   pthread_attr_destroy( &xAttr );
+
+   return( iResult );
+}
+
+/*------------------------------------------------------------------------------
+** Create the driver lock. With priority inheritance, the messaging thread
+** runs at the priority of the process data thread while that one waits for
+** the lock.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+** Returns:
+**    0 on success, otherwise an error number.
+**------------------------------------------------------------------------------
+*/
+static int CreateDriverLock( void )
+{
+   pthread_mutexattr_t xAttr;
+   int                 iResult;
+
+   iResult = pthread_mutexattr_init( &xAttr );
+   if( iResult != 0 )
+   {
+      return( iResult );
+   }
+
+   iResult = pthread_mutexattr_setprotocol( &xAttr, PTHREAD_PRIO_INHERIT );
+   if( iResult == 0 )
+   {
+      iResult = pthread_mutex_init( &appl_xPosixRtDriverLock, &xAttr );
+   }
+
+   pthread_mutexattr_destroy( &xAttr );
+
+   return( iResult );
+}
+
+/*******************************************************************************
+** Public Services
+********************************************************************************
+*/
+
+ABCC_ErrorCodeType ABCC_API_PosixRtStart( const ABCC_API_PosixRtConfigType* psConfig )
+{
+   int iResult;
+
+   if( appl_fPosixRtStarted )
+   {
+      return( ABCC_EC_INCORRECT_STATE );
+   }
+
+   if( ( psConfig == NULL ) ||
+       ( psConfig->lPdPeriodUs == 0 ) ||
+       ( psConfig->lMsgPeriodUs == 0 ) ||
+       ( psConfig->iPdPriority <= 0 ) ||
+       ( psConfig->iMsgPriority < 0 ) ||
+       ( psConfig->iMsgPriority >= psConfig->iPdPriority ) )
+   {
+      return( ABCC_EC_PARAMETER_NOT_VALID );
+   }
+
+   iResult = CreateDriverLock();
+   if( iResult != 0 )
+   {
+      ABCC_LOG_ERROR( ABCC_EC_NO_RESOURCES, (UINT32)iResult, "Failed to create driver lock (%d)\n", iResult );
+      return( ABCC_EC_NO_RESOURCES );
+   }
+
+   appl_sPosixRtConfig = *psConfig;
+   appl_ePosixRtLastError = ABCC_EC_NO_ERROR;
+   appl_fPosixRtFailed = FALSE;
+   appl_fPosixRtRunning = TRUE;
+
+   iResult = CreateThread( &appl_xPosixRtMsgThread,
+                           MsgThread,
+                           appl_sPosixRtConfig.iMsgPriority,
+                           appl_sPosixRtConfig.iMsgCpu );
+   if( iResult != 0 )
+   {
+      appl_fPosixRtRunning = FALSE;
+      pthread_mutex_destroy( &appl_xPosixRtDriverLock );
+      ABCC_LOG_ERROR( ABCC_EC_NO_RESOURCES, (UINT32)iResult, "Failed to start messaging thread (%d)\n", iResult );
+      return( ABCC_EC_NO_RESOURCES );
+   }
+
+   iResult = CreateThread( &appl_xPosixRtPdThread,
+                           PdThread,
+                           appl_sPosixRtConfig.iPdPriority,
+                           appl_sPosixRtConfig.iPdCpu );
+   if( iResult != 0 )
+   {
+      appl_fPosixRtRunning = FALSE;
+      pthread_join( appl_xPosixRtMsgThread, NULL );
+      pthread_mutex_destroy( &appl_xPosixRtDriverLock );
+      ABCC_LOG_ERROR( ABCC_EC_NO_RESOURCES, (UINT32)iResult, "Failed to start process data thread (%d)\n", iResult );
+      return( ABCC_EC_NO_RESOURCES );
+   }
+
+   appl_fPosixRtStarted = TRUE;
+
+   return( ABCC_EC_NO_ERROR );
+}
+
+ABCC_ErrorCodeType ABCC_API_PosixRtStop( void )
+{
+   if( appl_fPosixRtStarted )
+   {
+      appl_fPosixRtRunning = FALSE;
+      pthread_join( appl_xPosixRtPdThread, NULL );
+      pthread_join( appl_xPosixRtMsgThread, NULL );
+      pthread_mutex_destroy( &appl_xPosixRtDriverLock );
+      appl_fPosixRtStarted = FALSE;
+   }
+
+   if( appl_fPosixRtFailed )
+   {
+      return( ABCC_EC_INTERNAL_ERROR );
+   }
+
+   return( appl_ePosixRtLastError );
+}
+
+#endif /* ABCC_API_POSIX_RT_ENABLE */
@@ -42,8 +42,8 @@ typedef enum
    SELECT_FW_STATE_CREATE_INSTANCE_WAIT_RSP,
    SELECT_FW_STATE_DOPEN_WAIT_RSP,
    SELECT_FW_STATE_DREAD_WAIT_RSP,
-   SELECT_FW_STATE_COPY_FILE_WAIT_RSP,
    SELECT_FW_STATE_DCLOSE_WAIT_RSP,
+   SELECT_FW_STATE_COPY_FILE_WAIT_RSP,
    SELECT_FW_STATE_DELETE_INSTANCE_WAIT_RSP,
 }
 appl_SelectFwState;
@@ -56,11 +56,21 @@ static appl_SelectFwState appl_eSelectFwState = SELECT_FW_STATE_NOT_STARTED;
 static ABCC_API_CommonEtnFirmwareType appl_eTargetFirmware = ABCC_API_NW_TYPE_LAST;
 static ANB_FSI_DirEntryType appl_sDirectoryEntry = { 0 };
 static ABCC_API_pnSelectFwResultCallback appl_pnResultCallback = NULL;
+static ABCC_API_pnSelectFwProgressCallback appl_pnProgressCallback = NULL;
+static BOOL appl_fResumePending = FALSE;
 static const char* appl_acNetworkIdentifiers[] = { "PIR", "EIP", "ECT", "EIT" };
 
 static char appl_acFirmwareFilesSrcFolder[ ABP_FSI_MAX_PATH_LENGTH + 1 ] = ABCC_API_FIRMWARE_SRC_FOLDER "\\";
 static char appl_acFirmwareFilesDstFolder[ ABP_FSI_MAX_PATH_LENGTH + 1 ] = ABCC_API_FIRMWARE_DST_FOLDER "\\";
 
+/*
+** Cached listing of the firmware repository. All candidates are recorded
+** during one directory scan so that later selections, also after a module
+** reset, can go straight to the copy.
+*/
+static BOOL appl_fFirmwareCacheValid = FALSE;
+static char appl_aacFirmwareCache[ ABCC_API_NW_TYPE_LAST ][ ABP_FSI_MAX_PATH_LENGTH + 1 ];
+
 #if ABCC_API_SELECT_FIRMWARE_DEBUG_ENABLED
 static const char* appl_acStateToText[] =
 {
@@ -69,8 +79,8 @@ static const char* appl_acStateToText[] =
    "CREATE_INSTANCE_WAIT_RSP",
    "DOPEN_WAIT_RSP",
    "DREAD_WAIT_RSP",
-   "COPY_FILE_WAIT_RSP",
    "DCLOSE_WAIT_RSP",
+   "COPY_FILE_WAIT_RSP",
    "DELETE_INSTANCE_WAIT_RSP"
 };
 #endif
@@ -88,11 +98,13 @@ static ABCC_ErrorCodeType DirectoryRead( UINT16 iInstance );
 static ABCC_ErrorCodeType DirectoryReadNext( UINT16 iInstance );
 static BOOL SetupFirmwareFilePaths( void );
 static BOOL EndOfDirectoryReached( void );
-static BOOL TargetFwFileFound( void );
+static void CacheFwFile( void );
 static ABCC_ErrorCodeType DirectoryClose( UINT16 iInstance );
 static ABCC_ErrorCodeType CopyFile( UINT16 iInstance );
 static ABCC_ErrorCodeType DeleteInstance( UINT16 iInstance );
 static void NotifyResult( ABCC_ErrorCodeType iResult );
+static void NotifyProgress( ABCC_API_SelectFwPhaseType ePhase );
+static void Start( void );
 
 /*******************************************************************************
 ** Private Services
@@ -166,6 +178,15 @@ static void FsiObjectResponse( UINT16 iInstance, ABP_MsgErrorCodeType eMsgResult
    if( eMsgResult != ABP_ERR_NO_ERROR )
    {
       ABCC_API_SELECT_FIRMWARE_DEBUG_PRINT( "Command failed with error code %d (FSI error: %u)\n", eMsgResult, bFsiError );
+
+      if( appl_eSelectFwState == SELECT_FW_STATE_COPY_FILE_WAIT_RSP )
+      {
+         /*
+         ** The cached file may no longer exist, rescan next time.
+         */
+         appl_fFirmwareCacheValid = FALSE;
+      }
+
       NotifyResult( ABCC_EC_INTERNAL_ERROR );
       CleanUp( iInstance, TRUE );
       return;
@@ -197,6 +218,7 @@ static ABCC_ErrorCodeType DirectoryOpen( UINT16 iInstance )
    if( eError == ABCC_EC_NO_ERROR )
    {
       SetState( SELECT_FW_STATE_DOPEN_WAIT_RSP );
+      NotifyProgress( ABCC_API_SELECT_FW_PHASE_SCANNING );
    }
 
    return( eError );
@@ -220,22 +242,14 @@ static ABCC_ErrorCodeType DirectoryReadNext( UINT16 iInstance )
 {
    if( EndOfDirectoryReached() )
    {
-      ABCC_API_SELECT_FIRMWARE_DEBUG_PRINT( "Requested network not found in firmware repository\n" );
+      appl_fFirmwareCacheValid = TRUE;
 
-      return( ABCC_EC_PARAMETER_NOT_VALID );
+      return( DirectoryClose( iInstance ) );
    }
 
-   if( !TargetFwFileFound() )
-   {
-      return( ANB_FSI_DirectoryRead( iInstance, &appl_sDirectoryEntry, FsiObjectResponse ) );
-   }
-
-   if( !SetupFirmwareFilePaths() )
-   {
-      return( ABCC_EC_INTERNAL_ERROR );
-   }
+   CacheFwFile();
 
-   return( CopyFile( iInstance ) );
+   return( ANB_FSI_DirectoryRead( iInstance, &appl_sDirectoryEntry, FsiObjectResponse ) );
 }
 
 static BOOL EndOfDirectoryReached( void )
@@ -250,7 +264,7 @@ static BOOL EndOfDirectoryReached( void )
    }
 }
 
-static BOOL TargetFwFileFound( void )
+static void CacheFwFile( void )
 {
    /*
    ** The firmware files are named according to the
@@ -261,27 +275,35 @@ static BOOL TargetFwFileFound( void )
 #define MINIMUM_FILENAME_LENGTH 11
 #define NETWORK_IDENTIFIER_INDEX 8
 
+   int xNetwork;
+
    if( ( appl_sDirectoryEntry.bFlags & ABP_FSI_DIRECTORY_READ_DIRECTORY ) ||
       strlen( appl_sDirectoryEntry.acName ) < MINIMUM_FILENAME_LENGTH )
    {
-      return( FALSE );
-   }
-   else if( strncmp( &appl_sDirectoryEntry.acName[ NETWORK_IDENTIFIER_INDEX ],
-      appl_acNetworkIdentifiers[ appl_eTargetFirmware ],
-      strlen( appl_acNetworkIdentifiers[ appl_eTargetFirmware ] ) ) == 0 )
-   {
-      return( TRUE );
+      return;
    }
-   else
+
+   for( xNetwork = 0; xNetwork < ABCC_API_NW_TYPE_LAST; xNetwork++ )
    {
-      return( FALSE );
+      /*
+      ** Keep the first match for each network, like the original search.
+      */
+      if( ( appl_aacFirmwareCache[ xNetwork ][ 0 ] == '\0' ) &&
+          ( strncmp( &appl_sDirectoryEntry.acName[ NETWORK_IDENTIFIER_INDEX ],
+                     appl_acNetworkIdentifiers[ xNetwork ],
+                     strlen( appl_acNetworkIdentifiers[ xNetwork ] ) ) == 0 ) )
+      {
+         ABCC_API_SELECT_FIRMWARE_DEBUG_PRINT( "Found firmware candidate %s\n", appl_sDirectoryEntry.acName );
+         strcpy( appl_aacFirmwareCache[ xNetwork ], appl_sDirectoryEntry.acName );
+         return;
+      }
    }
 }
 
 static BOOL SetupFirmwareFilePaths( void )
 {
-   size_t xSrcPathLength = ABCC_API_FIRMWARE_SRC_FOLDER_FILENAME_OFFSET + strlen( appl_sDirectoryEntry.acName ) + 1;
-   size_t xDstPathLength = ABCC_API_FIRMWARE_DST_FOLDER_FILENAME_OFFSET + strlen( appl_sDirectoryEntry.acName ) + 1;
+   size_t xSrcPathLength = ABCC_API_FIRMWARE_SRC_FOLDER_FILENAME_OFFSET + strlen( appl_aacFirmwareCache[ appl_eTargetFirmware ] ) + 1;
+   size_t xDstPathLength = ABCC_API_FIRMWARE_DST_FOLDER_FILENAME_OFFSET + strlen( appl_aacFirmwareCache[ appl_eTargetFirmware ] ) + 1;
 
    if( xSrcPathLength > sizeof( appl_acFirmwareFilesSrcFolder ) )
    {
@@ -289,8 +311,8 @@ static BOOL SetupFirmwareFilePaths( void )
    }
 
    strncpy( &appl_acFirmwareFilesSrcFolder[ ABCC_API_FIRMWARE_SRC_FOLDER_FILENAME_OFFSET ],
-      appl_sDirectoryEntry.acName,
-      strlen( appl_sDirectoryEntry.acName ) + 1 );
+      appl_aacFirmwareCache[ appl_eTargetFirmware ],
+      strlen( appl_aacFirmwareCache[ appl_eTargetFirmware ] ) + 1 );
 
    if( xDstPathLength > sizeof( appl_acFirmwareFilesDstFolder ) )
    {
@@ -298,8 +320,8 @@ static BOOL SetupFirmwareFilePaths( void )
    }
 
    strncpy( &appl_acFirmwareFilesDstFolder[ ABCC_API_FIRMWARE_DST_FOLDER_FILENAME_OFFSET ],
-      appl_sDirectoryEntry.acName,
-      strlen( appl_sDirectoryEntry.acName ) + 1 );
+      appl_aacFirmwareCache[ appl_eTargetFirmware ],
+      strlen( appl_aacFirmwareCache[ appl_eTargetFirmware ] ) + 1 );
 
    return( TRUE );
 }
@@ -320,11 +342,24 @@ static ABCC_ErrorCodeType DirectoryClose( UINT16 iInstance )
 static ABCC_ErrorCodeType CopyFile( UINT16 iInstance )
 {
    ABCC_ErrorCodeType eError;
+   if( appl_aacFirmwareCache[ appl_eTargetFirmware ][ 0 ] == '\0' )
+   {
+      ABCC_API_SELECT_FIRMWARE_DEBUG_PRINT( "Requested network not found in firmware repository\n" );
+
+      return( ABCC_EC_PARAMETER_NOT_VALID );
+   }
+
+   if( !SetupFirmwareFilePaths() )
+   {
+      return( ABCC_EC_INTERNAL_ERROR );
+   }
+
    eError = ANB_FSI_FileCopy( iInstance, appl_acFirmwareFilesSrcFolder, appl_acFirmwareFilesDstFolder, FsiObjectResponse );
 
    if( eError == ABCC_EC_NO_ERROR )
    {
       SetState( SELECT_FW_STATE_COPY_FILE_WAIT_RSP );
+      NotifyProgress( ABCC_API_SELECT_FW_PHASE_COPYING );
    }
 
    return( eError );
@@ -355,7 +390,15 @@ static void RunStateMachine( UINT16 iInstance )
       ABCC_API_SELECT_FIRMWARE_DEBUG_PRINT( "Statemachine shouldn't run in this state\n" );
       break;
    case SELECT_FW_STATE_CREATE_INSTANCE_WAIT_RSP:
-      eErrorCode = DirectoryOpen( iInstance );
+      if( appl_fFirmwareCacheValid )
+      {
+         eErrorCode = CopyFile( iInstance );
+      }
+      else
+      {
+         ABCC_API_SelectFirmwareInvalidateCache();
+         eErrorCode = DirectoryOpen( iInstance );
+      }
       break;
    case SELECT_FW_STATE_DOPEN_WAIT_RSP:
       eErrorCode = DirectoryRead( iInstance );
@@ -363,10 +406,11 @@ static void RunStateMachine( UINT16 iInstance )
    case SELECT_FW_STATE_DREAD_WAIT_RSP:
       eErrorCode = DirectoryReadNext( iInstance );
       break;
-   case SELECT_FW_STATE_COPY_FILE_WAIT_RSP:
-      eErrorCode = DirectoryClose( iInstance );
-      break;
    case SELECT_FW_STATE_DCLOSE_WAIT_RSP:
+      eErrorCode = CopyFile( iInstance );
+      break;
+   case SELECT_FW_STATE_COPY_FILE_WAIT_RSP:
+      NotifyProgress( ABCC_API_SELECT_FW_PHASE_CLEANING_UP );
       eErrorCode = DeleteInstance( iInstance );
       break;
    case SELECT_FW_STATE_DELETE_INSTANCE_WAIT_RSP:
@@ -397,6 +441,28 @@ static void NotifyResult( ABCC_ErrorCodeType eResult )
    appl_pnResultCallback = NULL;
 }
 
+static void NotifyProgress( ABCC_API_SelectFwPhaseType ePhase )
+{
+   if( appl_pnProgressCallback )
+   {
+      appl_pnProgressCallback( appl_eTargetFirmware, ePhase );
+   }
+}
+
+static void Start( void )
+{
+   ABCC_ErrorCodeType eError;
+
+   SetState( SELECT_FW_STATE_STARTED );
+
+   eError = CreateInstance();
+   if( eError != ABCC_EC_NO_ERROR )
+   {
+      NotifyResult( eError );
+      SetState( SELECT_FW_STATE_NOT_STARTED );
+   }
+}
+
 /*******************************************************************************
 ** Public Services
 ********************************************************************************
@@ -415,7 +481,8 @@ void ABCC_API_SelectFirmware(
       return;
    }
 
-   if( appl_eSelectFwState > SELECT_FW_STATE_NOT_STARTED )
+   if( ( appl_eSelectFwState > SELECT_FW_STATE_NOT_STARTED ) ||
+       appl_fResumePending )
    {
       if( pnResultCallback )
       {
@@ -424,11 +491,63 @@ void ABCC_API_SelectFirmware(
       return;
    }
 
-   SetState( SELECT_FW_STATE_STARTED );
-
    appl_eTargetFirmware = eFirmware;
    appl_pnResultCallback = pnResultCallback;
-   CreateInstance();
+   Start();
+}
+
+void ABCC_API_SelectFirmwareSetProgressCallback( ABCC_API_pnSelectFwProgressCallback pnProgressCallback )
+{
+   appl_pnProgressCallback = pnProgressCallback;
+}
+
+void ABCC_API_SelectFirmwareInvalidateCache( void )
+{
+   int xNetwork;
+
+   appl_fFirmwareCacheValid = FALSE;
+
+   for( xNetwork = 0; xNetwork < ABCC_API_NW_TYPE_LAST; xNetwork++ )
+   {
+      appl_aacFirmwareCache[ xNetwork ][ 0 ] = '\0';
+   }
+}
+
+void ABCC_API_SelectFirmwareModuleReset( void )
+{
+   if( appl_eSelectFwState == SELECT_FW_STATE_NOT_STARTED )
+   {
+      return;
+   }
+
+   /*
+   ** All FSI instances and outstanding commands are gone after a reset.
+   ** If the copy had already been confirmed only the instance clean up was
+   ** left, otherwise the selection is restarted once the module is up again.
+   */
+   if( appl_eSelectFwState == SELECT_FW_STATE_DELETE_INSTANCE_WAIT_RSP )
+   {
+      SetState( SELECT_FW_STATE_NOT_STARTED );
+      NotifyResult( ABCC_EC_NO_ERROR );
+   }
+   else
+   {
+      ABCC_API_SELECT_FIRMWARE_DEBUG_PRINT( "Module reset during firmware selection, will resume\n" );
+      SetState( SELECT_FW_STATE_NOT_STARTED );
+      appl_fResumePending = TRUE;
+   }
+}
+
+void ABCC_API_SelectFirmwareResume( void )
+{
+   if( !appl_fResumePending )
+   {
+      return;
+   }
+
+   appl_fResumePending = FALSE;
+   NotifyProgress( ABCC_API_SELECT_FW_PHASE_RESUMING );
+   Start();
 }
 
 #endif
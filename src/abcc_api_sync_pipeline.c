@@ -0,0 +1,287 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Process data pipeline for isochronous operation. See
+** abcc_api_sync_pipeline.h for a description.
+********************************************************************************
+*/
+
+#include "abcc_api_sync_pipeline.h"
+
+#if ABCC_API_SYNC_PIPELINE_ENABLE
+
+#if !ABCC_CFG_SYNC_ENABLED || !SYNC_OBJ_ENABLE
+#error "ABCC_API_SYNC_PIPELINE_ENABLE requires ABCC_CFG_SYNC_ENABLED and SYNC_OBJ_ENABLE"
+#endif
+
+#include <string.h>
+
+#include "abcc.h"
+#include "abcc_port.h"
+#include "abcc_api.h"
+#include "abcc_api_command_handler_lookup.h"
+#include "host_objects/application_data_object.h"
+
+/*******************************************************************************
+** Defines
+********************************************************************************
+*/
+
+#define SYNC_PL_IMAGE_WORDS   ( ( ABCC_CFG_MAX_PROCESS_DATA_SIZE + 3 ) / 4 )
+
+/*******************************************************************************
+** Typedefs
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Triple buffer. The producer owns bWrite and the consumer owns bRead. A
+** complete image is handed over by swapping bWrite or bRead with bLatest, fNew
+** tells if bLatest holds an image the consumer has not seen yet.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   UINT32   aalImage[ 3 ][ SYNC_PL_IMAGE_WORDS ];
+   UINT16   aiSize[ 3 ];
+   UINT8    bWrite;
+   UINT8    bLatest;
+   UINT8    bRead;
+   BOOL     fNew;
+}
+appl_SyncPlBufferType;
+
+/*******************************************************************************
+** Private Globals
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Outputs are produced by the application cycle and consumed by the sync ISR.
+** appl_fSyncPlOutValid is set when bRead or bLatest holds outputs that may be
+** sent. appl_fSyncPlOutTrigger is set while the sync ISR runs
+** ABCC_TriggerWrPdUpdate().
+**------------------------------------------------------------------------------
+*/
+static appl_SyncPlBufferType appl_sSyncPlOut;
+static volatile BOOL appl_fSyncPlOutValid = FALSE;
+static volatile BOOL appl_fSyncPlOutTrigger = FALSE;
+
+/*------------------------------------------------------------------------------
+** Inputs are produced by ABCC_CbfNewReadPd(), published by the sync ISR and
+** consumed by the application cycle. appl_fSyncPlInComplete is set when
+** bWrite holds a complete image that the sync ISR may publish.
+**------------------------------------------------------------------------------
+*/
+static appl_SyncPlBufferType appl_sSyncPlIn;
+static volatile BOOL appl_fSyncPlInComplete = FALSE;
+
+static ABCC_API_SyncPipelineStatsType appl_sSyncPlStats;
+
+/*******************************************************************************
+** Private Services
+********************************************************************************
+*/
+
+static void SwapIndex( UINT8* pbA, UINT8* pbB )
+{
+   UINT8 bTmp;
+
+   bTmp = *pbA;
+   *pbA = *pbB;
+   *pbB = bTmp;
+}
+
+static void ResetBuffer( appl_SyncPlBufferType* psBuffer )
+{
+   psBuffer->bWrite = 0;
+   psBuffer->bLatest = 1;
+   psBuffer->bRead = 2;
+   psBuffer->fNew = FALSE;
+}
+
+/*******************************************************************************
+** Public Services
+********************************************************************************
+*/
+
+void ABCC_API_SyncPipelineGetStats( ABCC_API_SyncPipelineStatsType* psStats, BOOL fReset )
+{
+   ABCC_PORT_UseCritical();
+
+   ABCC_PORT_EnterCritical();
+   if( psStats != NULL )
+   {
+      *psStats = appl_sSyncPlStats;
+   }
+   if( fReset )
+   {
+      memset( &appl_sSyncPlStats, 0, sizeof( appl_sSyncPlStats ) );
+   }
+   ABCC_PORT_ExitCritical();
+}
+
+void ABCC_API_SyncPipelineReset( void )
+{
+   ABCC_PORT_UseCritical();
+
+   ABCC_PORT_EnterCritical();
+   ResetBuffer( &appl_sSyncPlOut );
+   ResetBuffer( &appl_sSyncPlIn );
+   appl_fSyncPlOutValid = FALSE;
+   appl_fSyncPlInComplete = FALSE;
+   ABCC_PORT_ExitCritical();
+}
+
+void ABCC_API_SyncPipelineStageOutputs( void )
+{
+   UINT8 bWrite;
+   ABCC_PORT_UseCritical();
+
+   bWrite = appl_sSyncPlOut.bWrite;
+
+   if( !AD_UpdatePdWriteData( appl_sSyncPlOut.aalImage[ bWrite ] ) )
+   {
+      /*
+      ** No write map, nothing to send.
+      */
+      return;
+   }
+   appl_sSyncPlOut.aiSize[ bWrite ] = AD_GetPresentPdSizeInOctets( PD_WRITE );
+
+   ABCC_PORT_EnterCritical();
+   SwapIndex( &appl_sSyncPlOut.bWrite, &appl_sSyncPlOut.bLatest );
+   appl_sSyncPlOut.fNew = TRUE;
+   appl_fSyncPlOutValid = TRUE;
+   ABCC_PORT_ExitCritical();
+}
+
+void ABCC_API_SyncPipelineTakeInputs( void )
+{
+   BOOL fNew;
+   ABCC_PORT_UseCritical();
+
+   ABCC_PORT_EnterCritical();
+   fNew = appl_sSyncPlIn.fNew;
+   if( fNew )
+   {
+      SwapIndex( &appl_sSyncPlIn.bRead, &appl_sSyncPlIn.bLatest );
+      appl_sSyncPlIn.fNew = FALSE;
+   }
+   ABCC_PORT_ExitCritical();
+
+   if( fNew )
+   {
+      AD_UpdatePdReadData( appl_sSyncPlIn.aalImage[ appl_sSyncPlIn.bRead ] );
+   }
+}
+
+BOOL ABCC_API_SyncPipelineStoreInputs( const void* pxReadPd )
+{
+   UINT8 bWrite;
+   UINT16 iSize;
+   ABCC_PORT_UseCritical();
+
+   if( ABCC_CbfSyncObjSyncMode_Get() == 0 )
+   {
+      return( FALSE );
+   }
+
+   iSize = AD_GetPresentPdSizeInOctets( PD_READ );
+   if( iSize > ABCC_CFG_MAX_PROCESS_DATA_SIZE )
+   {
+      iSize = ABCC_CFG_MAX_PROCESS_DATA_SIZE;
+   }
+
+   /*
+   ** The sync ISR must not publish the image while it is being overwritten.
+   */
+   ABCC_PORT_EnterCritical();
+   appl_fSyncPlInComplete = FALSE;
+   bWrite = appl_sSyncPlIn.bWrite;
+   ABCC_PORT_ExitCritical();
+
+   memcpy( appl_sSyncPlIn.aalImage[ bWrite ], pxReadPd, iSize );
+   appl_sSyncPlIn.aiSize[ bWrite ] = iSize;
+
+   ABCC_PORT_EnterCritical();
+   appl_fSyncPlInComplete = TRUE;
+   ABCC_PORT_ExitCritical();
+
+   return( TRUE );
+}
+
+BOOL ABCC_API_SyncPipelineCopyOutputs( void* pxWritePd )
+{
+   if( !appl_fSyncPlOutTrigger )
+   {
+      return( FALSE );
+   }
+
+   memcpy( pxWritePd,
+           appl_sSyncPlOut.aalImage[ appl_sSyncPlOut.bRead ],
+           appl_sSyncPlOut.aiSize[ appl_sSyncPlOut.bRead ] );
+
+   return( TRUE );
+}
+
+void ABCC_API_SyncPipelineSyncEvent( void )
+{
+#ifdef ABCC_API_CONFIG_GET_TIME_US
+   UINT32 lSyncTimeUs;
+   UINT32 lLatencyUs;
+
+   lSyncTimeUs = ABCC_API_CONFIG_GET_TIME_US();
+#endif
+
+   if( ( ABCC_CbfSyncObjSyncMode_Get() == 0 ) || !appl_fSyncPlOutValid )
+   {
+      return;
+   }
+
+   appl_sSyncPlStats.lSyncEvents++;
+
+   /*
+   ** Outputs first, they are what the sync event is about.
+   */
+   if( appl_sSyncPlOut.fNew )
+   {
+      SwapIndex( &appl_sSyncPlOut.bRead, &appl_sSyncPlOut.bLatest );
+      appl_sSyncPlOut.fNew = FALSE;
+   }
+   else
+   {
+      appl_sSyncPlStats.lStaleOutputs++;
+   }
+
+   appl_fSyncPlOutTrigger = TRUE;
+   ABCC_TriggerWrPdUpdate();
+   appl_fSyncPlOutTrigger = FALSE;
+
+#ifdef ABCC_API_CONFIG_GET_TIME_US
+   lLatencyUs = (UINT32)( ABCC_API_CONFIG_GET_TIME_US() - lSyncTimeUs );
+   appl_sSyncPlStats.lLastOutputLatencyUs = lLatencyUs;
+   if( lLatencyUs > appl_sSyncPlStats.lMaxOutputLatencyUs )
+   {
+      appl_sSyncPlStats.lMaxOutputLatencyUs = lLatencyUs;
+   }
+#endif
+
+   /*
+   ** Capture the newest complete inputs for the next application cycle.
+   */
+   if( appl_fSyncPlInComplete )
+   {
+      SwapIndex( &appl_sSyncPlIn.bWrite, &appl_sSyncPlIn.bLatest );
+      appl_sSyncPlIn.fNew = TRUE;
+      appl_fSyncPlInComplete = FALSE;
+   }
+   else
+   {
+      appl_sSyncPlStats.lMissedInputs++;
+   }
+}
+
+#endif /* ABCC_API_SYNC_PIPELINE_ENABLE */
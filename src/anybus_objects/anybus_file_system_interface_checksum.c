@@ -0,0 +1,654 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Source file for incremental checksums of FSI file transfers.
+********************************************************************************
+*/
+
+#include "../abcc_api_config.h"
+
+#if ANB_FSI_OBJ_ENABLE && ANB_FSI_CHECKSUM_ENABLE
+
+#include <string.h>
+#include <inttypes.h>
+
+#include "abcc.h"
+#include "abp_fsi.h"
+#include "anybus_file_system_interface_object.h"
+#include "anybus_file_system_interface_checksum.h"
+
+/*
+** Pick a hardware CRC32C implementation if the compiler has been told that
+** the target supports it (e.g. -msse4.2 or -march=armv8-a+crc).
+*/
+#if ANB_FSI_CRC32C_HW_ACCEL_ENABLE && defined( __SSE4_2__ )
+#include <nmmintrin.h>
+#define ANB_FSI_CRC32C_SSE42
+#elif ANB_FSI_CRC32C_HW_ACCEL_ENABLE && defined( __ARM_FEATURE_CRC32 )
+#include <arm_acle.h>
+#define ANB_FSI_CRC32C_ARM
+#endif
+
+/*******************************************************************************
+** Private constants.
+********************************************************************************
+*/
+
+#define ANB_FSI_SHA256_BLOCK_SIZE               ( 64 )
+
+/*------------------------------------------------------------------------------
+** Read chunk size used by ANB_FSI_FileVerify().
+**------------------------------------------------------------------------------
+*/
+#define ANB_FSI_VERIFY_CHUNK_SIZE               ( ABCC_CFG_MAX_MSG_SIZE )
+
+/*******************************************************************************
+** Private typedefs
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** State of an ongoing ANB_FSI_FileVerify().
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   BOOL                    fBusy;
+   UINT16                  iInstance;
+   char*                   pacName;
+   ANB_FSI_VerifyCbfType   pnCallback;
+   ANB_FSI_ChecksumType    sChecksum;
+   UINT8                   abExpectedDigest[ ANB_FSI_CHECKSUM_MAX_DIGEST_SIZE ];
+   ABP_MsgErrorCodeType    eMsgResult;
+   UINT8                   bFsiError;
+   UINT16                  iActSize;
+   UINT32                  lFileSize;
+   UINT8                   abBuffer[ ANB_FSI_VERIFY_CHUNK_SIZE ];
+}
+anb_fsi_VerifyStateType;
+
+/*******************************************************************************
+** Private forward declarations
+********************************************************************************
+*/
+
+static void anb_fsi_VerifyFileOpenResp( UINT16 iInstance, ABP_MsgErrorCodeType eMsgResult, UINT8 bFsiError );
+static void anb_fsi_VerifyFileReadResp( UINT16 iInstance, ABP_MsgErrorCodeType eMsgResult, UINT8 bFsiError );
+static void anb_fsi_VerifyFileCloseResp( UINT16 iInstance, ABP_MsgErrorCodeType eMsgResult, UINT8 bFsiError );
+
+/*******************************************************************************
+** Private Globals
+********************************************************************************
+*/
+
+#if !defined( ANB_FSI_CRC32C_SSE42 ) && !defined( ANB_FSI_CRC32C_ARM )
+/*------------------------------------------------------------------------------
+** CRC32C lookup table, reflected polynomial 0x82F63B78.
+**------------------------------------------------------------------------------
+*/
+static const UINT32 anb_fsi_alCrc32cTable[ 256 ] =
+{
+   0x00000000, 0xF26B8303, 0xE13B70F7, 0x1350F3F4,
+   0xC79A971F, 0x35F1141C, 0x26A1E7E8, 0xD4CA64EB,
+   0x8AD958CF, 0x78B2DBCC, 0x6BE22838, 0x9989AB3B,
+   0x4D43CFD0, 0xBF284CD3, 0xAC78BF27, 0x5E133C24,
+   0x105EC76F, 0xE235446C, 0xF165B798, 0x030E349B,
+   0xD7C45070, 0x25AFD373, 0x36FF2087, 0xC494A384,
+   0x9A879FA0, 0x68EC1CA3, 0x7BBCEF57, 0x89D76C54,
+   0x5D1D08BF, 0xAF768BBC, 0xBC267848, 0x4E4DFB4B,
+   0x20BD8EDE, 0xD2D60DDD, 0xC186FE29, 0x33ED7D2A,
+   0xE72719C1, 0x154C9AC2, 0x061C6936, 0xF477EA35,
+   0xAA64D611, 0x580F5512, 0x4B5FA6E6, 0xB93425E5,
+   0x6DFE410E, 0x9F95C20D, 0x8CC531F9, 0x7EAEB2FA,
+   0x30E349B1, 0xC288CAB2, 0xD1D83946, 0x23B3BA45,
+   0xF779DEAE, 0x05125DAD, 0x1642AE59, 0xE4292D5A,
+   0xBA3A117E, 0x4851927D, 0x5B016189, 0xA96AE28A,
+   0x7DA08661, 0x8FCB0562, 0x9C9BF696, 0x6EF07595,
+   0x417B1DBC, 0xB3109EBF, 0xA0406D4B, 0x522BEE48,
+   0x86E18AA3, 0x748A09A0, 0x67DAFA54, 0x95B17957,
+   0xCBA24573, 0x39C9C670, 0x2A993584, 0xD8F2B687,
+   0x0C38D26C, 0xFE53516F, 0xED03A29B, 0x1F682198,
+   0x5125DAD3, 0xA34E59D0, 0xB01EAA24, 0x42752927,
+   0x96BF4DCC, 0x64D4CECF, 0x77843D3B, 0x85EFBE38,
+   0xDBFC821C, 0x2997011F, 0x3AC7F2EB, 0xC8AC71E8,
+   0x1C661503, 0xEE0D9600, 0xFD5D65F4, 0x0F36E6F7,
+   0x61C69362, 0x93AD1061, 0x80FDE395, 0x72966096,
+   0xA65C047D, 0x5437877E, 0x4767748A, 0xB50CF789,
+   0xEB1FCBAD, 0x197448AE, 0x0A24BB5A, 0xF84F3859,
+   0x2C855CB2, 0xDEEEDFB1, 0xCDBE2C45, 0x3FD5AF46,
+   0x7198540D, 0x83F3D70E, 0x90A324FA, 0x62C8A7F9,
+   0xB602C312, 0x44694011, 0x5739B3E5, 0xA55230E6,
+   0xFB410CC2, 0x092A8FC1, 0x1A7A7C35, 0xE811FF36,
+   0x3CDB9BDD, 0xCEB018DE, 0xDDE0EB2A, 0x2F8B6829,
+   0x82F63B78, 0x709DB87B, 0x63CD4B8F, 0x91A6C88C,
+   0x456CAC67, 0xB7072F64, 0xA457DC90, 0x563C5F93,
+   0x082F63B7, 0xFA44E0B4, 0xE9141340, 0x1B7F9043,
+   0xCFB5F4A8, 0x3DDE77AB, 0x2E8E845F, 0xDCE5075C,
+   0x92A8FC17, 0x60C37F14, 0x73938CE0, 0x81F80FE3,
+   0x55326B08, 0xA759E80B, 0xB4091BFF, 0x466298FC,
+   0x1871A4D8, 0xEA1A27DB, 0xF94AD42F, 0x0B21572C,
+   0xDFEB33C7, 0x2D80B0C4, 0x3ED04330, 0xCCBBC033,
+   0xA24BB5A6, 0x502036A5, 0x4370C551, 0xB11B4652,
+   0x65D122B9, 0x97BAA1BA, 0x84EA524E, 0x7681D14D,
+   0x2892ED69, 0xDAF96E6A, 0xC9A99D9E, 0x3BC21E9D,
+   0xEF087A76, 0x1D63F975, 0x0E330A81, 0xFC588982,
+   0xB21572C9, 0x407EF1CA, 0x532E023E, 0xA145813D,
+   0x758FE5D6, 0x87E466D5, 0x94B49521, 0x66DF1622,
+   0x38CC2A06, 0xCAA7A905, 0xD9F75AF1, 0x2B9CD9F2,
+   0xFF56BD19, 0x0D3D3E1A, 0x1E6DCDEE, 0xEC064EED,
+   0xC38D26C4, 0x31E6A5C7, 0x22B65633, 0xD0DDD530,
+   0x0417B1DB, 0xF67C32D8, 0xE52CC12C, 0x1747422F,
+   0x49547E0B, 0xBB3FFD08, 0xA86F0EFC, 0x5A048DFF,
+   0x8ECEE914, 0x7CA56A17, 0x6FF599E3, 0x9D9E1AE0,
+   0xD3D3E1AB, 0x21B862A8, 0x32E8915C, 0xC083125F,
+   0x144976B4, 0xE622F5B7, 0xF5720643, 0x07198540,
+   0x590AB964, 0xAB613A67, 0xB831C993, 0x4A5A4A90,
+   0x9E902E7B, 0x6CFBAD78, 0x7FAB5E8C, 0x8DC0DD8F,
+   0xE330A81A, 0x115B2B19, 0x020BD8ED, 0xF0605BEE,
+   0x24AA3F05, 0xD6C1BC06, 0xC5914FF2, 0x37FACCF1,
+   0x69E9F0D5, 0x9B8273D6, 0x88D28022, 0x7AB90321,
+   0xAE7367CA, 0x5C18E4C9, 0x4F48173D, 0xBD23943E,
+   0xF36E6F75, 0x0105EC76, 0x12551F82, 0xE03E9C81,
+   0x34F4F86A, 0xC69F7B69, 0xD5CF889D, 0x27A40B9E,
+   0x79B737BA, 0x8BDCB4B9, 0x988C474D, 0x6AE7C44E,
+   0xBE2DA0A5, 0x4C4623A6, 0x5F16D052, 0xAD7D5351
+};
+#endif
+
+static const UINT32 anb_fsi_alSha256K[ 64 ] =
+{
+   0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5,
+   0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+   0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3,
+   0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+   0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC,
+   0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+   0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7,
+   0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+   0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13,
+   0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+   0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3,
+   0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+   0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5,
+   0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+   0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208,
+   0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+};
+
+static const UINT32 anb_fsi_alSha256Init[ 8 ] =
+{
+   0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+   0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+static anb_fsi_VerifyStateType anb_fsi_sVerify;
+
+/*******************************************************************************
+** Private Services
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Add data to a running CRC32C. The CRC is kept in its inverted form between
+** calls.
+**------------------------------------------------------------------------------
+** Arguments:
+**    lCrc   - Current CRC value.
+**    pbData - Data to add.
+**    lSize  - Size of data in octets.
+** Returns:
+**    Updated CRC value.
+**------------------------------------------------------------------------------
+*/
+static UINT32 anb_fsi_Crc32cUpdate( UINT32 lCrc, const UINT8* pbData, UINT32 lSize )
+{
+#if defined( ANB_FSI_CRC32C_SSE42 )
+#if defined( __x86_64__ ) || defined( _M_X64 )
+   uint64_t lCrc64;
+   uint64_t lWord;
+
+   lCrc64 = lCrc;
+   while( lSize >= 8 )
+   {
+      memcpy( &lWord, pbData, 8 );
+      lCrc64 = _mm_crc32_u64( lCrc64, lWord );
+      pbData += 8;
+      lSize -= 8;
+   }
+   lCrc = (UINT32)lCrc64;
+#else
+   UINT32 lWord;
+
+   while( lSize >= 4 )
+   {
+      memcpy( &lWord, pbData, 4 );
+      lCrc = _mm_crc32_u32( lCrc, lWord );
+      pbData += 4;
+      lSize -= 4;
+   }
+#endif
+   while( lSize > 0 )
+   {
+      lCrc = _mm_crc32_u8( lCrc, *pbData++ );
+      lSize--;
+   }
+#elif defined( ANB_FSI_CRC32C_ARM )
+   uint64_t lWord;
+
+   while( lSize >= 8 )
+   {
+      memcpy( &lWord, pbData, 8 );
+      lCrc = __crc32cd( lCrc, lWord );
+      pbData += 8;
+      lSize -= 8;
+   }
+   while( lSize > 0 )
+   {
+      lCrc = __crc32cb( lCrc, *pbData++ );
+      lSize--;
+   }
+#else
+   while( lSize > 0 )
+   {
+      lCrc = anb_fsi_alCrc32cTable[ ( lCrc ^ *pbData++ ) & 0xFF ] ^ ( lCrc >> 8 );
+      lSize--;
+   }
+#endif
+
+   return( lCrc );
+}
+
+#define ANB_FSI_ROTR( x, n )  ( ( (x) >> (n) ) | ( (x) << ( 32 - (n) ) ) )
+
+/*------------------------------------------------------------------------------
+** Process one 64 octet SHA-256 block.
+**------------------------------------------------------------------------------
+** Arguments:
+**    plState - SHA-256 state (8 words).
+**    pbBlock - Block data.
+** Returns:
+**    -
+**------------------------------------------------------------------------------
+*/
+static void anb_fsi_Sha256Block( UINT32* plState, const UINT8* pbBlock )
+{
+   UINT32 alW[ 64 ];
+   UINT32 a, b, c, d, e, f, g, h;
+   UINT32 lT1;
+   UINT32 lT2;
+   int    i;
+
+   for( i = 0; i < 16; i++ )
+   {
+      alW[ i ] = ( (UINT32)pbBlock[ i * 4 ] << 24 ) |
+                 ( (UINT32)pbBlock[ i * 4 + 1 ] << 16 ) |
+                 ( (UINT32)pbBlock[ i * 4 + 2 ] << 8 ) |
+                 ( (UINT32)pbBlock[ i * 4 + 3 ] );
+   }
+
+   for( i = 16; i < 64; i++ )
+   {
+      lT1 = ANB_FSI_ROTR( alW[ i - 2 ], 17 ) ^ ANB_FSI_ROTR( alW[ i - 2 ], 19 ) ^ ( alW[ i - 2 ] >> 10 );
+      lT2 = ANB_FSI_ROTR( alW[ i - 15 ], 7 ) ^ ANB_FSI_ROTR( alW[ i - 15 ], 18 ) ^ ( alW[ i - 15 ] >> 3 );
+      alW[ i ] = lT1 + alW[ i - 7 ] + lT2 + alW[ i - 16 ];
+   }
+
+   a = plState[ 0 ];
+   b = plState[ 1 ];
+   c = plState[ 2 ];
+   d = plState[ 3 ];
+   e = plState[ 4 ];
+   f = plState[ 5 ];
+   g = plState[ 6 ];
+   h = plState[ 7 ];
+
+   for( i = 0; i < 64; i++ )
+   {
+      lT1 = h + ( ANB_FSI_ROTR( e, 6 ) ^ ANB_FSI_ROTR( e, 11 ) ^ ANB_FSI_ROTR( e, 25 ) ) +
+            ( ( e & f ) ^ ( ~e & g ) ) + anb_fsi_alSha256K[ i ] + alW[ i ];
+      lT2 = ( ANB_FSI_ROTR( a, 2 ) ^ ANB_FSI_ROTR( a, 13 ) ^ ANB_FSI_ROTR( a, 22 ) ) +
+            ( ( a & b ) ^ ( a & c ) ^ ( b & c ) );
+      h = g;
+      g = f;
+      f = e;
+      e = d + lT1;
+      d = c;
+      c = b;
+      b = a;
+      a = lT1 + lT2;
+   }
+
+   plState[ 0 ] += a;
+   plState[ 1 ] += b;
+   plState[ 2 ] += c;
+   plState[ 3 ] += d;
+   plState[ 4 ] += e;
+   plState[ 5 ] += f;
+   plState[ 6 ] += g;
+   plState[ 7 ] += h;
+}
+
+/*------------------------------------------------------------------------------
+** Finish the ongoing verification and report the result.
+**------------------------------------------------------------------------------
+** Arguments:
+**    fMatch - TRUE if the digest matched.
+** Returns:
+**    -
+**------------------------------------------------------------------------------
+*/
+static void anb_fsi_VerifyDone( BOOL fMatch )
+{
+   ANB_FSI_VerifyCbfType pnCallback;
+
+   ANB_FSI_DetachChecksum( anb_fsi_sVerify.iInstance );
+
+   pnCallback = anb_fsi_sVerify.pnCallback;
+   anb_fsi_sVerify.fBusy = FALSE;
+
+   pnCallback( anb_fsi_sVerify.eMsgResult, anb_fsi_sVerify.bFsiError, fMatch );
+}
+
+/*------------------------------------------------------------------------------
+** Close the file being verified. If the close command cannot be issued the
+** verification is finished without a match.
+**------------------------------------------------------------------------------
+** Arguments:
+**    -
+** Returns:
+**    -
+**------------------------------------------------------------------------------
+*/
+static void anb_fsi_VerifyClose( void )
+{
+   if( ANB_FSI_FileClose( anb_fsi_sVerify.iInstance,
+                          &anb_fsi_sVerify.lFileSize,
+                          anb_fsi_VerifyFileCloseResp ) != ABCC_EC_NO_ERROR )
+   {
+      ABCC_LOG_WARNING( ABCC_EC_NO_RESOURCES, 0, "FSI verify: failed to close file\n" );
+      anb_fsi_sVerify.eMsgResult = ABP_ERR_NO_RESOURCES;
+      anb_fsi_VerifyDone( FALSE );
+   }
+}
+
+/*------------------------------------------------------------------------------
+** Request the next chunk of the file being verified.
+**------------------------------------------------------------------------------
+** Arguments:
+**    -
+** Returns:
+**    -
+**------------------------------------------------------------------------------
+*/
+static void anb_fsi_VerifyRead( void )
+{
+   if( ANB_FSI_FileRead( anb_fsi_sVerify.iInstance,
+                         anb_fsi_sVerify.abBuffer,
+                         ANB_FSI_VERIFY_CHUNK_SIZE,
+                         &anb_fsi_sVerify.iActSize,
+                         anb_fsi_VerifyFileReadResp ) != ABCC_EC_NO_ERROR )
+   {
+      anb_fsi_sVerify.eMsgResult = ABP_ERR_NO_RESOURCES;
+      anb_fsi_VerifyClose();
+   }
+}
+
+static void anb_fsi_VerifyFileOpenResp( UINT16 iInstance, ABP_MsgErrorCodeType eMsgResult, UINT8 bFsiError )
+{
+   (void)iInstance;
+
+   if( eMsgResult != ABP_ERR_NO_ERROR )
+   {
+      anb_fsi_sVerify.eMsgResult = eMsgResult;
+      anb_fsi_sVerify.bFsiError = bFsiError;
+      anb_fsi_VerifyDone( FALSE );
+      return;
+   }
+
+   if( ANB_FSI_AttachChecksum( anb_fsi_sVerify.iInstance, &anb_fsi_sVerify.sChecksum ) != ABCC_EC_NO_ERROR )
+   {
+      anb_fsi_sVerify.eMsgResult = ABP_ERR_NO_RESOURCES;
+      anb_fsi_VerifyClose();
+      return;
+   }
+
+   anb_fsi_VerifyRead();
+}
+
+static void anb_fsi_VerifyFileReadResp( UINT16 iInstance, ABP_MsgErrorCodeType eMsgResult, UINT8 bFsiError )
+{
+   (void)iInstance;
+
+   if( eMsgResult != ABP_ERR_NO_ERROR )
+   {
+      anb_fsi_sVerify.eMsgResult = eMsgResult;
+      anb_fsi_sVerify.bFsiError = bFsiError;
+      anb_fsi_VerifyClose();
+   }
+   else if( anb_fsi_sVerify.iActSize == 0 )
+   {
+      /*
+      ** EOF, the data has already been fed to the attached checksum.
+      */
+      anb_fsi_VerifyClose();
+   }
+   else
+   {
+      anb_fsi_VerifyRead();
+   }
+}
+
+static void anb_fsi_VerifyFileCloseResp( UINT16 iInstance, ABP_MsgErrorCodeType eMsgResult, UINT8 bFsiError )
+{
+   UINT8 abDigest[ ANB_FSI_CHECKSUM_MAX_DIGEST_SIZE ];
+   UINT8 bDigestSize;
+   BOOL  fMatch;
+
+   (void)iInstance;
+
+   if( ( anb_fsi_sVerify.eMsgResult == ABP_ERR_NO_ERROR ) &&
+       ( eMsgResult != ABP_ERR_NO_ERROR ) )
+   {
+      anb_fsi_sVerify.eMsgResult = eMsgResult;
+      anb_fsi_sVerify.bFsiError = bFsiError;
+   }
+
+   fMatch = FALSE;
+   if( anb_fsi_sVerify.eMsgResult == ABP_ERR_NO_ERROR )
+   {
+      bDigestSize = ANB_FSI_ChecksumFinal( &anb_fsi_sVerify.sChecksum, abDigest );
+      fMatch = ( memcmp( abDigest, anb_fsi_sVerify.abExpectedDigest, bDigestSize ) == 0 );
+
+      if( !fMatch )
+      {
+         ABCC_LOG_INFO( "FSI verify: digest mismatch for %s (%" PRIu32 " octets)\n",
+            anb_fsi_sVerify.pacName,
+            anb_fsi_sVerify.lFileSize );
+      }
+   }
+
+   anb_fsi_VerifyDone( fMatch );
+}
+
+/*******************************************************************************
+** Public Services
+********************************************************************************
+*/
+
+void ANB_FSI_ChecksumInit( ANB_FSI_ChecksumType* psChecksum, ANB_FSI_ChecksumAlgType eAlg )
+{
+   int i;
+
+   psChecksum->eAlg = eAlg;
+
+   if( eAlg == ANB_FSI_CHECKSUM_CRC32C )
+   {
+      psChecksum->uState.lCrc32c = 0xFFFFFFFF;
+   }
+   else
+   {
+      for( i = 0; i < 8; i++ )
+      {
+         psChecksum->uState.sSha256.alState[ i ] = anb_fsi_alSha256Init[ i ];
+      }
+      psChecksum->uState.sSha256.lLengthLow = 0;
+      psChecksum->uState.sSha256.lLengthHigh = 0;
+      psChecksum->uState.sSha256.bBlockLen = 0;
+   }
+}
+
+void ANB_FSI_ChecksumUpdate( ANB_FSI_ChecksumType* psChecksum, const UINT8* pbData, UINT32 lSize )
+{
+   UINT32 lCopySize;
+
+   if( psChecksum->eAlg == ANB_FSI_CHECKSUM_CRC32C )
+   {
+      psChecksum->uState.lCrc32c = anb_fsi_Crc32cUpdate( psChecksum->uState.lCrc32c, pbData, lSize );
+      return;
+   }
+
+   psChecksum->uState.sSha256.lLengthLow += lSize;
+   if( psChecksum->uState.sSha256.lLengthLow < lSize )
+   {
+      psChecksum->uState.sSha256.lLengthHigh++;
+   }
+
+   /*
+   ** Complete a partially filled block first, then hash full blocks directly
+   ** from the source buffer and keep the tail for the next call.
+   */
+   if( psChecksum->uState.sSha256.bBlockLen > 0 )
+   {
+      lCopySize = ANB_FSI_SHA256_BLOCK_SIZE - psChecksum->uState.sSha256.bBlockLen;
+      if( lCopySize > lSize )
+      {
+         lCopySize = lSize;
+      }
+
+      memcpy( &psChecksum->uState.sSha256.abBlock[ psChecksum->uState.sSha256.bBlockLen ], pbData, lCopySize );
+      psChecksum->uState.sSha256.bBlockLen += (UINT8)lCopySize;
+      pbData += lCopySize;
+      lSize -= lCopySize;
+
+      if( psChecksum->uState.sSha256.bBlockLen < ANB_FSI_SHA256_BLOCK_SIZE )
+      {
+         return;
+      }
+
+      anb_fsi_Sha256Block( psChecksum->uState.sSha256.alState, psChecksum->uState.sSha256.abBlock );
+      psChecksum->uState.sSha256.bBlockLen = 0;
+   }
+
+   while( lSize >= ANB_FSI_SHA256_BLOCK_SIZE )
+   {
+      anb_fsi_Sha256Block( psChecksum->uState.sSha256.alState, pbData );
+      pbData += ANB_FSI_SHA256_BLOCK_SIZE;
+      lSize -= ANB_FSI_SHA256_BLOCK_SIZE;
+   }
+
+   if( lSize > 0 )
+   {
+      memcpy( psChecksum->uState.sSha256.abBlock, pbData, lSize );
+      psChecksum->uState.sSha256.bBlockLen = (UINT8)lSize;
+   }
+}
+
+UINT8 ANB_FSI_ChecksumFinal( ANB_FSI_ChecksumType* psChecksum, UINT8* pbDigest )
+{
+   UINT32 lBitsHigh;
+   UINT32 lBitsLow;
+   UINT32 lCrc;
+   UINT8* pbBlock;
+   int    i;
+
+   if( psChecksum->eAlg == ANB_FSI_CHECKSUM_CRC32C )
+   {
+      lCrc = ~psChecksum->uState.lCrc32c;
+      pbDigest[ 0 ] = (UINT8)( lCrc & 0xFF );
+      pbDigest[ 1 ] = (UINT8)( ( lCrc >> 8 ) & 0xFF );
+      pbDigest[ 2 ] = (UINT8)( ( lCrc >> 16 ) & 0xFF );
+      pbDigest[ 3 ] = (UINT8)( ( lCrc >> 24 ) & 0xFF );
+
+      return( ANB_FSI_CRC32C_DIGEST_SIZE );
+   }
+
+   lBitsHigh = ( psChecksum->uState.sSha256.lLengthHigh << 3 ) |
+               ( psChecksum->uState.sSha256.lLengthLow >> 29 );
+   lBitsLow = psChecksum->uState.sSha256.lLengthLow << 3;
+
+   pbBlock = psChecksum->uState.sSha256.abBlock;
+   pbBlock[ psChecksum->uState.sSha256.bBlockLen++ ] = 0x80;
+
+   if( psChecksum->uState.sSha256.bBlockLen > ( ANB_FSI_SHA256_BLOCK_SIZE - 8 ) )
+   {
+      memset( &pbBlock[ psChecksum->uState.sSha256.bBlockLen ], 0,
+              ANB_FSI_SHA256_BLOCK_SIZE - psChecksum->uState.sSha256.bBlockLen );
+      anb_fsi_Sha256Block( psChecksum->uState.sSha256.alState, pbBlock );
+      psChecksum->uState.sSha256.bBlockLen = 0;
+   }
+
+   memset( &pbBlock[ psChecksum->uState.sSha256.bBlockLen ], 0,
+           ( ANB_FSI_SHA256_BLOCK_SIZE - 8 ) - psChecksum->uState.sSha256.bBlockLen );
+
+   for( i = 0; i < 4; i++ )
+   {
+      pbBlock[ 56 + i ] = (UINT8)( ( lBitsHigh >> ( 24 - ( i * 8 ) ) ) & 0xFF );
+      pbBlock[ 60 + i ] = (UINT8)( ( lBitsLow >> ( 24 - ( i * 8 ) ) ) & 0xFF );
+   }
+   anb_fsi_Sha256Block( psChecksum->uState.sSha256.alState, pbBlock );
+
+   for( i = 0; i < 8; i++ )
+   {
+      pbDigest[ i * 4 ]     = (UINT8)( ( psChecksum->uState.sSha256.alState[ i ] >> 24 ) & 0xFF );
+      pbDigest[ i * 4 + 1 ] = (UINT8)( ( psChecksum->uState.sSha256.alState[ i ] >> 16 ) & 0xFF );
+      pbDigest[ i * 4 + 2 ] = (UINT8)( ( psChecksum->uState.sSha256.alState[ i ] >> 8 ) & 0xFF );
+      pbDigest[ i * 4 + 3 ] = (UINT8)( psChecksum->uState.sSha256.alState[ i ] & 0xFF );
+   }
+
+   return( ANB_FSI_SHA256_DIGEST_SIZE );
+}
+
+ABCC_ErrorCodeType ANB_FSI_FileVerify( UINT16 iInstance,
+                                       char* pacName,
+                                       ANB_FSI_ChecksumAlgType eAlg,
+                                       const UINT8* pbExpectedDigest,
+                                       ANB_FSI_VerifyCbfType pnCallback )
+{
+   ABCC_ErrorCodeType eResult;
+
+   if( ( iInstance == 0 ) ||
+       ( pacName == NULL ) ||
+       ( pbExpectedDigest == NULL ) ||
+       ( pnCallback == NULL ) )
+   {
+      return( ABCC_EC_PARAMETER_NOT_VALID );
+   }
+
+   if( anb_fsi_sVerify.fBusy )
+   {
+      return( ABCC_EC_NO_RESOURCES );
+   }
+
+   anb_fsi_sVerify.iInstance = iInstance;
+   anb_fsi_sVerify.pacName = pacName;
+   anb_fsi_sVerify.pnCallback = pnCallback;
+   anb_fsi_sVerify.eMsgResult = ABP_ERR_NO_ERROR;
+   anb_fsi_sVerify.bFsiError = 0;
+   anb_fsi_sVerify.lFileSize = 0;
+   memcpy( anb_fsi_sVerify.abExpectedDigest,
+           pbExpectedDigest,
+           ( eAlg == ANB_FSI_CHECKSUM_CRC32C ) ? ANB_FSI_CRC32C_DIGEST_SIZE : ANB_FSI_SHA256_DIGEST_SIZE );
+   ANB_FSI_ChecksumInit( &anb_fsi_sVerify.sChecksum, eAlg );
+
+   eResult = ANB_FSI_FileOpen( iInstance, pacName, ABP_FSI_FILE_OPEN_READ_MODE, anb_fsi_VerifyFileOpenResp );
+   if( eResult == ABCC_EC_NO_ERROR )
+   {
+      anb_fsi_sVerify.fBusy = TRUE;
+   }
+
+   return( eResult );
+}
+
+#endif /* ANB_FSI_OBJ_ENABLE && ANB_FSI_CHECKSUM_ENABLE */
@@ -11,65 +11,131 @@
 
 #if ANB_FSI_OBJ_ENABLE
 
+#include <string.h>
+
 #include "abcc.h"
 #include "abp_fsi.h"
 #include "anybus_file_system_interface_object.h"
+#include "anybus_file_system_interface_checksum.h"
+#include "../abcc_api_msg_scheduler.h"
 
 /*******************************************************************************
 ** Private constants.
 ********************************************************************************
 */
 
+/*------------------------------------------------------------------------------
+** Size of the data kept for a queued command. Only path names are kept in the
+** queue, at most two of them separated by a NUL character (copy and rename).
+** FileWrite data is kept in a write buffer instead.
+**------------------------------------------------------------------------------
+*/
+#define ANB_FSI_PATH_DATA_SIZE   ( 2 * ABP_FSI_MAX_PATH_LENGTH + ABP_CHAR_SIZEOF )
+#define ANB_FSI_REQ_DATA_SIZE    ( ( ANB_FSI_PATH_DATA_SIZE < ABCC_CFG_MAX_MSG_SIZE ) ? \
+                                   ANB_FSI_PATH_DATA_SIZE : ABCC_CFG_MAX_MSG_SIZE )
+
 /*******************************************************************************
 ** Private typedefs
 ********************************************************************************
 */
 
 /*------------------------------------------------------------------------------
-** Bookkeeping data for the FSI object.
+** Copy of the data of a FileWrite command. It is kept until the response has
+** arrived, the checksum is fed from it.
 **------------------------------------------------------------------------------
 */
 typedef struct
 {
    BOOL                      fInUse;
-   UINT8                     bSrcId;
-   ANB_FSI_CompletionCbfType pnCallback;
+   UINT8                     abData[ ABCC_CFG_MAX_MSG_SIZE ];
+}
+anb_fsi_WriteBufferType;
 
-   union
+/*------------------------------------------------------------------------------
+** Command specific arguments that are needed when the response arrives.
+**------------------------------------------------------------------------------
+*/
+typedef union
+{
+   struct
    {
-      struct
-      {
-         UINT32*  plFileSize;
-      }
-      sFClose;
+      UINT32*  plFileSize;
+   }
+   sFClose;
 
-      struct
-      {
-         UINT8*   pbDest;
-         UINT16*  piActualSize;
-      }
-      sFRead;
+   struct
+   {
+      UINT8*   pbDest;
+      UINT16*  piActualSize;
+   }
+   sFRead;
 
-      struct
-      {
-         UINT16*  piActualSize;
-      }
-      sFWrite;
+   struct
+   {
+      anb_fsi_WriteBufferType*   psBuffer;
+      UINT16*                    piActualSize;
+   }
+   sFWrite;
 
-      struct
-      {
-         ANB_FSI_DirEntryType*   psDirEntry;
-      }
-      sDRead;
-   } uArgs;
+   struct
+   {
+      ANB_FSI_DirEntryType*   psDirEntry;
+   }
+   sDRead;
+}
+anb_fsi_ArgsType;
+
+/*------------------------------------------------------------------------------
+** Bookkeeping data for the FSI object.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   BOOL                      fInUse;
+   UINT8                     bSrcId;
+   ANB_FSI_CompletionCbfType pnCallback;
+   anb_fsi_ArgsType          uArgs;
 }
 anb_fsi_TransactionEntryType;
 
+/*------------------------------------------------------------------------------
+** Description of an FSI command, everything needed to send it. Path names are
+** copied into abData and FileWrite data into a write buffer, so the caller's
+** buffers are only needed during the call.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   UINT16                    iInstance;
+   UINT8                     bCmd;
+   UINT16                    iCmdExt;
+   UINT16                    iDataSize;
+   ANB_FSI_CompletionCbfType pnCallback;
+   anb_fsi_ArgsType          uArgs;
+   UINT8                     abData[ ANB_FSI_REQ_DATA_SIZE ];
+}
+anb_fsi_RequestType;
+
+#if ANB_FSI_CHECKSUM_ENABLE
+/*------------------------------------------------------------------------------
+** Checksum context attached to an FSI instance.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   UINT16                  iInstance;
+   ANB_FSI_ChecksumType*   psChecksum;
+}
+anb_fsi_ChecksumAttachmentType;
+#endif
+
 /*******************************************************************************
 ** Private forward declarations
 ********************************************************************************
 */
 
+static void anb_fsi_MsgResponseHandler( ABP_MsgType* psMsg );
+
 /*******************************************************************************
 ** Private Globals
 ********************************************************************************
@@ -77,6 +143,21 @@ anb_fsi_TransactionEntryType;
 
 static anb_fsi_TransactionEntryType anb_fsi_TransactionList[ ANB_FSI_MAX_CONCURRENT_OPERATIONS ];
 
+/*
+** Requests waiting for a free transaction entry or message buffer. One slot
+** more than the queue size is allocated, the slot at the tail is always free
+** and is used to build a new request before it is either sent or queued.
+*/
+static anb_fsi_RequestType anb_fsi_asRequestQueue[ ANB_FSI_CMD_QUEUE_SIZE + 1 ];
+static UINT8 anb_fsi_bQueueHead;
+static UINT8 anb_fsi_bQueueCount;
+
+static anb_fsi_WriteBufferType anb_fsi_asWriteBuffer[ ANB_FSI_WRITE_BUFFERS ];
+
+#if ANB_FSI_CHECKSUM_ENABLE
+static anb_fsi_ChecksumAttachmentType anb_fsi_asChecksumList[ ANB_FSI_MAX_CHECKSUM_INSTANCES ];
+#endif
+
 /*******************************************************************************
 ** Public Globals
 ********************************************************************************
@@ -163,6 +244,62 @@ static anb_fsi_TransactionEntryType* anb_fsi_FindTransactionEntry( UINT8 bSrcId
    return( NULL );
 }
 
+/*------------------------------------------------------------------------------
+** Allocate a buffer for the data of a FileWrite command.
+**------------------------------------------------------------------------------
+** Arguments:
+**    -
+** Returns:
+**    Pointer to a write buffer.
+**    NULL if no free buffer was available.
+**------------------------------------------------------------------------------
+*/
+static anb_fsi_WriteBufferType* anb_fsi_AllocWriteBuffer( void )
+{
+   int xIndex;
+
+   for( xIndex = 0; xIndex < ANB_FSI_WRITE_BUFFERS; xIndex++ )
+   {
+      if( !anb_fsi_asWriteBuffer[ xIndex ].fInUse )
+      {
+         anb_fsi_asWriteBuffer[ xIndex ].fInUse = TRUE;
+
+         return( &anb_fsi_asWriteBuffer[ xIndex ] );
+      }
+   }
+
+   return( NULL );
+}
+
+#if ANB_FSI_CHECKSUM_ENABLE
+/*------------------------------------------------------------------------------
+** Feed transferred file data to the checksum attached to an FSI instance, if
+** any.
+**------------------------------------------------------------------------------
+** Arguments:
+**    iInstance - FSI instance the data was transferred on.
+**    pbData    - Transferred data.
+**    iSize     - Size of data in octets.
+** Returns:
+**    -
+**------------------------------------------------------------------------------
+*/
+static void anb_fsi_FeedChecksum( UINT16 iInstance, const UINT8* pbData, UINT16 iSize )
+{
+   int xIndex;
+
+   for( xIndex = 0; xIndex < ANB_FSI_MAX_CHECKSUM_INSTANCES; xIndex++ )
+   {
+      if( ( anb_fsi_asChecksumList[ xIndex ].psChecksum != NULL ) &&
+          ( anb_fsi_asChecksumList[ xIndex ].iInstance == iInstance ) )
+      {
+         ANB_FSI_ChecksumUpdate( anb_fsi_asChecksumList[ xIndex ].psChecksum, pbData, iSize );
+         return;
+      }
+   }
+}
+#endif
+
 /*------------------------------------------------------------------------------
 ** Sanity check and length calculation for filename/path strings.
 **------------------------------------------------------------------------------
@@ -190,6 +327,160 @@ static UINT16 anb_fsi_ValidateFilePathName( const char* pacString )
    return( iSize );
 }
 
+/*------------------------------------------------------------------------------
+** Get the free request slot at the tail of the queue and initialise it.
+**------------------------------------------------------------------------------
+** Arguments:
+**    iInstance  - FSI instance the command targets.
+**    bCmd       - FSI command.
+**    iCmdExt    - Command extension.
+**    pnCallback - Completion callback.
+** Returns:
+**    Pointer to the request.
+**------------------------------------------------------------------------------
+*/
+static anb_fsi_RequestType* anb_fsi_NewRequest( UINT16 iInstance, UINT8 bCmd, UINT16 iCmdExt, ANB_FSI_CompletionCbfType pnCallback )
+{
+   anb_fsi_RequestType* psReq;
+
+   psReq = &anb_fsi_asRequestQueue[ ( anb_fsi_bQueueHead + anb_fsi_bQueueCount ) % ( ANB_FSI_CMD_QUEUE_SIZE + 1 ) ];
+
+   psReq->iInstance = iInstance;
+   psReq->bCmd = bCmd;
+   psReq->iCmdExt = iCmdExt;
+   psReq->iDataSize = 0;
+   psReq->pnCallback = pnCallback;
+
+   return( psReq );
+}
+
+/*------------------------------------------------------------------------------
+** Append a string (without NUL) to the data of a request.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psReq     - Request.
+**    pacString - String to append.
+**    iSize     - Length of string, as returned by anb_fsi_ValidateFilePathName().
+** Returns:
+**    -
+**------------------------------------------------------------------------------
+*/
+static void anb_fsi_AddRequestString( anb_fsi_RequestType* psReq, const char* pacString, UINT16 iSize )
+{
+   memcpy( &psReq->abData[ psReq->iDataSize ], pacString, iSize );
+   psReq->iDataSize += iSize;
+}
+
+/*------------------------------------------------------------------------------
+** Try to send a request to the CompactCom.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psReq - Request to send.
+** Returns:
+**    ABCC_EC_NO_ERROR if the command was sent.
+**    ABCC_EC_NO_RESOURCES or ABCC_EC_OUT_OF_MSG_BUFFERS if it has to wait.
+**------------------------------------------------------------------------------
+*/
+static ABCC_ErrorCodeType anb_fsi_Dispatch( const anb_fsi_RequestType* psReq )
+{
+   ABP_MsgType*                  psMsg;
+   anb_fsi_TransactionEntryType* psEntry;
+   const UINT8*                  pbData;
+
+   /*
+   ** FSI commands are bulk traffic and must leave room for the control
+   ** sequences of the ABCC handler.
+   */
+   if( !ABCC_API_MsgSchedAcquireBulk() )
+   {
+      return( ABCC_EC_NO_RESOURCES );
+   }
+
+   psEntry = anb_fsi_AllocTransactionEntry();
+   if( !psEntry )
+   {
+      ABCC_API_MsgSchedReleaseBulk();
+      return( ABCC_EC_NO_RESOURCES );
+   }
+
+   psMsg = ABCC_GetCmdMsgBuffer();
+   if( psMsg == NULL )
+   {
+      anb_fsi_FreeTransactionEntry( psEntry );
+      ABCC_API_MsgSchedReleaseBulk();
+      return( ABCC_EC_OUT_OF_MSG_BUFFERS );
+   }
+
+   ABCC_SetMsgHeader( psMsg, ABP_OBJ_NUM_FSI, psReq->iInstance, 0, psReq->bCmd, psReq->iDataSize, ABCC_GetNewSourceId() );
+   ABCC_SetMsgCmdExt( psMsg, psReq->iCmdExt );
+   if( psReq->iDataSize > 0 )
+   {
+      if( psReq->bCmd == ABP_FSI_CMD_FILE_WRITE )
+      {
+         pbData = psReq->uArgs.sFWrite.psBuffer->abData;
+      }
+      else
+      {
+         pbData = psReq->abData;
+      }
+
+      ABCC_SetMsgString( psMsg, (const char*)pbData, psReq->iDataSize, 0 );
+   }
+
+   psEntry->bSrcId = ABCC_GetMsgSourceId( psMsg );
+   psEntry->pnCallback = psReq->pnCallback;
+   psEntry->uArgs = psReq->uArgs;
+
+   if( ABCC_SendCmdMsg( psMsg, anb_fsi_MsgResponseHandler ) != ABCC_EC_NO_ERROR )
+   {
+      ABCC_ReturnMsgBuffer( &psMsg );
+      anb_fsi_FreeTransactionEntry( psEntry );
+      ABCC_API_MsgSchedReleaseBulk();
+      return( ABCC_EC_NO_RESOURCES );
+   }
+
+   return( ABCC_EC_NO_ERROR );
+}
+
+/*------------------------------------------------------------------------------
+** Send a request built with anb_fsi_NewRequest(), or queue it if there are no
+** resources available right now. Requests are always sent in the order they
+** were submitted.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psReq - Request at the tail of the queue.
+** Returns:
+**    ABCC_EC_NO_ERROR if the request was sent or queued.
+**    ABCC_EC_NO_RESOURCES or ABCC_EC_OUT_OF_MSG_BUFFERS if the queue is full.
+**------------------------------------------------------------------------------
+*/
+static ABCC_ErrorCodeType anb_fsi_Submit( anb_fsi_RequestType* psReq )
+{
+   ABCC_ErrorCodeType eResult;
+
+   if( anb_fsi_bQueueCount == 0 )
+   {
+      eResult = anb_fsi_Dispatch( psReq );
+      if( eResult == ABCC_EC_NO_ERROR )
+      {
+         return( eResult );
+      }
+   }
+   else
+   {
+      eResult = ABCC_EC_NO_RESOURCES;
+   }
+
+   if( anb_fsi_bQueueCount >= ANB_FSI_CMD_QUEUE_SIZE )
+   {
+      return( eResult );
+   }
+
+   anb_fsi_bQueueCount++;
+
+   return( ABCC_EC_NO_ERROR );
+}
+
 /*------------------------------------------------------------------------------
 ** Message handler for answers from the FSI object. This function is
 ** responsible for validating FSI answers, and routing the relevant data to the
@@ -218,6 +509,8 @@ static void anb_fsi_MsgResponseHandler( ABP_MsgType* psMsg )
          "Failed to find transaction entry\n" );
    }
 
+   ABCC_API_MsgSchedReleaseBulk();
+
    iInstance = ABCC_GetMsgInstance( psMsg );
 
    if( ABCC_VerifyMessage( psMsg ) == ABCC_EC_NO_ERROR )
@@ -292,6 +585,9 @@ static void anb_fsi_MsgResponseHandler( ABP_MsgType* psMsg )
          {
             iDataSize = ABCC_GetMsgDataSize( psMsg );
             ABCC_GetMsgString( psMsg, (char*)psEntry->uArgs.sFRead.pbDest, iDataSize, 0 );
+#if ANB_FSI_CHECKSUM_ENABLE
+            anb_fsi_FeedChecksum( iInstance, psEntry->uArgs.sFRead.pbDest, iDataSize );
+#endif
          }
          else
          {
@@ -308,12 +604,20 @@ static void anb_fsi_MsgResponseHandler( ABP_MsgType* psMsg )
          if( eMsgResult == ABP_ERR_NO_ERROR )
          {
             iDataSize = ABCC_GetMsgCmdExt( psMsg );
+#if ANB_FSI_CHECKSUM_ENABLE
+            /*
+            ** Only the part actually stored by the CompactCom is accounted
+            ** for, the caller is expected to resend the remainder.
+            */
+            anb_fsi_FeedChecksum( iInstance, psEntry->uArgs.sFWrite.psBuffer->abData, iDataSize );
+#endif
          }
          else
          {
             iDataSize = 0;
          }
          *psEntry->uArgs.sFWrite.piActualSize = iDataSize;
+         psEntry->uArgs.sFWrite.psBuffer->fInUse = FALSE;
          break;
 
       case ABP_FSI_CMD_DIRECTORY_READ:
@@ -382,52 +686,42 @@ void ANB_FSI_Init( void )
       anb_fsi_TransactionList[ xIndex ].pnCallback = NULL;
    }
 
-   return;
-}
-
-ABCC_ErrorCodeType ANB_FSI_Create( ANB_FSI_CompletionCbfType pnCallback )
-{
-   ABP_MsgType*                  psMsg;
-   anb_fsi_TransactionEntryType* psEntry;
-
-   if( pnCallback == NULL )
-   {
-      return( ABCC_EC_PARAMETER_NOT_VALID );
-   }
+   anb_fsi_bQueueHead = 0;
+   anb_fsi_bQueueCount = 0;
 
-   psEntry = anb_fsi_AllocTransactionEntry();
-   if( !psEntry )
+   for( xIndex = 0; xIndex < ANB_FSI_WRITE_BUFFERS; xIndex++ )
    {
-      return( ABCC_EC_NO_RESOURCES );
+      anb_fsi_asWriteBuffer[ xIndex ].fInUse = FALSE;
    }
 
-   psMsg = ABCC_GetCmdMsgBuffer();
-   if( psMsg == NULL )
+#if ANB_FSI_CHECKSUM_ENABLE
+   for( xIndex = 0; xIndex < ANB_FSI_MAX_CHECKSUM_INSTANCES; xIndex++ )
    {
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_OUT_OF_MSG_BUFFERS );
+      anb_fsi_asChecksumList[ xIndex ].iInstance = 0;
+      anb_fsi_asChecksumList[ xIndex ].psChecksum = NULL;
    }
+#endif
 
-   ABCC_SetMsgHeader( psMsg, ABP_OBJ_NUM_FSI, ABP_INST_OBJ, 0, ABP_CMD_CREATE, 0, ABCC_GetNewSourceId() );
-   ABCC_SetMsgCmdExt( psMsg, 0 );
+   return;
+}
 
-   psEntry->bSrcId = ABCC_GetMsgSourceId( psMsg );
-   psEntry->pnCallback = pnCallback;
+ABCC_ErrorCodeType ANB_FSI_Create( ANB_FSI_CompletionCbfType pnCallback )
+{
+   anb_fsi_RequestType* psReq;
 
-   if( ABCC_SendCmdMsg( psMsg, anb_fsi_MsgResponseHandler ) != ABCC_EC_NO_ERROR )
+   if( pnCallback == NULL )
    {
-      ABCC_ReturnMsgBuffer( &psMsg );
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_NO_RESOURCES );
+      return( ABCC_EC_PARAMETER_NOT_VALID );
    }
 
-   return( ABCC_EC_NO_ERROR );
+   psReq = anb_fsi_NewRequest( ABP_INST_OBJ, ABP_CMD_CREATE, 0, pnCallback );
+
+   return( anb_fsi_Submit( psReq ) );
 }
 
 ABCC_ErrorCodeType ANB_FSI_Delete( UINT16 iInstance, ANB_FSI_CompletionCbfType pnCallback )
 {
-   ABP_MsgType*                  psMsg;
-   anb_fsi_TransactionEntryType* psEntry;
+   anb_fsi_RequestType* psReq;
 
    if( ( iInstance == 0 ) ||
        ( pnCallback == NULL ) )
@@ -435,41 +729,15 @@ ABCC_ErrorCodeType ANB_FSI_Delete( UINT16 iInstance, ANB_FSI_CompletionCbfType p
       return( ABCC_EC_PARAMETER_NOT_VALID );
    }
 
-   psEntry = anb_fsi_AllocTransactionEntry();
-   if( !psEntry )
-   {
-      return( ABCC_EC_NO_RESOURCES );
-   }
-
-   psMsg = ABCC_GetCmdMsgBuffer();
-   if( psMsg == NULL )
-   {
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_OUT_OF_MSG_BUFFERS );
-   }
-
-   ABCC_SetMsgHeader( psMsg, ABP_OBJ_NUM_FSI, ABP_INST_OBJ, 0, ABP_CMD_DELETE, 0, ABCC_GetNewSourceId() );
-   ABCC_SetMsgCmdExt( psMsg, iInstance );
-
-   psEntry->bSrcId = ABCC_GetMsgSourceId( psMsg );
-   psEntry->pnCallback = pnCallback;
-
-   if( ABCC_SendCmdMsg( psMsg, anb_fsi_MsgResponseHandler ) != ABCC_EC_NO_ERROR )
-   {
-      ABCC_ReturnMsgBuffer( &psMsg );
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_NO_RESOURCES );
-   }
+   psReq = anb_fsi_NewRequest( ABP_INST_OBJ, ABP_CMD_DELETE, iInstance, pnCallback );
 
-   return( ABCC_EC_NO_ERROR );
+   return( anb_fsi_Submit( psReq ) );
 }
 
 ABCC_ErrorCodeType ANB_FSI_FileOpen( UINT16 iInstance, char* pacName, UINT8 bMode, ANB_FSI_CompletionCbfType pnCallback )
 {
-   ABP_MsgType*                  psMsg;
-   anb_fsi_TransactionEntryType* psEntry;
-
-   UINT16                        iSize;
+   anb_fsi_RequestType* psReq;
+   UINT16               iSize;
 
    if( ( iInstance == 0 ) ||
        ( pacName == NULL ) ||
@@ -487,41 +755,19 @@ ABCC_ErrorCodeType ANB_FSI_FileOpen( UINT16 iInstance, char* pacName, UINT8 bMod
       return( ABCC_EC_PARAMETER_NOT_VALID );
    }
 
-   psEntry = anb_fsi_AllocTransactionEntry();
-   if( !psEntry )
-   {
-      return( ABCC_EC_NO_RESOURCES );
-   }
-
-   psMsg = ABCC_GetCmdMsgBuffer();
-   if( psMsg == NULL )
-   {
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_OUT_OF_MSG_BUFFERS );
-   }
-
-   ABCC_SetMsgHeader( psMsg, ABP_OBJ_NUM_FSI, iInstance, 0, ABP_FSI_CMD_FILE_OPEN, iSize, ABCC_GetNewSourceId() );
-   ABCC_SetMsgCmdExt0( psMsg, bMode );
-   ABCC_SetMsgCmdExt1( psMsg, 0 );
-   ABCC_SetMsgString( psMsg, pacName, iSize, 0 );
-
-   psEntry->bSrcId = ABCC_GetMsgSourceId( psMsg );
-   psEntry->pnCallback = pnCallback;
-
-   if( ABCC_SendCmdMsg( psMsg, anb_fsi_MsgResponseHandler ) != ABCC_EC_NO_ERROR )
-   {
-      ABCC_ReturnMsgBuffer( &psMsg );
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_NO_RESOURCES );
-   }
+   /*
+   ** The mode goes in CmdExt0 and CmdExt1 is zero, i.e. the same as the
+   ** complete extension word holding the mode.
+   */
+   psReq = anb_fsi_NewRequest( iInstance, ABP_FSI_CMD_FILE_OPEN, bMode, pnCallback );
+   anb_fsi_AddRequestString( psReq, pacName, iSize );
 
-   return( ABCC_EC_NO_ERROR );
+   return( anb_fsi_Submit( psReq ) );
 }
 
 ABCC_ErrorCodeType ANB_FSI_FileClose( UINT16 iInstance, UINT32* plFileSize, ANB_FSI_CompletionCbfType pnCallback )
 {
-   ABP_MsgType*                  psMsg;
-   anb_fsi_TransactionEntryType* psEntry;
+   anb_fsi_RequestType* psReq;
 
    if( ( iInstance == 0 ) ||
        ( plFileSize == NULL ) ||
@@ -530,42 +776,16 @@ ABCC_ErrorCodeType ANB_FSI_FileClose( UINT16 iInstance, UINT32* plFileSize, ANB_
       return( ABCC_EC_PARAMETER_NOT_VALID );
    }
 
-   psEntry = anb_fsi_AllocTransactionEntry();
-   if( !psEntry )
-   {
-      return( ABCC_EC_NO_RESOURCES );
-   }
-
-   psMsg = ABCC_GetCmdMsgBuffer();
-   if( psMsg == NULL )
-   {
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_OUT_OF_MSG_BUFFERS );
-   }
-
-   ABCC_SetMsgHeader( psMsg, ABP_OBJ_NUM_FSI, iInstance, 0, ABP_FSI_CMD_FILE_CLOSE, 0, ABCC_GetNewSourceId() );
-   ABCC_SetMsgCmdExt( psMsg, 0 );
-
-   psEntry->bSrcId = ABCC_GetMsgSourceId( psMsg );
-   psEntry->pnCallback = pnCallback;
-   psEntry->uArgs.sFClose.plFileSize = plFileSize;
+   psReq = anb_fsi_NewRequest( iInstance, ABP_FSI_CMD_FILE_CLOSE, 0, pnCallback );
+   psReq->uArgs.sFClose.plFileSize = plFileSize;
 
-   if( ABCC_SendCmdMsg( psMsg, anb_fsi_MsgResponseHandler ) != ABCC_EC_NO_ERROR )
-   {
-      ABCC_ReturnMsgBuffer( &psMsg );
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_NO_RESOURCES );
-   }
-
-   return( ABCC_EC_NO_ERROR );
+   return( anb_fsi_Submit( psReq ) );
 }
 
 ABCC_ErrorCodeType ANB_FSI_FileDelete( UINT16 iInstance, char* pacName, ANB_FSI_CompletionCbfType pnCallback )
 {
-   ABP_MsgType*                  psMsg;
-   anb_fsi_TransactionEntryType* psEntry;
-
-   UINT16                        iSize;
+   anb_fsi_RequestType* psReq;
+   UINT16               iSize;
 
    if( ( iInstance == 0 ) ||
        ( pacName == NULL ) ||
@@ -580,43 +800,17 @@ ABCC_ErrorCodeType ANB_FSI_FileDelete( UINT16 iInstance, char* pacName, ANB_FSI_
       return( ABCC_EC_PARAMETER_NOT_VALID );
    }
 
-   psEntry = anb_fsi_AllocTransactionEntry();
-   if( !psEntry )
-   {
-      return( ABCC_EC_NO_RESOURCES );
-   }
-
-   psMsg = ABCC_GetCmdMsgBuffer();
-   if( psMsg == NULL )
-   {
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_OUT_OF_MSG_BUFFERS );
-   }
-
-   ABCC_SetMsgHeader( psMsg, ABP_OBJ_NUM_FSI, iInstance, 0, ABP_FSI_CMD_FILE_DELETE, iSize, ABCC_GetNewSourceId() );
-   ABCC_SetMsgCmdExt( psMsg, 0 );
-   ABCC_SetMsgString( psMsg, pacName, iSize, 0 );
-
-   psEntry->bSrcId = ABCC_GetMsgSourceId( psMsg );
-   psEntry->pnCallback = pnCallback;
-
-   if( ABCC_SendCmdMsg( psMsg, anb_fsi_MsgResponseHandler ) != ABCC_EC_NO_ERROR )
-   {
-      ABCC_ReturnMsgBuffer( &psMsg );
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_NO_RESOURCES );
-   }
+   psReq = anb_fsi_NewRequest( iInstance, ABP_FSI_CMD_FILE_DELETE, 0, pnCallback );
+   anb_fsi_AddRequestString( psReq, pacName, iSize );
 
-   return( ABCC_EC_NO_ERROR );
+   return( anb_fsi_Submit( psReq ) );
 }
 
 ABCC_ErrorCodeType ANB_FSI_FileCopy( UINT16 iInstance, char* pacSrc, char* pacDest, ANB_FSI_CompletionCbfType pnCallback )
 {
-   ABP_MsgType*                  psMsg;
-   anb_fsi_TransactionEntryType* psEntry;
-
-   UINT16                        iSizeSrc;
-   UINT16                        iSizeDest;
+   anb_fsi_RequestType* psReq;
+   UINT16               iSizeSrc;
+   UINT16               iSizeDest;
 
    if( ( iInstance == 0 ) ||
        ( pacSrc == NULL ) ||
@@ -641,45 +835,19 @@ ABCC_ErrorCodeType ANB_FSI_FileCopy( UINT16 iInstance, char* pacSrc, char* pacDe
       return( ABCC_EC_PARAMETER_NOT_VALID );
    }
 
-   psEntry = anb_fsi_AllocTransactionEntry();
-   if( !psEntry )
-   {
-      return( ABCC_EC_NO_RESOURCES );
-   }
-
-   psMsg = ABCC_GetCmdMsgBuffer();
-   if( psMsg == NULL )
-   {
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_OUT_OF_MSG_BUFFERS );
-   }
-
-   ABCC_SetMsgHeader( psMsg, ABP_OBJ_NUM_FSI, iInstance, 0, ABP_FSI_CMD_FILE_COPY, iSizeSrc + ABP_CHAR_SIZEOF + iSizeDest, ABCC_GetNewSourceId() );
-   ABCC_SetMsgCmdExt( psMsg, 0 );
-   ABCC_SetMsgString( psMsg, pacSrc, iSizeSrc, 0 );
-   ABCC_SetMsgData8( psMsg, 0, iSizeSrc ); /* NUL character */
-   ABCC_SetMsgString( psMsg, pacDest, iSizeDest, iSizeSrc + ABP_CHAR_SIZEOF );
-
-   psEntry->bSrcId = ABCC_GetMsgSourceId( psMsg );
-   psEntry->pnCallback = pnCallback;
-
-   if( ABCC_SendCmdMsg( psMsg, anb_fsi_MsgResponseHandler ) != ABCC_EC_NO_ERROR )
-   {
-      ABCC_ReturnMsgBuffer( &psMsg );
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_NO_RESOURCES );
-   }
+   psReq = anb_fsi_NewRequest( iInstance, ABP_FSI_CMD_FILE_COPY, 0, pnCallback );
+   anb_fsi_AddRequestString( psReq, pacSrc, iSizeSrc );
+   anb_fsi_AddRequestString( psReq, "", ABP_CHAR_SIZEOF ); /* NUL character */
+   anb_fsi_AddRequestString( psReq, pacDest, iSizeDest );
 
-   return( ABCC_EC_NO_ERROR );
+   return( anb_fsi_Submit( psReq ) );
 }
 
 ABCC_ErrorCodeType ANB_FSI_FileRename( UINT16 iInstance, char* pacOld, char* pacNew, ANB_FSI_CompletionCbfType pnCallback )
 {
-   ABP_MsgType*                  psMsg;
-   anb_fsi_TransactionEntryType* psEntry;
-
-   UINT16                        iSizeOld;
-   UINT16                        iSizeNew;
+   anb_fsi_RequestType* psReq;
+   UINT16               iSizeOld;
+   UINT16               iSizeNew;
 
    if( ( iInstance == 0 ) ||
        ( pacOld == NULL ) ||
@@ -704,42 +872,17 @@ ABCC_ErrorCodeType ANB_FSI_FileRename( UINT16 iInstance, char* pacOld, char* pac
       return( ABCC_EC_PARAMETER_NOT_VALID );
    }
 
-   psEntry = anb_fsi_AllocTransactionEntry();
-   if( !psEntry )
-   {
-      return( ABCC_EC_NO_RESOURCES );
-   }
-
-   psMsg = ABCC_GetCmdMsgBuffer();
-   if( psMsg == NULL )
-   {
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_OUT_OF_MSG_BUFFERS );
-   }
-
-   ABCC_SetMsgHeader( psMsg, ABP_OBJ_NUM_FSI, iInstance, 0, ABP_FSI_CMD_FILE_RENAME, iSizeOld + ABP_CHAR_SIZEOF + iSizeNew, ABCC_GetNewSourceId() );
-   ABCC_SetMsgCmdExt( psMsg, 0 );
-   ABCC_SetMsgString( psMsg, pacOld, iSizeOld, 0 );
-   ABCC_SetMsgData8( psMsg, 0, iSizeOld ); /* NUL character */
-   ABCC_SetMsgString( psMsg, pacNew, iSizeNew, iSizeOld + ABP_CHAR_SIZEOF );
-
-   psEntry->bSrcId = ABCC_GetMsgSourceId( psMsg );
-   psEntry->pnCallback = pnCallback;
-
-   if( ABCC_SendCmdMsg( psMsg, anb_fsi_MsgResponseHandler ) != ABCC_EC_NO_ERROR )
-   {
-      ABCC_ReturnMsgBuffer( &psMsg );
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_NO_RESOURCES );
-   }
+   psReq = anb_fsi_NewRequest( iInstance, ABP_FSI_CMD_FILE_RENAME, 0, pnCallback );
+   anb_fsi_AddRequestString( psReq, pacOld, iSizeOld );
+   anb_fsi_AddRequestString( psReq, "", ABP_CHAR_SIZEOF ); /* NUL character */
+   anb_fsi_AddRequestString( psReq, pacNew, iSizeNew );
 
-   return( ABCC_EC_NO_ERROR );
+   return( anb_fsi_Submit( psReq ) );
 }
 
 ABCC_ErrorCodeType ANB_FSI_FileRead( UINT16 iInstance, UINT8* pbDest, UINT16 iReqSize, UINT16* piActSize, ANB_FSI_CompletionCbfType pnCallback )
 {
-   ABP_MsgType*                  psMsg;
-   anb_fsi_TransactionEntryType* psEntry;
+   anb_fsi_RequestType* psReq;
 
    if( ( iInstance == 0 ) ||
        ( pbDest == NULL ) ||
@@ -751,41 +894,18 @@ ABCC_ErrorCodeType ANB_FSI_FileRead( UINT16 iInstance, UINT8* pbDest, UINT16 iRe
       return( ABCC_EC_PARAMETER_NOT_VALID );
    }
 
-   psEntry = anb_fsi_AllocTransactionEntry();
-   if( !psEntry )
-   {
-      return( ABCC_EC_NO_RESOURCES );
-   }
-
-   psMsg = ABCC_GetCmdMsgBuffer();
-   if( psMsg == NULL )
-   {
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_OUT_OF_MSG_BUFFERS );
-   }
-
-   ABCC_SetMsgHeader( psMsg, ABP_OBJ_NUM_FSI, iInstance, 0, ABP_FSI_CMD_FILE_READ, 0, ABCC_GetNewSourceId() );
-   ABCC_SetMsgCmdExt( psMsg, iReqSize );
-
-   psEntry->bSrcId = ABCC_GetMsgSourceId( psMsg );
-   psEntry->pnCallback = pnCallback;
-   psEntry->uArgs.sFRead.pbDest = pbDest;
-   psEntry->uArgs.sFRead.piActualSize = piActSize;
-
-   if( ABCC_SendCmdMsg( psMsg, anb_fsi_MsgResponseHandler ) != ABCC_EC_NO_ERROR )
-   {
-      ABCC_ReturnMsgBuffer( &psMsg );
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_NO_RESOURCES );
-   }
+   psReq = anb_fsi_NewRequest( iInstance, ABP_FSI_CMD_FILE_READ, iReqSize, pnCallback );
+   psReq->uArgs.sFRead.pbDest = pbDest;
+   psReq->uArgs.sFRead.piActualSize = piActSize;
 
-   return( ABCC_EC_NO_ERROR );
+   return( anb_fsi_Submit( psReq ) );
 }
 
 ABCC_ErrorCodeType ANB_FSI_FileWrite( UINT16 iInstance, UINT8* pbSrc, UINT16 iReqSize, UINT16* piActSize, ANB_FSI_CompletionCbfType pnCallback )
 {
-   ABP_MsgType*                  psMsg;
-   anb_fsi_TransactionEntryType* psEntry;
+   anb_fsi_RequestType*     psReq;
+   anb_fsi_WriteBufferType* psBuffer;
+   ABCC_ErrorCodeType       eResult;
 
    if( ( iInstance == 0 ) ||
        ( pbSrc == NULL ) ||
@@ -797,43 +917,32 @@ ABCC_ErrorCodeType ANB_FSI_FileWrite( UINT16 iInstance, UINT8* pbSrc, UINT16 iRe
       return( ABCC_EC_PARAMETER_NOT_VALID );
    }
 
-   psEntry = anb_fsi_AllocTransactionEntry();
-   if( !psEntry )
+   psBuffer = anb_fsi_AllocWriteBuffer();
+   if( psBuffer == NULL )
    {
       return( ABCC_EC_NO_RESOURCES );
    }
 
-   psMsg = ABCC_GetCmdMsgBuffer();
-   if( psMsg == NULL )
-   {
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_OUT_OF_MSG_BUFFERS );
-   }
-
-   ABCC_SetMsgHeader( psMsg, ABP_OBJ_NUM_FSI, iInstance, 0, ABP_FSI_CMD_FILE_WRITE, iReqSize, ABCC_GetNewSourceId() );
-   ABCC_SetMsgCmdExt( psMsg, 0 );
-   ABCC_SetMsgString( psMsg, (char*)pbSrc, iReqSize, 0 );
+   memcpy( psBuffer->abData, pbSrc, iReqSize );
 
-   psEntry->bSrcId = ABCC_GetMsgSourceId( psMsg );
-   psEntry->pnCallback = pnCallback;
-   psEntry->uArgs.sFWrite.piActualSize = piActSize;
+   psReq = anb_fsi_NewRequest( iInstance, ABP_FSI_CMD_FILE_WRITE, 0, pnCallback );
+   psReq->iDataSize = iReqSize;
+   psReq->uArgs.sFWrite.psBuffer = psBuffer;
+   psReq->uArgs.sFWrite.piActualSize = piActSize;
 
-   if( ABCC_SendCmdMsg( psMsg, anb_fsi_MsgResponseHandler ) != ABCC_EC_NO_ERROR )
+   eResult = anb_fsi_Submit( psReq );
+   if( eResult != ABCC_EC_NO_ERROR )
    {
-      ABCC_ReturnMsgBuffer( &psMsg );
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_NO_RESOURCES );
+      psBuffer->fInUse = FALSE;
    }
 
-   return( ABCC_EC_NO_ERROR );
+   return( eResult );
 }
 
 ABCC_ErrorCodeType ANB_FSI_DirectoryOpen( UINT16 iInstance, char* pacName, ANB_FSI_CompletionCbfType pnCallback )
 {
-   ABP_MsgType*                  psMsg;
-   anb_fsi_TransactionEntryType* psEntry;
-
-   UINT16       iSize;
+   anb_fsi_RequestType* psReq;
+   UINT16               iSize;
 
    if( ( iInstance == 0 ) ||
        ( pacName == NULL ) ||
@@ -848,40 +957,15 @@ ABCC_ErrorCodeType ANB_FSI_DirectoryOpen( UINT16 iInstance, char* pacName, ANB_F
       return( ABCC_EC_PARAMETER_NOT_VALID );
    }
 
-   psEntry = anb_fsi_AllocTransactionEntry();
-   if( !psEntry )
-   {
-      return( ABCC_EC_NO_RESOURCES );
-   }
-
-   psMsg = ABCC_GetCmdMsgBuffer();
-   if( psMsg == NULL )
-   {
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_OUT_OF_MSG_BUFFERS );
-   }
-
-   ABCC_SetMsgHeader( psMsg, ABP_OBJ_NUM_FSI, iInstance, 0, ABP_FSI_CMD_DIRECTORY_OPEN, iSize, ABCC_GetNewSourceId() );
-   ABCC_SetMsgCmdExt( psMsg, 0 );
-   ABCC_SetMsgString( psMsg, pacName, iSize, 0 );
-
-   psEntry->bSrcId = ABCC_GetMsgSourceId( psMsg );
-   psEntry->pnCallback = pnCallback;
-
-   if( ABCC_SendCmdMsg( psMsg, anb_fsi_MsgResponseHandler ) != ABCC_EC_NO_ERROR )
-   {
-      ABCC_ReturnMsgBuffer( &psMsg );
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_NO_RESOURCES );
-   }
+   psReq = anb_fsi_NewRequest( iInstance, ABP_FSI_CMD_DIRECTORY_OPEN, 0, pnCallback );
+   anb_fsi_AddRequestString( psReq, pacName, iSize );
 
-   return( ABCC_EC_NO_ERROR );
+   return( anb_fsi_Submit( psReq ) );
 }
 
 ABCC_ErrorCodeType ANB_FSI_DirectoryClose( UINT16 iInstance, ANB_FSI_CompletionCbfType pnCallback )
 {
-   ABP_MsgType*                  psMsg;
-   anb_fsi_TransactionEntryType* psEntry;
+   anb_fsi_RequestType* psReq;
 
    if( ( iInstance == 0 ) ||
        ( pnCallback == NULL ) )
@@ -889,41 +973,15 @@ ABCC_ErrorCodeType ANB_FSI_DirectoryClose( UINT16 iInstance, ANB_FSI_CompletionC
       return( ABCC_EC_PARAMETER_NOT_VALID );
    }
 
-   psEntry = anb_fsi_AllocTransactionEntry();
-   if( !psEntry )
-   {
-      return( ABCC_EC_NO_RESOURCES );
-   }
-
-   psMsg = ABCC_GetCmdMsgBuffer();
-   if( psMsg == NULL )
-   {
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_OUT_OF_MSG_BUFFERS );
-   }
-
-   ABCC_SetMsgHeader( psMsg, ABP_OBJ_NUM_FSI, iInstance, 0, ABP_FSI_CMD_DIRECTORY_CLOSE, 0, ABCC_GetNewSourceId() );
-   ABCC_SetMsgCmdExt( psMsg, 0 );
-
-   psEntry->bSrcId = ABCC_GetMsgSourceId( psMsg );
-   psEntry->pnCallback = pnCallback;
-
-   if( ABCC_SendCmdMsg( psMsg, anb_fsi_MsgResponseHandler ) != ABCC_EC_NO_ERROR )
-   {
-      ABCC_ReturnMsgBuffer( &psMsg );
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_NO_RESOURCES );
-   }
+   psReq = anb_fsi_NewRequest( iInstance, ABP_FSI_CMD_DIRECTORY_CLOSE, 0, pnCallback );
 
-   return( ABCC_EC_NO_ERROR );
+   return( anb_fsi_Submit( psReq ) );
 }
 
 ABCC_ErrorCodeType ANB_FSI_DirectoryDelete( UINT16 iInstance, char* pacName, ANB_FSI_CompletionCbfType pnCallback )
 {
-   ABP_MsgType*                  psMsg;
-   anb_fsi_TransactionEntryType* psEntry;
-
-   UINT16                        iSize;
+   anb_fsi_RequestType* psReq;
+   UINT16               iSize;
 
    if( ( iInstance == 0 ) ||
        ( pacName == NULL ) ||
@@ -938,40 +996,15 @@ ABCC_ErrorCodeType ANB_FSI_DirectoryDelete( UINT16 iInstance, char* pacName, ANB
       return( ABCC_EC_PARAMETER_NOT_VALID );
    }
 
-   psEntry = anb_fsi_AllocTransactionEntry();
-   if( !psEntry )
-   {
-      return( ABCC_EC_NO_RESOURCES );
-   }
-
-   psMsg = ABCC_GetCmdMsgBuffer();
-   if( psMsg == NULL )
-   {
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_OUT_OF_MSG_BUFFERS );
-   }
-
-   ABCC_SetMsgHeader( psMsg, ABP_OBJ_NUM_FSI, iInstance, 0, ABP_FSI_CMD_DIRECTORY_DELETE, iSize, ABCC_GetNewSourceId() );
-   ABCC_SetMsgCmdExt( psMsg, 0 );
-   ABCC_SetMsgString( psMsg, pacName, iSize, 0 );
+   psReq = anb_fsi_NewRequest( iInstance, ABP_FSI_CMD_DIRECTORY_DELETE, 0, pnCallback );
+   anb_fsi_AddRequestString( psReq, pacName, iSize );
 
-   psEntry->bSrcId = ABCC_GetMsgSourceId( psMsg );
-   psEntry->pnCallback = pnCallback;
-
-   if( ABCC_SendCmdMsg( psMsg, anb_fsi_MsgResponseHandler ) != ABCC_EC_NO_ERROR )
-   {
-      ABCC_ReturnMsgBuffer( &psMsg );
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_NO_RESOURCES );
-   }
-
-   return( ABCC_EC_NO_ERROR );
+   return( anb_fsi_Submit( psReq ) );
 }
 
 ABCC_ErrorCodeType ANB_FSI_DirectoryRead( UINT16 iInstance, ANB_FSI_DirEntryType* psDest, ANB_FSI_CompletionCbfType pnCallback )
 {
-   ABP_MsgType*                  psMsg;
-   anb_fsi_TransactionEntryType* psEntry;
+   anb_fsi_RequestType* psReq;
 
    if( ( iInstance == 0 ) ||
        ( psDest == NULL ) ||
@@ -980,42 +1013,40 @@ ABCC_ErrorCodeType ANB_FSI_DirectoryRead( UINT16 iInstance, ANB_FSI_DirEntryType
       return( ABCC_EC_PARAMETER_NOT_VALID );
    }
 
-   psEntry = anb_fsi_AllocTransactionEntry();
-   if( !psEntry )
-   {
-      return( ABCC_EC_NO_RESOURCES );
-   }
+   psReq = anb_fsi_NewRequest( iInstance, ABP_FSI_CMD_DIRECTORY_READ, 0, pnCallback );
+   psReq->uArgs.sDRead.psDirEntry = psDest;
 
-   psMsg = ABCC_GetCmdMsgBuffer();
-   if( psMsg == NULL )
-   {
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_OUT_OF_MSG_BUFFERS );
-   }
+   return( anb_fsi_Submit( psReq ) );
+}
 
-   ABCC_SetMsgHeader( psMsg, ABP_OBJ_NUM_FSI, iInstance, 0, ABP_FSI_CMD_DIRECTORY_READ, 0, ABCC_GetNewSourceId() );
-   ABCC_SetMsgCmdExt( psMsg, 0 );
+ABCC_ErrorCodeType ANB_FSI_DirectoryCreate( UINT16 iInstance, char* pacName, ANB_FSI_CompletionCbfType pnCallback )
+{
+   anb_fsi_RequestType* psReq;
+   UINT16               iSize;
 
-   psEntry->bSrcId = ABCC_GetMsgSourceId( psMsg );
-   psEntry->pnCallback = pnCallback;
-   psEntry->uArgs.sDRead.psDirEntry = psDest;
+   if( ( iInstance == 0 ) ||
+       ( pacName == NULL ) ||
+       ( pnCallback == NULL ) )
+   {
+      return( ABCC_EC_PARAMETER_NOT_VALID );
+   }
 
-   if( ABCC_SendCmdMsg( psMsg, anb_fsi_MsgResponseHandler ) != ABCC_EC_NO_ERROR )
+   iSize = anb_fsi_ValidateFilePathName( pacName );
+   if( iSize == 0 )
    {
-      ABCC_ReturnMsgBuffer( &psMsg );
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_NO_RESOURCES );
+      return( ABCC_EC_PARAMETER_NOT_VALID );
    }
 
-   return( ABCC_EC_NO_ERROR );
+   psReq = anb_fsi_NewRequest( iInstance, ABP_FSI_CMD_DIRECTORY_CREATE, 0, pnCallback );
+   anb_fsi_AddRequestString( psReq, pacName, iSize );
+
+   return( anb_fsi_Submit( psReq ) );
 }
 
-ABCC_ErrorCodeType ANB_FSI_DirectoryCreate( UINT16 iInstance, char* pacName, ANB_FSI_CompletionCbfType pnCallback )
+ABCC_ErrorCodeType ANB_FSI_DirectoryChange( UINT16 iInstance, char* pacName, ANB_FSI_CompletionCbfType pnCallback )
 {
-   ABP_MsgType*                  psMsg;
-   anb_fsi_TransactionEntryType* psEntry;
-
-   UINT16                        iSize;
+   anb_fsi_RequestType* psReq;
+   UINT16               iSize;
 
    if( ( iInstance == 0 ) ||
        ( pacName == NULL ) ||
@@ -1030,84 +1061,108 @@ ABCC_ErrorCodeType ANB_FSI_DirectoryCreate( UINT16 iInstance, char* pacName, ANB
       return( ABCC_EC_PARAMETER_NOT_VALID );
    }
 
-   psEntry = anb_fsi_AllocTransactionEntry();
-   if( !psEntry )
-   {
-      return( ABCC_EC_NO_RESOURCES );
-   }
+   psReq = anb_fsi_NewRequest( iInstance, ABP_FSI_CMD_DIRECTORY_CHANGE, 0, pnCallback );
+   anb_fsi_AddRequestString( psReq, pacName, iSize );
 
-   psMsg = ABCC_GetCmdMsgBuffer();
-   if( psMsg == NULL )
+   return( anb_fsi_Submit( psReq ) );
+}
+
+void ANB_FSI_Run( void )
+{
+   anb_fsi_RequestType* psReq;
+
+   while( anb_fsi_bQueueCount > 0 )
    {
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_OUT_OF_MSG_BUFFERS );
+      psReq = &anb_fsi_asRequestQueue[ anb_fsi_bQueueHead ];
+
+      if( anb_fsi_Dispatch( psReq ) != ABCC_EC_NO_ERROR )
+      {
+         break;
+      }
+
+      anb_fsi_bQueueHead = ( anb_fsi_bQueueHead + 1 ) % ( ANB_FSI_CMD_QUEUE_SIZE + 1 );
+      anb_fsi_bQueueCount--;
    }
 
-   ABCC_SetMsgHeader( psMsg, ABP_OBJ_NUM_FSI, iInstance, 0, ABP_FSI_CMD_DIRECTORY_CREATE, iSize, ABCC_GetNewSourceId() );
-   ABCC_SetMsgCmdExt( psMsg, 0 );
-   ABCC_SetMsgString( psMsg, pacName, iSize, 0 );
+   return;
+}
 
-   psEntry->bSrcId = ABCC_GetMsgSourceId( psMsg );
-   psEntry->pnCallback = pnCallback;
+BOOL ANB_FSI_IsRunPending( void )
+{
+   int xIndex;
 
-   if( ABCC_SendCmdMsg( psMsg, anb_fsi_MsgResponseHandler ) != ABCC_EC_NO_ERROR )
+   if( ( anb_fsi_bQueueCount == 0 ) || !ABCC_API_MsgSchedBulkAvailable() )
    {
-      ABCC_ReturnMsgBuffer( &psMsg );
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_NO_RESOURCES );
+      return( FALSE );
    }
 
-   return( ABCC_EC_NO_ERROR );
+   for( xIndex = 0; xIndex < ANB_FSI_MAX_CONCURRENT_OPERATIONS; xIndex++ )
+   {
+      if( !anb_fsi_TransactionList[ xIndex ].fInUse )
+      {
+         return( TRUE );
+      }
+   }
+
+   return( FALSE );
 }
 
-ABCC_ErrorCodeType ANB_FSI_DirectoryChange( UINT16 iInstance, char* pacName, ANB_FSI_CompletionCbfType pnCallback )
+#if ANB_FSI_CHECKSUM_ENABLE
+ABCC_ErrorCodeType ANB_FSI_AttachChecksum( UINT16 iInstance, ANB_FSI_ChecksumType* psChecksum )
 {
-   ABP_MsgType*                  psMsg;
-   anb_fsi_TransactionEntryType* psEntry;
-
-   UINT16                        iSize;
+   int xIndex;
+   int xFree;
 
    if( ( iInstance == 0 ) ||
-       ( pacName == NULL ) ||
-       ( pnCallback == NULL ) )
+       ( psChecksum == NULL ) )
    {
       return( ABCC_EC_PARAMETER_NOT_VALID );
    }
 
-   iSize = anb_fsi_ValidateFilePathName( pacName );
-   if( iSize == 0 )
+   xFree = -1;
+   for( xIndex = 0; xIndex < ANB_FSI_MAX_CHECKSUM_INSTANCES; xIndex++ )
    {
-      return( ABCC_EC_PARAMETER_NOT_VALID );
+      if( anb_fsi_asChecksumList[ xIndex ].psChecksum == NULL )
+      {
+         if( xFree < 0 )
+         {
+            xFree = xIndex;
+         }
+      }
+      else if( anb_fsi_asChecksumList[ xIndex ].iInstance == iInstance )
+      {
+         /*
+         ** Replace the context already attached to this instance.
+         */
+         anb_fsi_asChecksumList[ xIndex ].psChecksum = psChecksum;
+         return( ABCC_EC_NO_ERROR );
+      }
    }
 
-   psEntry = anb_fsi_AllocTransactionEntry();
-   if( !psEntry )
+   if( xFree < 0 )
    {
       return( ABCC_EC_NO_RESOURCES );
    }
 
-   psMsg = ABCC_GetCmdMsgBuffer();
-   if( psMsg == NULL )
-   {
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_OUT_OF_MSG_BUFFERS );
-   }
+   anb_fsi_asChecksumList[ xFree ].iInstance = iInstance;
+   anb_fsi_asChecksumList[ xFree ].psChecksum = psChecksum;
 
-   ABCC_SetMsgHeader( psMsg, ABP_OBJ_NUM_FSI, iInstance, 0, ABP_FSI_CMD_DIRECTORY_CHANGE, iSize, ABCC_GetNewSourceId() );
-   ABCC_SetMsgCmdExt( psMsg, 0 );
-   ABCC_SetMsgString( psMsg, pacName, iSize, 0 );
+   return( ABCC_EC_NO_ERROR );
+}
 
-   psEntry->bSrcId = ABCC_GetMsgSourceId( psMsg );
-   psEntry->pnCallback = pnCallback;
+void ANB_FSI_DetachChecksum( UINT16 iInstance )
+{
+   int xIndex;
 
-   if( ABCC_SendCmdMsg( psMsg, anb_fsi_MsgResponseHandler ) != ABCC_EC_NO_ERROR )
+   for( xIndex = 0; xIndex < ANB_FSI_MAX_CHECKSUM_INSTANCES; xIndex++ )
    {
-      ABCC_ReturnMsgBuffer( &psMsg );
-      anb_fsi_FreeTransactionEntry( psEntry );
-      return( ABCC_EC_NO_RESOURCES );
+      if( anb_fsi_asChecksumList[ xIndex ].iInstance == iInstance )
+      {
+         anb_fsi_asChecksumList[ xIndex ].iInstance = 0;
+         anb_fsi_asChecksumList[ xIndex ].psChecksum = NULL;
+      }
    }
-
-   return( ABCC_EC_NO_ERROR );
 }
+#endif /* ANB_FSI_CHECKSUM_ENABLE */
 
 #endif /* ANB_FSI_OBJ_ENABLE */
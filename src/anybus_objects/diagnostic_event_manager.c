@@ -0,0 +1,582 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Source file for the diagnostic event manager.
+********************************************************************************
+*/
+
+#include "abcc.h"
+
+#if DI_OBJ_ENABLE
+
+#include <inttypes.h>
+
+#include "diagnostic_object.h"
+#include "diagnostic_event_manager.h"
+#include "abcc_api_diag_history.h"
+
+/*******************************************************************************
+** Private constants.
+********************************************************************************
+*/
+
+/*******************************************************************************
+** Private typedefs
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Bookkeeping data for one diagnostic event.
+**
+** fRaised is the state requested by the application, fActive tells if a
+** Diagnostic object instance exists for the event in the CompactCom. The
+** manager sends commands from DI_MgrRun() until the two agree, one command at
+** a time per event. Only the latest requested state matters, an event that is
+** raised and cleared again before anything was sent causes no traffic.
+**------------------------------------------------------------------------------
+*/
+typedef struct
+{
+   BOOL              fInUse;
+   DI_MgrEventType   sEvent;
+   BOOL              fRaised;
+   BOOL              fActive;
+   BOOL              fInFlight;
+   UINT8             bSrcId;
+   UINT16            iInstance;
+   UINT16            iHoldOffMs;
+}
+di_mgr_EntryType;
+
+/*******************************************************************************
+** Private forward declarations
+********************************************************************************
+*/
+
+static void di_mgr_MsgResponseHandler( ABP_MsgType* psMsg );
+
+/*******************************************************************************
+** Private Globals
+********************************************************************************
+*/
+
+static di_mgr_EntryType di_mgr_asEntry[ DI_MGR_MAX_EVENTS ];
+
+/*
+** Token bucket for the create/delete commands.
+*/
+static UINT8 di_mgr_bTokens;
+static UINT16 di_mgr_iRefillMs;
+
+/*
+** Entry where the next flush in DI_MgrRun() starts.
+*/
+static UINT16 di_mgr_iNextIndex;
+
+/*******************************************************************************
+** Public Globals
+********************************************************************************
+*/
+
+/*******************************************************************************
+** Private Services
+********************************************************************************
+*/
+
+/*------------------------------------------------------------------------------
+** Compare two event identifications.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psA, psB - Events to compare.
+** Returns:
+**    TRUE if the events are the same.
+**------------------------------------------------------------------------------
+*/
+static BOOL di_mgr_SameEvent( const DI_MgrEventType* psA, const DI_MgrEventType* psB )
+{
+   return( ( psA->eSeverity == psB->eSeverity ) &&
+           ( psA->eEvent == psB->eEvent ) &&
+           ( psA->iSlot == psB->iSlot ) &&
+           ( psA->iAdi == psB->iAdi ) &&
+           ( psA->bElement == psB->bElement ) &&
+           ( psA->bBit == psB->bBit ) );
+}
+
+/*------------------------------------------------------------------------------
+** Find the entry of an event.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psEvent - Event to look for.
+** Returns:
+**    Pointer to the entry, NULL if the event is not tracked.
+**------------------------------------------------------------------------------
+*/
+static di_mgr_EntryType* di_mgr_FindEntry( const DI_MgrEventType* psEvent )
+{
+   UINT16 iIndex;
+
+   for( iIndex = 0; iIndex < DI_MGR_MAX_EVENTS; iIndex++ )
+   {
+      if( di_mgr_asEntry[ iIndex ].fInUse &&
+          di_mgr_SameEvent( &di_mgr_asEntry[ iIndex ].sEvent, psEvent ) )
+      {
+         return( &di_mgr_asEntry[ iIndex ] );
+      }
+   }
+
+   return( NULL );
+}
+
+/*------------------------------------------------------------------------------
+** Find the entry waiting for the response with the given source ID.
+**------------------------------------------------------------------------------
+** Arguments:
+**    bSrcId - Source ID of the response.
+** Returns:
+**    Pointer to the entry, NULL if no entry matched.
+**------------------------------------------------------------------------------
+*/
+static di_mgr_EntryType* di_mgr_FindEntryBySrcId( UINT8 bSrcId )
+{
+   UINT16 iIndex;
+
+   for( iIndex = 0; iIndex < DI_MGR_MAX_EVENTS; iIndex++ )
+   {
+      if( di_mgr_asEntry[ iIndex ].fInUse &&
+          di_mgr_asEntry[ iIndex ].fInFlight &&
+          ( di_mgr_asEntry[ iIndex ].bSrcId == bSrcId ) )
+      {
+         return( &di_mgr_asEntry[ iIndex ] );
+      }
+   }
+
+   return( NULL );
+}
+
+/*------------------------------------------------------------------------------
+** Allocate an entry for a new event.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psEvent - Event to track.
+** Returns:
+**    Pointer to the entry, NULL if no free entry was available.
+**------------------------------------------------------------------------------
+*/
+static di_mgr_EntryType* di_mgr_AllocEntry( const DI_MgrEventType* psEvent )
+{
+   UINT16 iIndex;
+
+   for( iIndex = 0; iIndex < DI_MGR_MAX_EVENTS; iIndex++ )
+   {
+      if( !di_mgr_asEntry[ iIndex ].fInUse )
+      {
+         di_mgr_asEntry[ iIndex ].fInUse = TRUE;
+         di_mgr_asEntry[ iIndex ].sEvent = *psEvent;
+         di_mgr_asEntry[ iIndex ].fRaised = FALSE;
+         di_mgr_asEntry[ iIndex ].fActive = FALSE;
+         di_mgr_asEntry[ iIndex ].fInFlight = FALSE;
+         di_mgr_asEntry[ iIndex ].bSrcId = 0;
+         di_mgr_asEntry[ iIndex ].iInstance = 0;
+         di_mgr_asEntry[ iIndex ].iHoldOffMs = 0;
+
+         return( &di_mgr_asEntry[ iIndex ] );
+      }
+   }
+
+   return( NULL );
+}
+
+/*------------------------------------------------------------------------------
+** Build and send the command that brings an entry closer to its requested
+** state.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psEntry - Entry to send a command for.
+**    fCreate - TRUE to create the diagnostic instance, FALSE to delete it.
+** Returns:
+**    ABCC_EC_NO_ERROR if the command was sent.
+**------------------------------------------------------------------------------
+*/
+static ABCC_ErrorCodeType di_mgr_SendCmd( di_mgr_EntryType* psEntry, BOOL fCreate )
+{
+   ABP_MsgType*         psMsg;
+   ABCC_ErrorCodeType   eResult;
+
+   psMsg = ABCC_GetCmdMsgBuffer();
+   if( psMsg == NULL )
+   {
+      return( ABCC_EC_OUT_OF_MSG_BUFFERS );
+   }
+
+   if( fCreate )
+   {
+      eResult = DI_BuildCmdCreateDiag( psMsg, psEntry->sEvent.eSeverity, psEntry->sEvent.eEvent );
+
+      if( ( eResult == ABCC_EC_NO_ERROR ) &&
+          ( ( psEntry->sEvent.iSlot != DI_MGR_SLOT_UNKNOWN ) ||
+            ( psEntry->sEvent.iAdi != DI_MGR_ADI_UNKNOWN ) ||
+            ( psEntry->sEvent.bElement != DI_MGR_ELEMENT_UNKNOWN ) ||
+            ( psEntry->sEvent.bBit != DI_MGR_BIT_UNKNOWN ) ) )
+      {
+         eResult = DI_BuildCmdAddExtDiag( psMsg,
+                                          psEntry->sEvent.iSlot,
+                                          psEntry->sEvent.iAdi,
+                                          psEntry->sEvent.bElement,
+                                          psEntry->sEvent.bBit );
+      }
+
+      if( eResult != ABCC_EC_NO_ERROR )
+      {
+         ABCC_ReturnMsgBuffer( &psMsg );
+         return( eResult );
+      }
+
+      ABCC_SetMsgSourceId( psMsg, ABCC_GetNewSourceId() );
+   }
+   else
+   {
+      ABCC_SetMsgHeader( psMsg, ABP_OBJ_NUM_DI, ABP_INST_OBJ, 0, ABP_CMD_DELETE, 0, ABCC_GetNewSourceId() );
+      ABCC_SetMsgCmdExt( psMsg, psEntry->iInstance );
+   }
+
+   psEntry->bSrcId = ABCC_GetMsgSourceId( psMsg );
+   psEntry->fInFlight = TRUE;
+
+   if( ABCC_SendCmdMsg( psMsg, di_mgr_MsgResponseHandler ) != ABCC_EC_NO_ERROR )
+   {
+      ABCC_ReturnMsgBuffer( &psMsg );
+      psEntry->fInFlight = FALSE;
+      return( ABCC_EC_NO_RESOURCES );
+   }
+
+   return( ABCC_EC_NO_ERROR );
+}
+
+/*------------------------------------------------------------------------------
+** Work on an entry: send a create or delete command if the requested state
+** differs from the state in the CompactCom, or free the entry if the event is
+** gone.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psEntry - Entry to process.
+** Returns:
+**    ABCC_EC_NO_ERROR if a command was sent.
+**    ABCC_EC_INCORRECT_STATE if nothing needed to be sent right now.
+**    ABCC_EC_OUT_OF_MSG_BUFFERS or ABCC_EC_NO_RESOURCES if a command could
+**    not be sent.
+**------------------------------------------------------------------------------
+*/
+static ABCC_ErrorCodeType di_mgr_ProcessEntry( di_mgr_EntryType* psEntry )
+{
+   BOOL fCreate;
+   ABCC_ErrorCodeType eResult;
+
+   if( psEntry->fInFlight )
+   {
+      return( ABCC_EC_INCORRECT_STATE );
+   }
+
+   if( psEntry->fRaised == psEntry->fActive )
+   {
+      if( !psEntry->fRaised )
+      {
+         psEntry->fInUse = FALSE;
+      }
+      return( ABCC_EC_INCORRECT_STATE );
+   }
+
+   fCreate = psEntry->fRaised;
+
+   if( !fCreate && ( psEntry->iHoldOffMs > 0 ) )
+   {
+      return( ABCC_EC_INCORRECT_STATE );
+   }
+
+   if( di_mgr_bTokens == 0 )
+   {
+      return( ABCC_EC_NO_RESOURCES );
+   }
+
+   eResult = di_mgr_SendCmd( psEntry, fCreate );
+   if( eResult == ABCC_EC_NO_ERROR )
+   {
+      di_mgr_bTokens--;
+   }
+   else if( eResult == ABCC_EC_PARAMETER_NOT_VALID )
+   {
+      ABCC_LOG_WARNING( ABCC_EC_PARAMETER_NOT_VALID,
+         psEntry->sEvent.eEvent,
+         "Invalid diagnostic event dropped\n" );
+      psEntry->fInUse = FALSE;
+      eResult = ABCC_EC_INCORRECT_STATE;
+   }
+
+   return( eResult );
+}
+
+/*------------------------------------------------------------------------------
+** Message handler for responses from the Diagnostic object.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psMsg - Pointer to message buffer.
+** Returns:
+**    -
+**------------------------------------------------------------------------------
+*/
+static void di_mgr_MsgResponseHandler( ABP_MsgType* psMsg )
+{
+   di_mgr_EntryType* psEntry;
+
+   psEntry = di_mgr_FindEntryBySrcId( ABCC_GetMsgSourceId( psMsg ) );
+   if( !psEntry )
+   {
+      /*
+      ** The event was forgotten by DI_MgrInit() while the command was in
+      ** flight.
+      */
+      return;
+   }
+
+   psEntry->fInFlight = FALSE;
+
+   if( ABCC_GetMsgCmdBits( psMsg ) == ABP_CMD_CREATE )
+   {
+      if( ABCC_VerifyMessage( psMsg ) == ABCC_EC_NO_ERROR )
+      {
+         ABCC_GetMsgData16( psMsg, &psEntry->iInstance, 0 );
+         psEntry->fActive = TRUE;
+#if ABCC_API_DIAG_HISTORY_ENABLE
+         ABCC_API_DiagHistoryRecord( ABCC_API_DIAG_HIST_DI_CREATED,
+                                     (UINT8)psEntry->sEvent.eSeverity,
+                                     (UINT8)psEntry->sEvent.eEvent,
+                                     psEntry->iInstance );
+#endif
+      }
+      else
+      {
+         /*
+         ** Retrying would most likely fail the same way, drop the event
+         ** rather than flooding the message channel.
+         */
+         ABCC_LOG_WARNING( ABCC_EC_RESP_MSG_E_BIT_SET,
+            ABCC_GetErrorCode( psMsg ),
+            "Failed to create diagnostic event 0x%02X\n",
+            psEntry->sEvent.eEvent );
+         psEntry->fRaised = FALSE;
+      }
+   }
+   else
+   {
+      if( ABCC_VerifyMessage( psMsg ) != ABCC_EC_NO_ERROR )
+      {
+         ABCC_LOG_WARNING( ABCC_EC_RESP_MSG_E_BIT_SET,
+            ABCC_GetErrorCode( psMsg ),
+            "Failed to delete diagnostic instance %" PRIu16 "\n",
+            psEntry->iInstance );
+      }
+#if ABCC_API_DIAG_HISTORY_ENABLE
+      else
+      {
+         ABCC_API_DiagHistoryRecord( ABCC_API_DIAG_HIST_DI_DELETED,
+                                     (UINT8)psEntry->sEvent.eSeverity,
+                                     (UINT8)psEntry->sEvent.eEvent,
+                                     psEntry->iInstance );
+      }
+#endif
+      psEntry->fActive = FALSE;
+      psEntry->iInstance = 0;
+   }
+}
+
+/*******************************************************************************
+** Public Services
+********************************************************************************
+*/
+
+void DI_MgrInit( void )
+{
+   UINT16 iIndex;
+
+   for( iIndex = 0; iIndex < DI_MGR_MAX_EVENTS; iIndex++ )
+   {
+      di_mgr_asEntry[ iIndex ].fInUse = FALSE;
+      di_mgr_asEntry[ iIndex ].fInFlight = FALSE;
+   }
+
+   di_mgr_bTokens = DI_MGR_RATE_BURST;
+   di_mgr_iRefillMs = 0;
+   di_mgr_iNextIndex = 0;
+}
+
+ABCC_ErrorCodeType DI_MgrRaise( const DI_MgrEventType* psEvent )
+{
+   di_mgr_EntryType* psEntry;
+
+   if( psEvent == NULL )
+   {
+      return( ABCC_EC_PARAMETER_NOT_VALID );
+   }
+
+   psEntry = di_mgr_FindEntry( psEvent );
+   if( psEntry == NULL )
+   {
+      psEntry = di_mgr_AllocEntry( psEvent );
+      if( psEntry == NULL )
+      {
+         return( ABCC_EC_NO_RESOURCES );
+      }
+   }
+
+   if( psEntry->fRaised )
+   {
+      return( ABCC_EC_NO_ERROR );
+   }
+
+   psEntry->fRaised = TRUE;
+   psEntry->iHoldOffMs = 0;
+
+   return( ABCC_EC_NO_ERROR );
+}
+
+void DI_MgrClear( const DI_MgrEventType* psEvent )
+{
+   di_mgr_EntryType* psEntry;
+
+   if( psEvent == NULL )
+   {
+      return;
+   }
+
+   psEntry = di_mgr_FindEntry( psEvent );
+   if( ( psEntry == NULL ) || !psEntry->fRaised )
+   {
+      return;
+   }
+
+   psEntry->fRaised = FALSE;
+   psEntry->iHoldOffMs = DI_MGR_HOLD_OFF_MS;
+}
+
+void DI_MgrRun( void )
+{
+   UINT16               iCount;
+   UINT16               iIndex;
+   UINT8                bSent;
+   ABCC_ErrorCodeType   eResult;
+
+   bSent = 0;
+
+   /*
+   ** Continue where the previous flush stopped, so that every event gets its
+   ** turn when the batch limit is reached.
+   */
+   for( iCount = 0; iCount < DI_MGR_MAX_EVENTS; iCount++ )
+   {
+      iIndex = di_mgr_iNextIndex;
+      di_mgr_iNextIndex = ( di_mgr_iNextIndex + 1 ) % DI_MGR_MAX_EVENTS;
+
+      if( !di_mgr_asEntry[ iIndex ].fInUse )
+      {
+         continue;
+      }
+
+      eResult = di_mgr_ProcessEntry( &di_mgr_asEntry[ iIndex ] );
+      if( eResult == ABCC_EC_NO_ERROR )
+      {
+         bSent++;
+         if( bSent >= DI_MGR_MAX_CMDS_PER_RUN )
+         {
+            break;
+         }
+      }
+      else if( eResult != ABCC_EC_INCORRECT_STATE )
+      {
+         /*
+         ** Out of tokens or message buffers, try again in the next cycle
+         ** starting with this event.
+         */
+         di_mgr_iNextIndex = iIndex;
+         break;
+      }
+   }
+}
+
+void DI_MgrRunTimer( const INT16 iDeltaTimeMs )
+{
+   UINT16 iIndex;
+
+   if( iDeltaTimeMs <= 0 )
+   {
+      return;
+   }
+
+   for( iIndex = 0; iIndex < DI_MGR_MAX_EVENTS; iIndex++ )
+   {
+      if( di_mgr_asEntry[ iIndex ].iHoldOffMs > (UINT16)iDeltaTimeMs )
+      {
+         di_mgr_asEntry[ iIndex ].iHoldOffMs -= (UINT16)iDeltaTimeMs;
+      }
+      else
+      {
+         di_mgr_asEntry[ iIndex ].iHoldOffMs = 0;
+      }
+   }
+
+   di_mgr_iRefillMs += (UINT16)iDeltaTimeMs;
+   while( ( di_mgr_iRefillMs >= DI_MGR_RATE_REFILL_MS ) &&
+          ( di_mgr_bTokens < DI_MGR_RATE_BURST ) )
+   {
+      di_mgr_iRefillMs -= DI_MGR_RATE_REFILL_MS;
+      di_mgr_bTokens++;
+   }
+
+   if( di_mgr_bTokens == DI_MGR_RATE_BURST )
+   {
+      di_mgr_iRefillMs = 0;
+   }
+}
+
+UINT32 DI_MgrNextRunMs( void )
+{
+   const di_mgr_EntryType* psEntry;
+   UINT32               lNextMs;
+   UINT32               lEntryMs;
+   UINT16               iIndex;
+
+   lNextMs = 0xFFFFFFFF;
+
+   for( iIndex = 0; iIndex < DI_MGR_MAX_EVENTS; iIndex++ )
+   {
+      psEntry = &di_mgr_asEntry[ iIndex ];
+      if( !psEntry->fInUse || psEntry->fInFlight )
+      {
+         continue;
+      }
+
+      if( psEntry->fRaised == psEntry->fActive )
+      {
+         /*
+         ** Only the entry is released, which needs no command.
+         */
+         continue;
+      }
+
+      lEntryMs = psEntry->fRaised ? 0 : psEntry->iHoldOffMs;
+      if( ( lEntryMs == 0 ) && ( di_mgr_bTokens == 0 ) )
+      {
+         lEntryMs = ( di_mgr_iRefillMs < DI_MGR_RATE_REFILL_MS ) ?
+                    (UINT32)( DI_MGR_RATE_REFILL_MS - di_mgr_iRefillMs ) : 0;
+      }
+
+      if( lEntryMs < lNextMs )
+      {
+         lNextMs = lEntryMs;
+      }
+   }
+
+   return( lNextMs );
+}
+
+#endif /* DI_OBJ_ENABLE */
@@ -241,6 +241,27 @@ static BOOL di_prt_ValidateExtChannelDiagArgs( UINT16 iChannelErrorType, UINT16
    return( FALSE );
 }
 
+/*------------------------------------------------------------------------------
+** Encode already validated ChannelDiagnosis values in the form they are
+** written to the message buffer, with ChannelProperties.Specifier set to
+** Appears.
+**------------------------------------------------------------------------------
+** Arguments:
+**    psEnc - Destination.
+**    iChannelNumber, iChannelProperties, iChannelErrorType - Values to encode.
+** Returns:
+**    None.
+**------------------------------------------------------------------------------
+*/
+static void di_prt_EncodeChannelDiag( DI_PRT_ChannelEncType* psEnc, UINT16 iChannelNumber, UINT16 iChannelProperties, UINT16 iChannelErrorType )
+{
+   iChannelProperties = ( iChannelProperties & (UINT16)~( DI_PRT_CHAN_PROP_SPEC_MASK ) ) | DI_PRT_CHAN_PROP_SPEC_APPEARS;
+
+   psEnc->iChannelNumberBe = iTOiBe( iChannelNumber );
+   psEnc->iChannelPropertiesBe = iTOiBe( iChannelProperties );
+   psEnc->iChannelErrorTypeBe = iTOiBe( iChannelErrorType );
+}
+
 #endif /* PRT_OBJ_ENABLE */
 
 /*******************************************************************************
@@ -342,7 +363,7 @@ ABCC_ErrorCodeType DI_BuildCmdAddExtDiag( ABP_MsgType* psMsg, UINT16 iSlot, UINT
 
 ABCC_ErrorCodeType DI_PRT_BuildCmdAddChannelDiag( ABP_MsgType* psMsg, UINT16 iChannelNumber, UINT16 iChannelProperties, UINT16 iChannelErrorType )
 {
-   UINT16 iOffset;
+   DI_PRT_ChannelEncType sEnc;
 
    if( psMsg == NULL )
    {
@@ -354,10 +375,58 @@ ABCC_ErrorCodeType DI_PRT_BuildCmdAddChannelDiag( ABP_MsgType* psMsg, UINT16 iCh
       return( ABCC_EC_PARAMETER_NOT_VALID );
    }
 
+   di_prt_EncodeChannelDiag( &sEnc, iChannelNumber, iChannelProperties, iChannelErrorType );
+
+   return( DI_PRT_BuildCmdAddChannelDiagEnc( psMsg, &sEnc ) );
+}
+
+ABCC_ErrorCodeType DI_PRT_EncodeChannelTable( const DI_PRT_ChannelDescType* pasDesc, DI_PRT_ChannelEncType* pasEnc, UINT16 iNumDesc )
+{
+   UINT16 iIndex;
+
+   if( ( pasDesc == NULL ) || ( pasEnc == NULL ) )
+   {
+      return( ABCC_EC_PARAMETER_NOT_VALID );
+   }
+
+   /*
+   ** Check the whole table first so that a bad entry does not leave a
+   ** partially encoded table behind.
+   */
+   for( iIndex = 0; iIndex < iNumDesc; iIndex++ )
+   {
+      if( !di_prt_ValidateChannelDiagArgs( pasDesc[ iIndex ].iChannelNumber,
+                                           pasDesc[ iIndex ].iChannelProperties,
+                                           pasDesc[ iIndex ].iChannelErrorType ) )
+      {
+         return( ABCC_EC_PARAMETER_NOT_VALID );
+      }
+   }
+
+   for( iIndex = 0; iIndex < iNumDesc; iIndex++ )
+   {
+      di_prt_EncodeChannelDiag( &pasEnc[ iIndex ],
+                                pasDesc[ iIndex ].iChannelNumber,
+                                pasDesc[ iIndex ].iChannelProperties,
+                                pasDesc[ iIndex ].iChannelErrorType );
+   }
+
+   return( ABCC_EC_NO_ERROR );
+}
+
+ABCC_ErrorCodeType DI_PRT_BuildCmdAddChannelDiagEnc( ABP_MsgType* psMsg, const DI_PRT_ChannelEncType* psEnc )
+{
+   UINT16 iOffset;
+
+   if( ( psMsg == NULL ) || ( psEnc == NULL ) )
+   {
+      return( ABCC_EC_PARAMETER_NOT_VALID );
+   }
+
    iOffset = ABCC_GetMsgDataSize( psMsg );
 
    /*
-   ** DI_PRT_BuildCmdAddChannelDiag() is supposed to be called after
+   ** The ChannelDiagnosis structure is supposed to be added after
    ** DI_BuildCmdCreateDiag() and DI_BuildCmdAddExtDiag() has written their
    ** data to the message buffer. Check that the buffer has the expected values
    ** in place.
@@ -380,14 +449,13 @@ ABCC_ErrorCodeType DI_PRT_BuildCmdAddChannelDiag( ABP_MsgType* psMsg, UINT16 iCh
    ABCC_SetMsgData16( psMsg, DI_PRT_USI_CHAN_DIAG, iOffset );
    iOffset += ABP_UINT16_SIZEOF;
 
-   ABCC_SetMsgData16( psMsg, iTOiBe( iChannelNumber ), iOffset );
+   ABCC_SetMsgData16( psMsg, psEnc->iChannelNumberBe, iOffset );
    iOffset += ABP_UINT16_SIZEOF;
 
-   iChannelProperties = ( iChannelProperties & (UINT16)~( DI_PRT_CHAN_PROP_SPEC_MASK ) ) | DI_PRT_CHAN_PROP_SPEC_APPEARS;
-   ABCC_SetMsgData16( psMsg, iTOiBe( iChannelProperties ), iOffset );
+   ABCC_SetMsgData16( psMsg, psEnc->iChannelPropertiesBe, iOffset );
    iOffset += ABP_UINT16_SIZEOF;
 
-   ABCC_SetMsgData16( psMsg, iTOiBe( iChannelErrorType ), iOffset );
+   ABCC_SetMsgData16( psMsg, psEnc->iChannelErrorTypeBe, iOffset );
    iOffset += ABP_UINT16_SIZEOF;
 
    ABCC_SetMsgDataSize( psMsg, iOffset );
@@ -133,6 +133,12 @@ static ad_MapType ad_PdWriteMapping[ AD_MAX_NUM_WRITE_MAP_ENTRIES ];
 static ad_MapInfoType ad_ReadMapInfo;
 static ad_MapInfoType ad_WriteMapInfo;
 
+/*------------------------------------------------------------------------------
+** Set when a remap command has changed the maps built by AD_Init().
+**------------------------------------------------------------------------------
+*/
+static BOOL ad_fMapChanged = FALSE;
+
 /*------------------------------------------------------------------------------
 ** Converts number of octet offset to byte offset.
 **------------------------------------------------------------------------------
@@ -673,6 +679,8 @@ static void RemapProcessDataCommand( ABP_MsgType* psMsg,
 
    if( bErrCode == ABP_ERR_NO_ERROR )
    {
+      ad_fMapChanged = TRUE;
+
       /*
       ** Move ADI if required
       */
@@ -1756,6 +1764,7 @@ EXTFUNC ABCC_ErrorCodeType AD_Init( const AD_AdiEntryType* psAdiEntry,
 
    ad_iNumOfADIs =  iNumAdi;
    ad_iHighestInstanceNumber = 0;
+   ad_fMapChanged = FALSE;
 
    ad_ReadMapInfo.paiMappedAdiList = ad_PdReadMapping;
    ad_ReadMapInfo.iPdSize = 0;
@@ -2933,6 +2942,15 @@ void AD_GetAdiValue( const AD_AdiEntryType* psAdiEntry,
    }
 }
 
+/*------------------------------------------------------------------------------
+** Check if the maps are still the ones built by AD_Init().
+**------------------------------------------------------------------------------
+*/
+BOOL AD_IsDefaultMap( void )
+{
+   return( !ad_fMapChanged );
+}
+
 /*------------------------------------------------------------------------------
 ** Get the total data size of the present WR/RD PD map.
 **------------------------------------------------------------------------------
@@ -203,6 +203,19 @@ EXTFUNC void AD_WritePdMapFromBuffer( const AD_MapType* pasMap,
                                       void* pxSrcPdDataBuf,
                                       UINT16* piOctetOffset );
 
+/*------------------------------------------------------------------------------
+** Check if the read and write maps are still the default maps set up by
+** AD_Init(), i.e. no remap command has changed them since.
+**------------------------------------------------------------------------------
+** Arguments:
+**    None
+**
+** Returns:
+**    TRUE if the maps have not been remapped.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL AD_IsDefaultMap( void );
+
 /*------------------------------------------------------------------------------
 ** Get the total data size of the present WR/RD PD map.
 **------------------------------------------------------------------------------
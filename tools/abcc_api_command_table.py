@@ -0,0 +1,575 @@
+#!/usr/bin/env python3
+#
+# Copyright 2025-present HMS Industrial Networks AB.
+# Licensed under the MIT License.
+#
+"""Generate the command handler lookup table of the ABCC API.
+
+The input is a compact description of the commands the host objects respond
+to. Each line names one of the predefined entries of
+abcc_api_command_handler_lookup.h, with its arguments if it takes any:
+
+    # Application object
+    APP_OBJ_OBJ_ATTRIBUTES
+    ABCC_APPLICATION_OBJ_CONFIGURED_GET_CBFUNC
+    ABCC_APPLICATION_OBJ_SERIAL_NR_GET_VALUE( 0x12345678 )
+
+The output is a header holding the expanded entries sorted by object,
+instance, command and attribute, the keys of the entries in a separate
+table of four octets per entry, and the range of each object in the tables.
+abcc_api_command_handler.c includes it when ABCC_API_COMMAND_TABLE_GENERATED
+is set, and finds the entry of a command with two binary searches over the
+keys instead of scanning the whole table.
+
+Before the header is written, every entry and its near misses are looked up
+in a model of the binary searches of abcc_api_command_handler.c and of the
+linear scan used for ABCC_API_COMMAND_RESPONSE_LIST. The generator fails if
+the two lookups would respond differently to any of them.
+
+The object, instance, command and attribute of each entry are resolved from
+the #define and enum values of the headers in the include directories. The
+conditions the predefined entries depend on, e.g. APP_OBJ_ENABLE, are left to
+the compiler: the output stops the build with #error if they do not match the
+configuration.
+"""
+
+import argparse
+import ast
+import bisect
+import os
+import re
+import sys
+
+IDENTIFIER = re.compile(r"[A-Za-z_][A-Za-z0-9_]*")
+STRING_OR_CHAR = re.compile(r'"(?:\\.|[^"\\])*"|\'(?:\\.|[^\'\\])*\'')
+OBJ_ATTRIBUTES = re.compile(r"^([A-Z0-9]+)_OBJ_OBJ_ATTRIBUTES$")
+CAST = re.compile(r"\(\s*(?:const\s+)?(?:U?INT(?:8|16|32|64)|BOOL8?|"
+                  r"(?:unsigned\s+)?(?:char|short|int|long))\s*\)")
+INT_SUFFIX = re.compile(r"\b(0[xX][0-9A-Fa-f]+|[0-9]+)[uUlL]+\b")
+
+
+class GeneratorError(Exception):
+    pass
+
+
+class Macro:
+    """A predefined entry macro of the lookup header."""
+
+    def __init__(self, name, params, body, conditions):
+        self.name = name
+        self.params = params
+        self.body = body
+        self.conditions = conditions
+
+
+class Entry:
+    """One initializer of the lookup table."""
+
+    def __init__(self, text, source, key, fields):
+        self.text = text
+        self.source = source
+        self.key = key
+        self.fields = fields
+
+
+def strip_comments(text):
+    text = re.sub(r"/\*.*?\*/", lambda m: " " * m.group(0).count("\n") + " ",
+                  text, flags=re.S)
+    return re.sub(r"//[^\n]*", "", text)
+
+
+def logical_lines(text):
+    """Yield ( line number, line ) with continuation lines joined."""
+    pending = ""
+    first = 0
+    for number, line in enumerate(text.splitlines(), 1):
+        if not pending:
+            first = number
+        if line.rstrip().endswith("\\"):
+            pending += line.rstrip()[:-1] + " "
+            continue
+        yield first, pending + line
+        pending = ""
+    if pending:
+        yield first, pending
+
+
+def split_top_level(text, separator=","):
+    """Split at separators outside of braces, parentheses and strings."""
+    parts = []
+    depth = 0
+    start = 0
+    index = 0
+    while index < len(text):
+        match = STRING_OR_CHAR.match(text, index)
+        if match:
+            index = match.end()
+            continue
+        char = text[index]
+        if char in "({[":
+            depth += 1
+        elif char in ")}]":
+            depth -= 1
+        elif char == separator and depth == 0:
+            parts.append(text[start:index])
+            start = index + 1
+        index += 1
+    parts.append(text[start:])
+    return [part.strip() for part in parts]
+
+
+def brace_groups(text):
+    """Return the top level { ... } groups of a macro body."""
+    groups = []
+    depth = 0
+    start = None
+    index = 0
+    while index < len(text):
+        match = STRING_OR_CHAR.match(text, index)
+        if match:
+            index = match.end()
+            continue
+        char = text[index]
+        if char == "{":
+            if depth == 0:
+                start = index
+            depth += 1
+        elif char == "}":
+            depth -= 1
+            if depth == 0:
+                groups.append(text[start:index + 1])
+        index += 1
+    if depth != 0:
+        raise GeneratorError("unbalanced braces in '%s'" % text.strip())
+    return groups
+
+
+def substitute(text, values):
+    """Replace identifiers outside of string literals."""
+    result = []
+    index = 0
+    for match in STRING_OR_CHAR.finditer(text):
+        result.append(IDENTIFIER.sub(
+            lambda m: values.get(m.group(0), m.group(0)),
+            text[index:match.start()]))
+        result.append(match.group(0))
+        index = match.end()
+    result.append(IDENTIFIER.sub(lambda m: values.get(m.group(0), m.group(0)),
+                                 text[index:]))
+    return "".join(result)
+
+
+def branch_condition(chain):
+    """Return the condition of the current branch of an #if chain.
+
+    chain holds the condition of each branch so far, "" for an #else and None
+    for one that is not checked, e.g. an #ifdef. A branch is taken if none of
+    the earlier branches was and its own condition holds. None if that cannot
+    be checked.
+    """
+    if None in chain:
+        return None
+    if len(chain) == 1:
+        return chain[0]
+    terms = ["!( %s )" % term for term in chain[:-1]]
+    if chain[-1]:
+        terms.append("( %s )" % chain[-1])
+    return " && ".join(terms)
+
+
+def parse_lookup_header(path):
+    """Return the entry macros of the lookup header, by name.
+
+    Only the definitions holding entries are kept, the empty ones in the
+    #else branches are the fallbacks for disabled objects.
+    """
+    with open(path, encoding="utf-8", errors="replace") as file:
+        text = strip_comments(file.read())
+
+    macros = {}
+    # The branch conditions of each open #if chain, see branch_condition().
+    chains = []
+    for _, line in logical_lines(text):
+        directive = re.match(r"\s*#\s*(\w+)\s*(.*)", line)
+        if not directive:
+            continue
+        keyword, rest = directive.group(1), directive.group(2).strip()
+        if keyword == "if":
+            chains.append([rest])
+        elif keyword in ("ifdef", "ifndef"):
+            chains.append([None])
+        elif keyword in ("else", "elif"):
+            if chains:
+                chains[-1].append(rest if keyword == "elif" else "")
+        elif keyword == "endif":
+            if chains:
+                chains.pop()
+        elif keyword == "define":
+            match = re.match(r"(\w+)(\(([^)]*)\))?\s*(.*)", rest)
+            name, params, body = match.group(1), match.group(3), match.group(4)
+            if "{" not in body or name in macros:
+                continue
+            conditions = [branch_condition(chain) for chain in chains]
+            macros[name] = Macro(
+                name,
+                [p.strip() for p in params.split(",")] if params else [],
+                body,
+                [c for c in conditions if c is not None])
+    return macros
+
+
+class SymbolTable:
+    """Integer values of the #define and enum constants of the headers."""
+
+    def __init__(self):
+        self.defines = {}
+        self.enums = {}
+
+    def load_dir(self, directory):
+        for name in sorted(os.listdir(directory)):
+            path = os.path.join(directory, name)
+            if name.endswith(".h") and os.path.isfile(path):
+                self.load_file(path)
+
+    def load_file(self, path):
+        with open(path, encoding="utf-8", errors="replace") as file:
+            text = strip_comments(file.read())
+
+        for _, line in logical_lines(text):
+            match = re.match(r"\s*#\s*define\s+(\w+)\s+(.+)", line)
+            if match and match.group(1) not in self.defines:
+                self.defines[match.group(1)] = match.group(2).strip()
+
+        for match in re.finditer(r"\benum\b[^{;]*\{([^}]*)\}", text):
+            previous = None
+            for member in split_top_level(match.group(1)):
+                if not member:
+                    continue
+                name, _, value = member.partition("=")
+                name = name.strip()
+                if value.strip():
+                    value = value.strip()
+                elif previous is None:
+                    value = "0"
+                else:
+                    value = "( %s ) + 1" % previous
+                self.enums.setdefault(name, value)
+                previous = name
+
+    def value(self, expression, seen=()):
+        text = INT_SUFFIX.sub(r"\1", CAST.sub(" ", expression))
+
+        def resolve(match):
+            name = match.group(0)
+            if name in seen:
+                raise GeneratorError("recursive definition of %s" % name)
+            definition = self.defines.get(name, self.enums.get(name))
+            if definition is None:
+                raise GeneratorError("cannot resolve %s" % name)
+            return "(%d)" % self.value(definition, seen + (name,))
+
+        text = re.sub(r"\b(?!0[xX])[A-Za-z_]\w*", resolve, text)
+        return evaluate(text)
+
+
+def evaluate(text):
+    """Evaluate an integer constant expression."""
+    text = text.replace("&&", " and ").replace("||", " or ")
+    try:
+        tree = ast.parse(text.strip(), mode="eval")
+    except SyntaxError:
+        raise GeneratorError("cannot evaluate '%s'" % text.strip())
+    allowed = (ast.Expression, ast.BinOp, ast.UnaryOp, ast.Constant,
+               ast.operator, ast.unaryop, ast.BoolOp, ast.boolop)
+    for node in ast.walk(tree):
+        if not isinstance(node, allowed):
+            raise GeneratorError("cannot evaluate '%s'" % text.strip())
+    return int(eval(compile(tree, "<expression>", "eval")))
+
+
+def entry_fields(group):
+    fields = {}
+    for field in split_top_level(group.strip()[1:-1]):
+        if not field:
+            continue
+        name, _, value = field.partition("=")
+        fields[name.strip()] = value.strip()
+    return fields
+
+
+def entry_key(fields, group, symbols):
+    """Return ( object, instance, command, attribute ) of an entry."""
+    key = []
+    for name in (".bObject", ".bInstance", ".bCommand", ".uCmdExt.bAttr"):
+        if name in fields:
+            key.append(symbols.value(fields[name]))
+        elif name == ".uCmdExt.bAttr":
+            key.append(0)
+        else:
+            raise GeneratorError("entry without %s: %s" % (name, group))
+    return tuple(key)
+
+
+def parse_description(path, macros, symbols):
+    """Return the entries and the used macros of the description file."""
+    entries = []
+    used = []
+    with open(path, encoding="utf-8") as file:
+        lines = file.read().splitlines()
+
+    for number, line in enumerate(lines, 1):
+        line = line.split("#", 1)[0].strip().rstrip(",")
+        if not line:
+            continue
+        where = "%s:%d" % (os.path.basename(path), number)
+
+        match = re.match(r"(\w+)\s*(\((.*)\))?$", line)
+        if not match:
+            raise GeneratorError("%s: cannot parse '%s'" % (where, line))
+        name, args = match.group(1), match.group(3)
+        macro = macros.get(name)
+        if macro is None:
+            raise GeneratorError("%s: unknown entry %s" % (where, name))
+
+        args = split_top_level(args) if args is not None else []
+        if args == [""]:
+            args = []
+        if len(args) != len(macro.params):
+            raise GeneratorError("%s: %s takes %d arguments, %d given"
+                                 % (where, name, len(macro.params), len(args)))
+
+        body = substitute(macro.body, dict(zip(macro.params, args)))
+        for group in brace_groups(body):
+            fields = entry_fields(group)
+            try:
+                key = entry_key(fields, group, symbols)
+            except GeneratorError as error:
+                raise GeneratorError("%s: %s" % (where, error))
+            entries.append(Entry(" ".join(group.split()), line, key, fields))
+        used.append(macro)
+    return entries, used
+
+
+def sort_entries(entries):
+    """Return the entries sorted by key, rejecting duplicated keys."""
+    entries = sorted(entries, key=lambda entry: entry.key)
+    for previous, entry in zip(entries, entries[1:]):
+        if previous.key == entry.key:
+            raise GeneratorError("%s and %s respond to the same command"
+                                 % (previous.source, entry.source))
+    return entries
+
+
+def object_ranges(entries):
+    """Return [ object, first, end ] of each object in the sorted entries."""
+    objects = []
+    for index, entry in enumerate(entries):
+        if not objects or objects[-1][0] != entry.key[0]:
+            objects.append([entry.key[0], index, index + 1])
+        else:
+            objects[-1][2] = index + 1
+    return objects
+
+
+def linear_lookup(entries, message, attr_commands):
+    """Model of SetResponseMessage() scanning an unsorted table.
+
+    Returns the entries tried in turn by FindCommandHandler(), or the error
+    response if there are none.
+    """
+    obj, inst, cmd, attr = message
+    if not any(entry.key[0] == obj for entry in entries):
+        return "ABP_ERR_UNSUP_OBJ"
+    if not any(entry.key[:2] == (obj, inst) for entry in entries):
+        return "ABP_ERR_UNSUP_INST"
+    tried = [entry for entry in entries
+             if entry.key[:3] == (obj, inst, cmd) and
+             (cmd not in attr_commands or entry.key[3] == attr)]
+    return tried or "ABP_ERR_UNSUP_CMD"
+
+
+def binary_lookup(entries, objects, message, attr_commands):
+    """Model of SetResponseMessage() searching the generated table."""
+    obj, inst, cmd, attr = message
+    index = bisect.bisect_left([o[0] for o in objects], obj)
+    if index == len(objects) or objects[index][0] != obj:
+        return "ABP_ERR_UNSUP_OBJ"
+    _, first, end = objects[index]
+
+    if cmd not in attr_commands:
+        attr = 0
+    keys = [entry.key[1:] for entry in entries]
+    index = bisect.bisect_left(keys, (inst, cmd, attr), first, end)
+    instance_found = ((index < end and keys[index][0] == inst) or
+                      (index > first and keys[index - 1][0] == inst))
+
+    tried = []
+    while index < end and keys[index][:2] == (inst, cmd):
+        if cmd in attr_commands and keys[index][2] != attr:
+            break
+        tried.append(entries[index])
+        index += 1
+    if tried:
+        return tried
+    return "ABP_ERR_UNSUP_CMD" if instance_found else "ABP_ERR_UNSUP_INST"
+
+
+def check_lookup(entries, symbols):
+    """Compare the generated lookup with the linear scan.
+
+    Every entry is looked up, and so are the keys next to it, which find no
+    entry or an entry of a neighbouring instance or attribute.
+    """
+    attr_commands = set(symbols.value(name) for name in
+                        ("ABP_CMD_GET_ATTR", "ABP_CMD_SET_ATTR",
+                         "ABP_CMD_GET_ENUM_STR"))
+    table = sort_entries(entries)
+    objects = object_ranges(table)
+
+    messages = set()
+    for obj, inst, cmd, attr in (entry.key for entry in entries):
+        messages.update(((obj, inst, cmd, attr),
+                         (obj, inst, cmd, (attr + 1) & 0xFF),
+                         (obj, inst, cmd, (attr - 1) & 0xFF),
+                         (obj, inst, (cmd + 1) & 0x3F, attr),
+                         (obj, inst + 1, cmd, attr),
+                         (obj, max(inst - 1, 0), cmd, attr),
+                         ((obj + 1) & 0xFF, inst, cmd, attr)))
+
+    def describe(result):
+        if isinstance(result, str):
+            return result
+        return ", ".join(entry.source for entry in result)
+
+    for message in sorted(messages):
+        expected = linear_lookup(entries, message, attr_commands)
+        actual = binary_lookup(table, objects, message, attr_commands)
+        if expected != actual:
+            raise GeneratorError(
+                "object 0x%02X, instance %d, command 0x%02X, attribute %d: "
+                "generated table gives %s, linear scan gives %s"
+                % (message + (describe(actual), describe(expected))))
+
+
+def generate(description, entries, used, macros):
+    entries = sort_entries(entries)
+
+    out = []
+    out.append("/" + "*" * 79)
+    out.append("** Generated by abcc_api_command_table.py from %s."
+               % os.path.basename(description))
+    out.append("** Do not edit, edit the description and build again.")
+    out.append("*" * 80)
+    out.append("** File Description:")
+    out.append("** Command handler lookup table sorted by object, instance, "
+               "command and")
+    out.append("** attribute, the keys of its entries and the range of each "
+               "object in it.")
+    out.append("** See abcc_api_command_handler.c.")
+    out.append("*" * 80)
+    out.append("*/")
+    out.append("")
+    out.append("#ifndef ABCC_API_COMMAND_TABLE_H_")
+    out.append("#define ABCC_API_COMMAND_TABLE_H_")
+    out.append("")
+
+    checked = set()
+    for macro in used:
+        for condition in macro.conditions:
+            if condition in checked:
+                continue
+            checked.add(condition)
+            out.append("#if !( %s )" % condition)
+            out.append("#error \"%s requires %s\"" % (macro.name, condition))
+            out.append("#endif")
+    used_names = set(macro.name for macro in used)
+    for name in sorted(macros):
+        match = OBJ_ATTRIBUTES.match(name)
+        if match and name not in used_names:
+            out.append("#if %s_OBJ_ENABLE" % match.group(1))
+            out.append("#error \"%s is missing in %s\""
+                       % (name, os.path.basename(description)))
+            out.append("#endif")
+    out.append("")
+
+    out.append("static const Command_Handler_Lookup_Type "
+               "command_handler_lookup_table[] =")
+    out.append("{")
+    for index, entry in enumerate(entries):
+        separator = "," if index < len(entries) - 1 else ""
+        out.append("   /* %s */" % entry.source)
+        out.append("   %s%s" % (entry.text, separator))
+    out.append("};")
+    out.append("")
+
+    out.append("static const Command_Handler_Key_Type "
+               "command_handler_key_table[] =")
+    out.append("{")
+    for index, entry in enumerate(entries):
+        separator = "," if index < len(entries) - 1 else ""
+        out.append("   { %s, %s, %s, %s }%s" % (
+            entry.fields[".bObject"],
+            entry.fields[".bInstance"],
+            entry.fields[".bCommand"],
+            entry.fields.get(".uCmdExt.bAttr", "0"),
+            separator))
+    out.append("};")
+    out.append("")
+
+    out.append("static const Command_Handler_Object_Type "
+               "command_handler_object_table[] =")
+    out.append("{")
+    objects = object_ranges(entries)
+    for index, (_, first, end) in enumerate(objects):
+        separator = "," if index < len(objects) - 1 else ""
+        out.append("   { %s, %d, %d }%s" % (entries[first].fields[".bObject"],
+                                             first, end, separator))
+    out.append("};")
+    out.append("")
+    out.append("#endif")
+    out.append("")
+    return "\n".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("description",
+                        help="object description, one entry per line")
+    parser.add_argument("--lookup", required=True,
+                        help="path to abcc_api_command_handler_lookup.h")
+    parser.add_argument("--include-dir", action="append", default=[],
+                        help="directory with headers defining the constants")
+    parser.add_argument("--output", required=True,
+                        help="header to generate")
+    options = parser.parse_args()
+
+    try:
+        macros = parse_lookup_header(options.lookup)
+        symbols = SymbolTable()
+        for directory in [os.path.dirname(options.lookup)] + options.include_dir:
+            if os.path.isdir(directory):
+                symbols.load_dir(directory)
+        entries, used = parse_description(options.description, macros, symbols)
+        check_lookup(entries, symbols)
+        text = generate(options.description, entries, used, macros)
+    except (GeneratorError, OSError) as error:
+        sys.stderr.write("abcc_api_command_table.py: error: %s\n" % error)
+        return 1
+
+    # Only touch the output when it changes, so nothing is rebuilt needlessly.
+    try:
+        with open(options.output, encoding="utf-8") as file:
+            if file.read() == text:
+                return 0
+    except OSError:
+        pass
+    directory = os.path.dirname(options.output)
+    if directory:
+        os.makedirs(directory, exist_ok=True)
+    with open(options.output, "w", encoding="utf-8") as file:
+        file.write(text)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())